@@ -529,8 +529,15 @@ void drawBitmapFromSerialFlash_Buffered(const char *filename, int16_t x, int16_t
         do
         {
           if (!overwrite) display.fillScreen(GxEPD_WHITE);
-          uint32_t rowPosition = flip ? imageOffset + (height - h) * rowSize : imageOffset;
-          for (uint16_t row = 0; row < h; row++, rowPosition += rowSize) // for each line
+          // read only the rows that intersect the current page
+          int16_t px, py, pw, ph;
+          display.pageWindow(px, py, pw, ph);
+          int16_t row_ys = constrain(py - y, 0, int16_t(h)); // first line of the image in the page
+          int16_t row_ye = constrain(py + ph - y, row_ys, int16_t(h)); // end line of the image in the page
+          uint16_t row_first = flip ? h - row_ye : row_ys; // rows in file order
+          uint16_t row_end = flip ? h - row_ys : row_ye;
+          uint32_t rowPosition = (flip ? imageOffset + (height - h) * rowSize : imageOffset) + row_first * rowSize;
+          for (uint16_t row = row_first; row < row_end; row++, rowPosition += rowSize) // for each line
           {
             uint32_t in_remain = rowSize;
             uint32_t in_idx = 0;
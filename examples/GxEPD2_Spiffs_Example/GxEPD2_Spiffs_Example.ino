@@ -31,6 +31,8 @@
 #include <GxEPD2_BW.h>
 #include <GxEPD2_3C.h>
 #include <GxEPD2_7C.h>
+#include <GxEPD2_NativeImage.h>
+#include <GxEPD2_BmpDecoder.h>
 #include <Fonts/FreeMonoBold9pt7b.h>
 
 #if defined(ESP32)
@@ -53,6 +55,13 @@ void drawBitmapFromSpiffs(const char *filename, int16_t x, int16_t y, bool with_
 // overwrite = true does not clear buffer before drawing, use only if buffer is full height
 void drawBitmapFromSpiffs_Buffered(const char *filename, int16_t x, int16_t y, bool with_color = true, bool partial_update = false, bool overwrite = false);
 
+// native image drawing, streams pre-converted image files (.gn) to controller memory, without conversion
+// native image files are emitted by GxEPD2_Spiffs_Loader with emit_native = true
+void drawNativeFromSpiffs(const char *filename, int16_t x, int16_t y);
+
+// BMP drawing with the library decoder GxEPD2_BmpDecoder, to controller memory, as drawBitmapFromSpiffs()
+void drawBmpFromSpiffs(const char *filename, int16_t x, int16_t y, bool with_color = true);
+
 void setup()
 {
   Serial.begin(115200);
@@ -75,6 +84,8 @@ void setup()
     drawBitmaps_200x200();
     drawBitmaps_other();
     //drawBitmaps_test();
+    //drawNatives_200x200(); // needs native image files, see emit_native in GxEPD2_Spiffs_Loader
+    //drawBmpFromSpiffs("tiger_320x200x24.bmp", 0, 0); // decoded by GxEPD2_BmpDecoder
   }
 
   Serial.println("GxEPD2_Spiffs_Example done");
@@ -108,6 +119,18 @@ void drawBitmaps_200x200()
   delay(2000);
 }
 
+void drawNatives_200x200()
+{
+  int16_t x = (display.width() - 200) / 2;
+  int16_t y = (display.height() - 200) / 2;
+  drawNativeFromSpiffs("logo200x200.gn", x, y);
+  delay(2000);
+  drawNativeFromSpiffs("first200x200.gn", x, y);
+  delay(2000);
+  drawNativeFromSpiffs("second200x200.gn", x, y);
+  delay(2000);
+}
+
 void drawBitmaps_other()
 {
   int16_t w2 = display.width() / 2;
@@ -491,8 +514,15 @@ void drawBitmapFromSpiffs_Buffered(const char *filename, int16_t x, int16_t y, b
         do
         {
           if (!overwrite) display.fillScreen(GxEPD_WHITE);
-          uint32_t rowPosition = flip ? imageOffset + (height - h) * rowSize : imageOffset;
-          for (uint16_t row = 0; row < h; row++, rowPosition += rowSize) // for each line
+          // read only the rows that intersect the current page
+          int16_t px, py, pw, ph;
+          display.pageWindow(px, py, pw, ph);
+          int16_t row_ys = constrain(py - y, 0, int16_t(h)); // first line of the image in the page
+          int16_t row_ye = constrain(py + ph - y, row_ys, int16_t(h)); // end line of the image in the page
+          uint16_t row_first = flip ? h - row_ye : row_ys; // rows in file order
+          uint16_t row_end = flip ? h - row_ys : row_ye;
+          uint32_t rowPosition = (flip ? imageOffset + (height - h) * rowSize : imageOffset) + row_first * rowSize;
+          for (uint16_t row = row_first; row < row_end; row++, rowPosition += rowSize) // for each line
           {
             uint32_t in_remain = rowSize;
             uint32_t in_idx = 0;
@@ -593,6 +623,88 @@ void drawBitmapFromSpiffs_Buffered(const char *filename, int16_t x, int16_t y, b
   }
 }
 
+void drawNativeFromSpiffs(const char *filename, int16_t x, int16_t y)
+{
+  fs::File file;
+  uint32_t startTime = millis();
+  if ((x >= display.epd2.WIDTH) || (y >= display.epd2.HEIGHT)) return;
+  Serial.println();
+  Serial.print("Loading native image '");
+  Serial.print(filename);
+  Serial.println('\'');
+#if defined(ESP32)
+  file = SPIFFS.open(String("/") + filename, "r");
+#else
+  file = SPIFFS.open(filename, "r");
+#endif
+  if (!file)
+  {
+    Serial.print("File not found");
+    return;
+  }
+  GxEPD2_NativeImage image;
+  bool valid = image.begin(file) && (x + image.width() <= display.epd2.WIDTH) && (y + image.height() <= display.epd2.HEIGHT);
+  if (valid)
+  {
+    Serial.print("Image size: ");
+    Serial.print(image.width());
+    Serial.print('x');
+    Serial.print(image.height());
+    Serial.print(", planes: ");
+    Serial.println(image.planes());
+    display.writeScreenBuffer();
+    valid = image.write(display, file, x, y);
+    Serial.print("loaded in "); Serial.print(millis() - startTime); Serial.println(" ms");
+    if (valid) display.refresh();
+  }
+  file.close();
+  if (!valid)
+  {
+    Serial.println("native image format not handled.");
+  }
+}
+
+void drawBmpFromSpiffs(const char *filename, int16_t x, int16_t y, bool with_color)
+{
+  fs::File file;
+  uint32_t startTime = millis();
+  if ((x >= display.epd2.WIDTH) || (y >= display.epd2.HEIGHT)) return;
+  Serial.println();
+  Serial.print("Decoding image '");
+  Serial.print(filename);
+  Serial.println('\'');
+#if defined(ESP32)
+  file = SPIFFS.open(String("/") + filename, "r");
+#else
+  file = SPIFFS.open(filename, "r");
+#endif
+  if (!file)
+  {
+    Serial.print("File not found");
+    return;
+  }
+  GxEPD2_FileSource<fs::File> source(file);
+  GxEPD2_BmpDecoder bmp(source, with_color);
+  bool valid = bmp.begin();
+  if (valid)
+  {
+    Serial.print("Bit Depth: "); Serial.println(bmp.depth());
+    Serial.print("Image size: ");
+    Serial.print(bmp.width());
+    Serial.print('x');
+    Serial.println(bmp.height());
+    display.writeScreenBuffer();
+    valid = bmp.write(display, x, y);
+    Serial.print("loaded in "); Serial.print(millis() - startTime); Serial.println(" ms");
+    if (valid) display.refresh();
+  }
+  file.close();
+  if (!valid)
+  {
+    Serial.println("bitmap format not handled.");
+  }
+}
+
 uint16_t read16(fs::File& f)
 {
   // BMP data is stored little-endian, same as Arduino.
@@ -20,6 +20,14 @@ const bool formatOnFail = false;
 #endif
 
 #include <FS.h>
+#include <GxEPD2_BmpDecoder.h>
+#include <GxEPD2_NativeImage.h>
+
+// set emit_native = true to convert each downloaded BMP to a native image file (.gn), once, at load time
+// native images are streamed to controller memory without conversion, see drawNativeFromSpiffs() in GxEPD2_Spiffs_Example
+// emit_native_with_color adds the color plane, for 3-color panels
+const bool emit_native = false;
+const bool emit_native_with_color = true;
 
 #if defined (ESP8266)
 #include <ESP8266WiFi.h>
@@ -132,6 +140,7 @@ void loop()
 }
 
 void downloadFile_HTTPS(const char* host, const char* path, const char* filename, const char* fingerprint, const char* target, const char* certificate = certificate_rawcontent);
+void emitNative(const char* filename);
 
 void downloadBitmaps_200x200()
 {
@@ -265,6 +274,7 @@ void downloadFile_HTTP(const char* host, const char* path, const char* filename,
   }
   file.close();
   Serial.print("done, "); Serial.print(total); Serial.println(" bytes transferred");
+  if (emit_native) emitNative(target);
 }
 
 void downloadFile_HTTPS(const char* host, const char* path, const char* filename, const char* fingerprint, const char* target, const char* certificate)
@@ -363,4 +373,73 @@ void downloadFile_HTTPS(const char* host, const char* path, const char* filename
   }
   file.close();
   Serial.print("done, "); Serial.print(total); Serial.println(" bytes transferred");
+  if (emit_native) emitNative(target);
+}
+
+static const uint16_t max_row_width = 1448; // for up to 6" display 1448x1072
+
+uint8_t output_row_mono_buffer[max_row_width / 8]; // buffer for one row of b/w bits
+uint8_t output_row_color_buffer[max_row_width / 8]; // buffer for one row of color bits
+
+// converts BMP file filename to native image file with extension .gn, decoded by GxEPD2_BmpDecoder as drawBmpFromSpiffs()
+void emitNative(const char* filename)
+{
+  String target = String(filename);
+  if (target.lastIndexOf('.') > 0) target = target.substring(0, target.lastIndexOf('.'));
+  target += ".gn";
+  uint32_t startTime = millis();
+#if defined(ESP32)
+  fs::File file = SPIFFS.open(String("/") + filename, "r");
+#else
+  fs::File file = SPIFFS.open(filename, "r");
+#endif
+  if (!file)
+  {
+    Serial.print(filename); Serial.println(" not found");
+    return;
+  }
+  GxEPD2_FileSource<fs::File> source(file);
+  GxEPD2_BmpDecoder bmp(source, emit_native_with_color);
+  if (!bmp.begin() || (bmp.width() > max_row_width))
+  {
+    file.close();
+    Serial.print(filename); Serial.println(" format not handled for native image.");
+    return;
+  }
+  uint32_t first_row = file.position(); // begin() leaves the file at the first row
+#if defined(ESP32)
+  fs::File native = SPIFFS.open(String("/") + target, "w+");
+#else
+  fs::File native = SPIFFS.open(target, "w+");
+#endif
+  if (!native)
+  {
+    Serial.print(target); Serial.println(" open failed");
+    file.close();
+    return;
+  }
+  bool with_color = emit_native_with_color && (bmp.depth() > 1);
+  GxEPD2_NativeImage image(GxEPD2_NativeImage::IMAGE, with_color ? 2 : 1, 1, bmp.width(), bmp.height());
+  uint8_t header[GxEPD2_NativeImage::header_size];
+  image.header(header);
+  native.write(header, sizeof(header));
+  uint16_t wb = image.rowBytes();
+  bool valid = true;
+  for (int16_t row = 0; valid && (row < bmp.height()); row++) // for each line, top to bottom
+  {
+    file.seek(first_row + uint32_t(bmp.bottomUp() ? bmp.height() - 1 - row : row) * bmp.rowSize());
+    valid = bmp.readRow(output_row_mono_buffer, output_row_color_buffer) >= 0;
+    native.write(output_row_mono_buffer, wb);
+    if (with_color) native.write(output_row_color_buffer, wb);
+    delay(1); // yield();
+  }
+  native.close();
+  file.close();
+  if (!valid)
+  {
+    Serial.print(filename); Serial.println(" short read, native image incomplete.");
+    return;
+  }
+  Serial.print(target); Serial.print(" emitted, "); Serial.print(image.size()); Serial.print(" bytes in ");
+  Serial.print(millis() - startTime); Serial.println(" ms");
 }
@@ -31,6 +31,8 @@
 #include <GxEPD2_BW.h>
 #include <GxEPD2_3C.h>
 #include <GxEPD2_7C.h>
+#include <GxEPD2_BmpDecoder.h>
+#include <GxEPD2_HttpSource.h>
 
 // select the display class (only one), matching the kind of display panel
 #define GxEPD2_DISPLAY_CLASS GxEPD2_BW
@@ -205,6 +207,9 @@ void showBitmapFrom_HTTP_Buffered(const char* host, const char* path, const char
 void showBitmapFrom_HTTPS_Buffered(const char* host, const char* path, const char* filename, const char* fingerprint, int16_t x, int16_t y, bool with_color = true,
                                    const char* certificate = certificate_rawcontent);
 
+// streams the body by bulk reads through a ring buffer to GxEPD2_BmpDecoder, to controller memory, as showBitmapFrom_HTTP()
+void showBitmapFrom_HTTP_Streamed(const char* host, const char* path, const char* filename, int16_t x, int16_t y, bool with_color = true);
+
 void setup()
 {
   Serial.begin(115200);
@@ -272,6 +277,7 @@ void setup()
 
   //drawBitmaps_test();
   //drawBitmapsBuffered_test();
+  //showBitmapFrom_HTTP_Streamed("www.squix.org", "/blog/wunderground/", "chanceflurries.bmp", 0, 0); // any http host
 
   Serial.println("GxEPD2_WiFi_Example done");
 }
@@ -910,6 +916,73 @@ void drawBitmapFrom_HTTP_ToBuffer(const char* host, const char* path, const char
   }
 }
 
+uint8_t http_ring_buffer[4096]; // body bytes received ahead of the decoder; larger keeps the TCP window open longer
+
+bool showProgress(uint32_t received, uint32_t total, void* context)
+{
+  uint32_t& next = *(uint32_t*)context;
+  if (received >= next)
+  {
+    Serial.print("received "); Serial.print(received);
+    if (total > 0)
+    {
+      Serial.print(" of "); Serial.print(total);
+    }
+    Serial.println();
+    next = received + 16384;
+  }
+  return true; // return false to abort
+}
+
+void showBitmapFrom_HTTP_Streamed(const char* host, const char* path, const char* filename, int16_t x, int16_t y, bool with_color)
+{
+  WiFiClient client;
+  uint32_t startTime = millis();
+  if ((x >= display.epd2.WIDTH) || (y >= display.epd2.HEIGHT)) return;
+  Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
+  Serial.print("connecting to "); Serial.println(host);
+  if (!client.connect(host, httpPort))
+  {
+    Serial.println("connection failed");
+    return;
+  }
+  client.print(String("GET ") + path + filename + " HTTP/1.1\r\n" +
+               "Host: " + host + "\r\n" +
+               "User-Agent: GxEPD2_WiFi_Example\r\n" +
+               "Connection: close\r\n\r\n");
+  GxEPD2_HttpSource<WiFiClient> source(client, http_ring_buffer, sizeof(http_ring_buffer));
+  uint32_t next = 0;
+  source.onProgress(showProgress, &next);
+  bool valid = source.begin();
+  if (!valid)
+  {
+    Serial.print("HTTP status "); Serial.println(source.status());
+    client.stop();
+    return;
+  }
+  GxEPD2_BmpDecoder bmp(source, with_color);
+  valid = bmp.begin();
+  if (valid)
+  {
+    Serial.print("Bit Depth: "); Serial.println(bmp.depth());
+    Serial.print("Image size: ");
+    Serial.print(bmp.width());
+    Serial.print('x');
+    Serial.println(bmp.height());
+    display.writeScreenBuffer();
+    valid = bmp.write(display, x, y);
+    Serial.print("downloaded in "); Serial.print(millis() - startTime); Serial.println(" ms");
+    if (valid) display.refresh();
+  }
+  Serial.print("bytes read "); Serial.println(source.consumed());
+  if (source.timedOut()) Serial.println("timeout");
+  client.stop();
+  if (!valid)
+  {
+    Serial.println("bitmap format not handled.");
+  }
+}
+
 void showBitmapFrom_HTTP_Buffered(const char* host, const char* path, const char* filename, int16_t x, int16_t y, bool with_color)
 {
   Serial.println(); Serial.print("downloading file \""); Serial.print(filename);  Serial.println("\"");
@@ -0,0 +1,124 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: stand-in for the base class Adafruit_GFX of the display template classes, for the host programs.
+// Covers what the template classes and the host programs use; the primitives go through drawPixel() as in Adafruit_GFX.
+// Text is drawn in 6 x 8 cells of the size of the classic font, but the glyph shapes are a fixed pattern, not the font;
+// the pixel work per character is of the same order as with the classic font.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HostTests_Adafruit_GFX_H_
+#define _GxEPD2_HostTests_Adafruit_GFX_H_
+
+#include <Arduino.h>
+
+class Adafruit_GFX : public Print
+{
+  public:
+    Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h), rotation(0),
+      cursor_x(0), cursor_y(0), textcolor(0), textbgcolor(0), textsize(1), wrap(true) {};
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+    virtual void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      for (int16_t j = 0; j < h; j++) drawPixel(x, y + j, color);
+    };
+    virtual void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+    };
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+    };
+    virtual void fillScreen(uint16_t color)
+    {
+      fillRect(0, 0, _width, _height, color);
+    };
+    virtual void setRotation(uint8_t r)
+    {
+      rotation = r & 3;
+      _width = rotation & 1 ? HEIGHT : WIDTH;
+      _height = rotation & 1 ? WIDTH : HEIGHT;
+    };
+    uint8_t getRotation() const
+    {
+      return rotation;
+    };
+    int16_t width() const
+    {
+      return _width;
+    };
+    int16_t height() const
+    {
+      return _height;
+    };
+    void setCursor(int16_t x, int16_t y)
+    {
+      cursor_x = x;
+      cursor_y = y;
+    };
+    void setTextColor(uint16_t c)
+    {
+      textcolor = textbgcolor = c;
+    };
+    void setTextColor(uint16_t c, uint16_t bg)
+    {
+      textcolor = c;
+      textbgcolor = bg;
+    };
+    void setTextSize(uint8_t s)
+    {
+      textsize = s > 0 ? s : 1;
+    };
+    void setTextWrap(bool w)
+    {
+      wrap = w;
+    };
+    size_t write(uint8_t c)
+    {
+      if (c == '\n')
+      {
+        cursor_x = 0;
+        cursor_y += textsize * 8;
+      }
+      else if (c != '\r')
+      {
+        if (wrap && (cursor_x + textsize * 6 > _width))
+        {
+          cursor_x = 0;
+          cursor_y += textsize * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+        cursor_x += textsize * 6;
+      }
+      return 1;
+    };
+    void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size)
+    {
+      for (int8_t i = 0; i < 5; i++)
+      {
+        uint8_t line = uint8_t(c * 0x1D + i * 0x47) & 0x7F; // glyph column stand-in
+        for (int8_t j = 0; j < 8; j++, line >>= 1)
+        {
+          if (line & 1) fillRect(x + i * size, y + j * size, size, size, color);
+          else if (bg != color) fillRect(x + i * size, y + j * size, size, size, bg);
+        }
+      }
+      if (bg != color) fillRect(x + 5 * size, y, size, 8 * size, bg);
+    };
+  protected:
+    const int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    uint8_t rotation;
+    int16_t cursor_x, cursor_y;
+    uint16_t textcolor, textbgcolor;
+    uint8_t textsize;
+    bool wrap;
+};
+
+#endif
@@ -0,0 +1,16 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: the instances of the Arduino.h and SPI.h of this directory, for the host programs that use the drivers.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <Arduino.h>
+#include <SPI.h>
+
+HardwareSerial Serial;
+SPIClass SPI;
@@ -0,0 +1,211 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: minimal Arduino.h for the host tests of this directory, on Linux or macOS.
+// Provides only what the library classes under test use; not for the Arduino build.
+//
+// delay() sleeps by default; with -DGxEPD2_HOST_VIRTUAL_TIME=1 it advances millis() and micros() without sleeping,
+// for the host programs that run the drivers with busy -1 (panel busy times become waits of no cost).
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HostTests_Arduino_H_
+#define _GxEPD2_HostTests_Arduino_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifndef GxEPD2_HOST_VIRTUAL_TIME
+#define GxEPD2_HOST_VIRTUAL_TIME 0
+#endif
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define HEX 16
+#define DEC 10
+
+#define PROGMEM
+#define F(s) (s)
+#define memcpy_P memcpy
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_byte_near(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t*)(addr))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+inline uint8_t* _host_pin_levels()
+{
+  static uint8_t levels[256];
+  return levels;
+}
+
+inline void pinMode(int pin, int mode)
+{
+  if ((pin >= 0) && (pin < 256) && (mode == INPUT_PULLUP)) _host_pin_levels()[pin] = HIGH;
+}
+
+inline void digitalWrite(int pin, int level)
+{
+  if ((pin >= 0) && (pin < 256)) _host_pin_levels()[pin] = level ? HIGH : LOW;
+}
+
+inline int digitalRead(int pin)
+{
+  return (pin >= 0) && (pin < 256) ? _host_pin_levels()[pin] : LOW;
+}
+
+// microseconds added by delay() with GxEPD2_HOST_VIRTUAL_TIME
+inline unsigned long& _host_virtual_us()
+{
+  static unsigned long us = 0;
+  return us;
+}
+
+inline unsigned long micros()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec * 1000000UL + t.tv_nsec / 1000 + _host_virtual_us();
+}
+
+inline unsigned long millis()
+{
+  return micros() / 1000;
+}
+
+inline void delayMicroseconds(unsigned int us)
+{
+#if GxEPD2_HOST_VIRTUAL_TIME
+  _host_virtual_us() += us;
+#else
+  usleep(us);
+#endif
+}
+
+inline void delay(unsigned long ms)
+{
+#if GxEPD2_HOST_VIRTUAL_TIME
+  _host_virtual_us() += ms * 1000;
+#else
+  usleep(ms * 1000);
+#endif
+}
+
+inline void yield()
+{
+}
+
+class Print
+{
+  public:
+    virtual ~Print() {};
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size)
+    {
+      size_t n = 0;
+      while (size--) n += write(*buffer++);
+      return n;
+    }
+    size_t print(const char* s)
+    {
+      return write((const uint8_t*)s, strlen(s));
+    }
+    size_t print(char c)
+    {
+      return write(uint8_t(c));
+    }
+    size_t print(unsigned long v, int base = DEC)
+    {
+      char s[24];
+      snprintf(s, sizeof(s), base == HEX ? "%lX" : "%lu", v);
+      return print(s);
+    }
+    size_t print(long v, int base = DEC)
+    {
+      if (base == HEX) return print((unsigned long)v, base);
+      char s[24];
+      snprintf(s, sizeof(s), "%ld", v);
+      return print(s);
+    }
+    size_t print(unsigned int v, int base = DEC)
+    {
+      return print((unsigned long)v, base);
+    }
+    size_t print(int v, int base = DEC)
+    {
+      return print((long)v, base);
+    }
+    size_t print(double v, int digits = 2)
+    {
+      char s[40];
+      snprintf(s, sizeof(s), "%.*f", digits, v);
+      return print(s);
+    }
+    size_t println()
+    {
+      return print("\n"); // Arduino: "\r\n"
+    }
+    template <typename T> size_t println(T v)
+    {
+      return print(v) + println();
+    }
+    template <typename T> size_t println(T v, int base)
+    {
+      return print(v, base) + println();
+    }
+};
+
+class Stream : public Print
+{
+  public:
+    virtual int available()
+    {
+      return 0;
+    }
+    virtual int read()
+    {
+      return -1;
+    }
+    virtual size_t readBytes(uint8_t* buffer, size_t length)
+    {
+      size_t n = 0;
+      for (int c; (n < length) && ((c = read()) >= 0); n++) buffer[n] = c;
+      return n;
+    }
+    virtual size_t write(uint8_t c)
+    {
+      (void) c;
+      return 0;
+    }
+};
+
+// Serial writes to stdout
+class HardwareSerial : public Stream
+{
+  public:
+    void begin(unsigned long baud)
+    {
+      (void) baud;
+    }
+    size_t write(uint8_t c)
+    {
+      return fputc(c, stdout) == EOF ? 0 : 1;
+    }
+};
+
+extern HardwareSerial Serial; // defined in Arduino.cpp
+
+#endif
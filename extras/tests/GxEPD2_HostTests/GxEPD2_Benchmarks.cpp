@@ -0,0 +1,196 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Benchmarks of the rendering and transmission hot paths, per template class and panel, on the host.
+// Results are printed to stdout as CSV lines, to be diffed across library versions:
+// bench,<display>,<operation>,<count>,<total_us>,<ns_per_op>,<spi_bytes>,<spi_transactions>
+//
+// Each operation runs twice: a counted pass with GxEPD2_SpiStatistics attached gives spi_bytes and spi_transactions,
+// then a timed pass with no SPI monitor attached gives total_us and ns_per_op, so the per byte monitor is not timed.
+// The drivers run on the Arduino.h, SPI.h and Adafruit_GFX.h of this directory: no bus, BUSY is not used (-1),
+// and delay() costs no time (GxEPD2_HOST_VIRTUAL_TIME); the timings are those of the library code on the host CPU.
+// Text uses the stand-in glyphs of Adafruit_GFX.h of this directory, in cells of the classic font.
+//
+// build and run in this directory, on Linux or macOS; the optional argument is the repetition count, default 4:
+//   g++ -std=gnu++11 -O2 -Wall -DGxEPD2_HOST_VIRTUAL_TIME=1 -I. -I../../../src GxEPD2_Benchmarks.cpp Arduino.cpp
+//     ../../../src/GxEPD2_EPD.cpp ../../../src/epd/GxEPD2_213_B74.cpp ../../../src/epd/GxEPD2_750_T7.cpp
+//     ../../../src/epd3c/GxEPD2_420c.cpp ../../../src/epd3c/GxEPD2_565c.cpp -o GxEPD2_Benchmarks && ./GxEPD2_Benchmarks
+// (one command line)
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BW.h>
+#include <GxEPD2_3C.h>
+#include <GxEPD2_7C.h>
+#include <GxEPD2_SpiStatistics.h>
+
+#define EPD_CS 10
+#define EPD_DC 8
+#define EPD_RST 9
+#define EPD_BUSY -1
+
+uint16_t repeat = 4; // repetitions of screen sized operations
+
+// 64 x 64 test pattern for bitmap drawing
+const uint16_t bitmap_size = 64;
+uint8_t bitmap[bitmap_size / 8 * bitmap_size];
+
+template <typename T> static inline T gx_min(T a, T b)
+{
+  return (a < b ? a : b);
+}
+
+template <typename T> static inline T gx_max(T a, T b)
+{
+  return (a > b ? a : b);
+}
+
+// host clock, not micros(): delay() advances micros() with GxEPD2_HOST_VIRTUAL_TIME
+static uint64_t now_ns()
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return uint64_t(t.tv_sec) * 1000000000ULL + t.tv_nsec;
+}
+
+// counted pass, then timed pass; op must do the same work on each call
+template <typename Op> void measure(GxEPD2_EPD& epd, const char* display_name, const char* operation, uint32_t count, Op op)
+{
+  uint32_t bytes = 0, transactions = 0;
+#if ENABLE_GxEPD2_SPI_MONITOR
+  GxEPD2_SpiStatistics spi_statistics;
+  spi_statistics.attach(epd);
+  op();
+  spi_statistics.detach(epd);
+  bytes = spi_statistics.bytes();
+  transactions = spi_statistics.transactions;
+#else
+  (void) epd;
+#endif
+  uint64_t start_ns = now_ns();
+  op();
+  uint64_t elapsed_ns = now_ns() - start_ns;
+  printf("bench,%s,%s,%u,%llu,%llu,%u,%u\n", display_name, operation, count, (unsigned long long)(elapsed_ns / 1000),
+         (unsigned long long)(count ? elapsed_ns / count : 0), bytes, transactions);
+}
+
+template<typename Display> void benchmark(Display& display, const char* display_name)
+{
+  GxEPD2_EPD& epd = display.epd2;
+  display.init(0);
+  display.setRotation(0);
+  display.setFullWindow();
+  display.firstPage(); // benchmarks draw into the first page
+  const uint16_t w = display.width();
+  const uint16_t h = gx_min<uint16_t>(display.height(), display.pageHeight());
+
+  measure(epd, display_name, "drawPixel", uint32_t(repeat) * w * h, [&]()
+  {
+    for (uint16_t r = 0; r < repeat; r++)
+    {
+      for (uint16_t y = 0; y < h; y++)
+      {
+        for (uint16_t x = 0; x < w; x++) display.drawPixel(x, y, (x ^ y) & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+      }
+    }
+  });
+
+  measure(epd, display_name, "fillScreen", repeat, [&]()
+  {
+    for (uint16_t r = 0; r < repeat; r++) display.fillScreen(r & 1 ? GxEPD_BLACK : GxEPD_WHITE);
+  });
+
+  display.setTextColor(GxEPD_BLACK);
+  display.setTextWrap(false);
+  const char text[] = "Hello World 0123456789";
+  measure(epd, display_name, "print", uint32_t(repeat) * 4 * (sizeof(text) - 1), [&]()
+  {
+    for (uint16_t r = 0; r < repeat * 4; r++)
+    {
+      display.setCursor(0, (r * 16) % (h > 16 ? h - 8 : 1));
+      display.print(text);
+    }
+  });
+
+  // rows of bitmaps, the last one clipped if h is not a multiple of bitmap_size
+  const uint16_t bitmap_rows = (gx_max<uint16_t>(h, bitmap_size) + bitmap_size - 1) / bitmap_size;
+  uint16_t bitmaps = (w / bitmap_size) * bitmap_rows;
+  measure(epd, display_name, "drawBitmap", uint32_t(repeat) * bitmaps, [&]()
+  {
+    for (uint16_t r = 0; r < repeat; r++)
+    {
+      for (uint16_t x = 0; x + bitmap_size <= w; x += bitmap_size)
+      {
+        for (uint16_t j = 0; j < bitmap_rows; j++) display.drawBitmap(x, j * bitmap_size, bitmap, bitmap_size, bitmap_size, GxEPD_BLACK);
+      }
+    }
+  });
+
+  measure(epd, display_name, "drawInvertedBitmap", uint32_t(repeat) * bitmaps, [&]()
+  {
+    for (uint16_t r = 0; r < repeat; r++)
+    {
+      for (uint16_t x = 0; x + bitmap_size <= w; x += bitmap_size)
+      {
+        for (uint16_t j = 0; j < bitmap_rows; j++) display.drawInvertedBitmap(x, j * bitmap_size, bitmap, bitmap_size, bitmap_size, GxEPD_BLACK);
+      }
+    }
+  });
+
+  // writeImage of the whole controller memory, in bands of bitmap_size rows, native orientation
+  const uint16_t band = bitmap_size;
+  const uint16_t wb = (epd.WIDTH + 7) / 8; // bytes per row, as read by writeImage
+  uint8_t* image = (uint8_t*) malloc(uint32_t(wb) * band);
+  if (image)
+  {
+    for (uint32_t i = 0; i < uint32_t(wb) * band; i++) image[i] = uint8_t(i);
+    display.writeScreenBuffer(); // controller init outside of measurement
+    measure(epd, display_name, "writeImage", uint32_t(wb) * epd.HEIGHT, [&]()
+    {
+      for (uint16_t y = 0; y < epd.HEIGHT; y += band)
+      {
+        display.writeImage(image, 0, y, epd.WIDTH, gx_min<uint16_t>(band, epd.HEIGHT - y));
+      }
+    });
+    free(image);
+  }
+  display.hibernate();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc > 1) repeat = gx_max(atoi(argv[1]), 1);
+  printf("bench,display,operation,count,total_us,ns_per_op,spi_bytes,spi_transactions\n");
+  for (uint16_t i = 0; i < sizeof(bitmap); i++) bitmap[i] = (i / (bitmap_size / 8)) & 1 ? 0xAA : 0x55;
+  // one display at a time on the heap, as on the boards
+  {
+    GxEPD2_BW<GxEPD2_213_B74, GxEPD2_213_B74::HEIGHT>* display =
+      new GxEPD2_BW<GxEPD2_213_B74, GxEPD2_213_B74::HEIGHT>(GxEPD2_213_B74(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY, SPI));
+    benchmark(*display, "BW_213_B74");
+    delete display;
+  }
+  {
+    GxEPD2_BW < GxEPD2_750_T7, GxEPD2_750_T7::HEIGHT / 4 > * display =
+      new GxEPD2_BW < GxEPD2_750_T7, GxEPD2_750_T7::HEIGHT / 4 > (GxEPD2_750_T7(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
+    benchmark(*display, "BW_750_T7");
+    delete display;
+  }
+  {
+    GxEPD2_3C < GxEPD2_420c, GxEPD2_420c::HEIGHT / 2 > * display =
+      new GxEPD2_3C < GxEPD2_420c, GxEPD2_420c::HEIGHT / 2 > (GxEPD2_420c(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
+    benchmark(*display, "3C_420c");
+    delete display;
+  }
+  {
+    GxEPD2_7C < GxEPD2_565c, GxEPD2_565c::HEIGHT / 4 > * display =
+      new GxEPD2_7C < GxEPD2_565c, GxEPD2_565c::HEIGHT / 4 > (GxEPD2_565c(EPD_CS, EPD_DC, EPD_RST, EPD_BUSY));
+    benchmark(*display, "7C_565c");
+    delete display;
+  }
+  printf("bench,done\n");
+  return 0;
+}
@@ -0,0 +1,382 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host test of GxEPD2_BmpDecoder: decodes the bitmaps of extras/bitmaps and generated bitmaps of each depth and header variant
+// with readRow(), write() and draw(), and compares with a plain pixel by pixel reference decoder.
+//
+// build and run in this directory, on Linux or macOS:
+//   g++ -std=gnu++11 -Wall -I. -I../../../src GxEPD2_BmpDecoderTest.cpp -o GxEPD2_BmpDecoderTest && ./GxEPD2_BmpDecoderTest ../../bitmaps
+// add -DGxEPD2_SOURCE_BLOCK_SIZE=64 -DGxEPD2_BMP_INPUT_SIZE=48 for the buffer sizes of AVR
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BmpDecoder.h>
+#include <dirent.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+// pixels as '0' or '1' per plane, bit 1 is white as for writeImage, '?' if not written
+struct Canvas
+{
+  int W, H;
+  std::string black, color;
+  int calls;
+  Canvas(int w, int h) : W(w), H(h), black(w * h, '?'), color(w * h, '1'), calls(0) {}
+  void put(std::string& s, const uint8_t* data, int x, int y, int w, int h, bool invert, bool mirror_y)
+  {
+    int wb = (w + 7) / 8;
+    for (int i = 0; i < h; i++)
+    {
+      for (int j = 0; j < w; j++)
+      {
+        int row = mirror_y ? h - 1 - i : i;
+        int v = ((data[row * wb + j / 8] >> (7 - j % 8)) & 1) ^ invert;
+        if ((y + i < H) && (x + j < W)) s[(y + i) * W + x + j] = '0' + v;
+      }
+    }
+  }
+  void writeImage(const uint8_t* b, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool)
+  {
+    calls++;
+    put(black, b, x, y, w, h, invert, mirror_y);
+  }
+  void writeImage(const uint8_t* b, const uint8_t* c, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool)
+  {
+    calls++;
+    put(black, b, x, y, w, h, invert, mirror_y);
+    put(color, c, x, y, w, h, invert, mirror_y);
+  }
+  void writeNative(const uint8_t*, const uint8_t*, int16_t, int16_t, int16_t, int16_t, bool, bool, bool) {}
+  int16_t height()
+  {
+    return H;
+  }
+  void drawPixel(int16_t x, int16_t y, uint16_t c)
+  {
+    if ((x >= W) || (y >= H)) return;
+    black[y * W + x] = c == GxEPD_BLACK ? '0' : '1';
+    color[y * W + x] = c == GxEPD_RED ? '0' : '1';
+  }
+};
+
+static uint32_t get(const Bytes& d, uint32_t pos, uint8_t n)
+{
+  uint32_t v = 0;
+  while (n-- > 0) v = (v << 8) | d[pos + n];
+  return v;
+}
+
+// reference: classification of the BMP examples, 0 white, 1 black, 2 colored
+static int classify(bool color, int r, int g, int b)
+{
+  bool whitish = color ? (r > 0x80) && (g > 0x80) && (b > 0x80) : r + g + b > 3 * 0x80;
+  if (whitish) return 0;
+  if (color && ((r > 0xF0) || ((g > 0xF0) && (b > 0xF0)))) return 2;
+  return 1;
+}
+
+// reference decoder, pixel by pixel from the whole file; false if not supported
+static bool decode(const Bytes& d, bool with_color, int& w, int& h, std::string& black, std::string& color)
+{
+  if ((d.size() < 26) || (d[0] != 'B') || (d[1] != 'M')) return false;
+  uint32_t offset = get(d, 10, 4), header_size = get(d, 14, 4);
+  bool core = header_size == 12;
+  int depth, compression = 0;
+  uint32_t colors = 0;
+  if (core)
+  {
+    w = int16_t(get(d, 18, 2));
+    h = int16_t(get(d, 20, 2));
+    depth = get(d, 24, 2);
+  }
+  else
+  {
+    w = int32_t(get(d, 18, 4));
+    h = int32_t(get(d, 22, 4));
+    depth = get(d, 28, 2);
+    compression = get(d, 30, 4);
+    colors = get(d, 46, 4);
+  }
+  bool top_down = h < 0;
+  if (top_down) h = -h;
+  if ((compression != 0) && (compression != 3)) return false;
+  bool rgb565 = false;
+  if (compression == 3)
+  {
+    uint32_t red = get(d, 54, 4), green = get(d, 58, 4), blue = get(d, 62, 4);
+    rgb565 = (depth == 16) && (red == 0xF800) && (green == 0x07E0) && (blue == 0x001F);
+    bool rgb555 = (depth == 16) && (red == 0x7C00) && (green == 0x03E0) && (blue == 0x001F);
+    bool bgra = (depth == 32) && (red == 0x00FF0000) && (green == 0x0000FF00) && (blue == 0x000000FF);
+    if (!rgb565 && !rgb555 && !bgra) return false;
+  }
+  bool with = with_color && (depth > 1);
+  uint32_t entries = depth > 8 ? 0 : (colors > 0) && (colors < (1u << depth)) ? colors : 1u << depth;
+  uint32_t palette = 14 + header_size, entry = core ? 3 : 4;
+  uint32_t row_size = ((uint32_t(w) * depth + 31) / 32) * 4;
+  black.assign(w * h, '1');
+  color.assign(w * h, '1');
+  for (int y = 0; y < h; y++)
+  {
+    uint32_t row = offset + (top_down ? y : h - 1 - y) * row_size;
+    for (int x = 0; x < w; x++)
+    {
+      int c = 0;
+      if (depth <= 8)
+      {
+        uint32_t bit = x * depth;
+        uint32_t i = (d[row + bit / 8] >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+        uint32_t p = palette + i * entry;
+        if (i < entries) c = classify(with, d[p + 2], d[p + 1], d[p]); // indexes beyond the palette are white
+      }
+      else if (depth == 16)
+      {
+        uint8_t lsb = d[row + 2 * x], msb = d[row + 2 * x + 1];
+        if (rgb565) c = classify(with, msb & 0xF8, ((msb & 0x07) << 5) | ((lsb & 0xE0) >> 3), (lsb & 0x1F) << 3);
+        else c = classify(with, (msb & 0x7C) << 1, ((msb & 0x03) << 6) | ((lsb & 0xE0) >> 2), (lsb & 0x1F) << 3);
+      }
+      else
+      {
+        uint32_t p = row + x * (depth / 8);
+        c = classify(with, d[p + 2], d[p + 1], d[p]);
+      }
+      if (c == 1) black[y * w + x] = '0';
+      if (c == 2) color[y * w + x] = '0';
+    }
+  }
+  return true;
+}
+
+static void put(Bytes& d, uint32_t v, uint8_t n)
+{
+  for (uint8_t i = 0; i < n; i++) d.push_back(v >> (8 * i));
+}
+
+// generated bitmap of each depth and header variant, pixels and palette from a simple pattern
+// masks: 0 none, 565 or 555 for 16 bits per pixel, 888 for 32; entries 0 for the full palette
+static Bytes generate(int w, int h, int depth, bool top_down, bool core, int masks = 0, uint32_t entries = 0)
+{
+  Bytes d;
+  uint32_t header_size = core ? 12 : 40;
+  uint32_t palette = depth > 8 ? 0 : entries ? entries : 1u << depth;
+  uint32_t entry = core ? 3 : 4;
+  uint32_t row_size = ((uint32_t(w) * depth + 31) / 32) * 4;
+  uint32_t offset = 14 + header_size + (masks ? 12 : 0) + palette * entry;
+  d.push_back('B');
+  d.push_back('M');
+  put(d, offset + row_size * h, 4);
+  put(d, 0, 4);
+  put(d, offset, 4);
+  put(d, header_size, 4);
+  if (core)
+  {
+    put(d, w, 2);
+    put(d, h, 2);
+    put(d, 1, 2);
+    put(d, depth, 2);
+  }
+  else
+  {
+    put(d, w, 4);
+    put(d, top_down ? -h : h, 4);
+    put(d, 1, 2);
+    put(d, depth, 2);
+    put(d, masks ? 3 : 0, 4);
+    put(d, row_size * h, 4);
+    put(d, 2835, 4);
+    put(d, 2835, 4);
+    put(d, entries, 4);
+    put(d, 0, 4);
+  }
+  if (masks == 565)
+  {
+    put(d, 0xF800, 4);
+    put(d, 0x07E0, 4);
+    put(d, 0x001F, 4);
+  }
+  else if (masks == 555)
+  {
+    put(d, 0x7C00, 4);
+    put(d, 0x03E0, 4);
+    put(d, 0x001F, 4);
+  }
+  else if (masks == 888)
+  {
+    put(d, 0x00FF0000, 4);
+    put(d, 0x0000FF00, 4);
+    put(d, 0x000000FF, 4);
+  }
+  // white, black, red, yellow, greys and mixed colors
+  static const uint8_t rgb[][3] = {{255, 255, 255}, {0, 0, 0}, {255, 0, 0}, {255, 255, 0}, {128, 128, 128}, {200, 200, 200},
+    {0, 255, 255}, {250, 250, 100}, {100, 200, 255}, {129, 129, 129}, {241, 30, 30}, {20, 241, 241}
+  };
+  const uint32_t n = sizeof(rgb) / sizeof(rgb[0]);
+  for (uint32_t i = 0; i < palette; i++)
+  {
+    const uint8_t* c = rgb[(i * 5) % n];
+    d.push_back(c[2]);
+    d.push_back(c[1]);
+    d.push_back(c[0]);
+    if (!core) d.push_back(i);
+  }
+  for (int y = 0; y < h; y++)
+  {
+    Bytes row(row_size, 0);
+    for (int x = 0; x < w; x++)
+    {
+      uint32_t v = (x * 7 + y * 3 + x * y) & 0xFFFFFF;
+      uint32_t bit = x * depth;
+      if (depth <= 8) row[bit / 8] |= (v % (1u << depth)) << (8 - depth - bit % 8);
+      else if (depth == 16)
+      {
+        uint16_t p = ((v % 5) == 0) ? 0xFFFF : ((v % 5) == 1) ? (masks == 565 ? 0xF800 : 0x7C00) : uint16_t(v * 2654435761u >> 8);
+        row[bit / 8] = p;
+        row[bit / 8 + 1] = p >> 8;
+      }
+      else
+      {
+        const uint8_t* c = rgb[v % n];
+        for (int k = 0; k < depth / 8; k++) row[bit / 8 + k] = k < 3 ? c[2 - k] ^ uint8_t(v >> 4) : 0xFF;
+      }
+    }
+    d.insert(d.end(), row.begin(), row.end());
+  }
+  return d;
+}
+
+static int checks = 0, fails = 0;
+
+static void check(const char* name, const Bytes& data, bool with_color)
+{
+  int w = 0, h = 0;
+  std::string black, color;
+  bool supported = decode(data, with_color, w, h, black, color);
+  checks++;
+  {
+    GxEPD2_MemorySource source(&data[0], data.size());
+    GxEPD2_BmpDecoder decoder(source, with_color);
+    if (!supported)
+    {
+      if (decoder.begin())
+      {
+        printf("FAIL %s: accepted unsupported bitmap\n", name);
+        fails++;
+      }
+      return;
+    }
+    if (!decoder.begin() || (decoder.width() != w) || (decoder.height() != h))
+    {
+      printf("FAIL %s: begin\n", name);
+      fails++;
+      return;
+    }
+    std::string b(w * h, '?'), c(w * h, '?');
+    Bytes row((w + 7) / 8), crow((w + 7) / 8);
+    int y, rows = 0;
+    while ((y = decoder.readRow(&row[0], &crow[0])) >= 0)
+    {
+      rows++;
+      for (int x = 0; x < w; x++)
+      {
+        b[y * w + x] = '0' + ((row[x / 8] >> (7 - x % 8)) & 1);
+        c[y * w + x] = '0' + ((crow[x / 8] >> (7 - x % 8)) & 1);
+      }
+    }
+    if ((rows != h) || (b != black) || (c != color))
+    {
+      printf("FAIL %s color %d: readRow\n", name, with_color);
+      fails++;
+    }
+  }
+  {
+    GxEPD2_MemorySource source(&data[0], data.size());
+    GxEPD2_BmpDecoder decoder(source, with_color);
+    decoder.begin();
+    Canvas canvas(w + 8, h + 3);
+    bool ok = decoder.write(canvas, 8, 3);
+    std::string b, c;
+    for (int y = 0; y < h; y++)
+    {
+      b += canvas.black.substr((y + 3) * canvas.W + 8, w);
+      c += canvas.color.substr((y + 3) * canvas.W + 8, w);
+    }
+    // a decoded row needs to fit GxEPD2_SOURCE_BLOCK_SIZE bytes
+    bool fits = ((w + 7) / 8 <= GxEPD2_SOURCE_BLOCK_SIZE) || ((decoder.depth() == 1) && (w % 8 == 0));
+    if ((ok != fits) || (ok && ((b != black) || (c != color))))
+    {
+      printf("FAIL %s color %d: write\n", name, with_color);
+      fails++;
+    }
+  }
+  {
+    GxEPD2_MemorySource source(&data[0], data.size());
+    GxEPD2_BmpDecoder decoder(source, with_color);
+    decoder.begin();
+    Canvas canvas(w, h);
+    if (!decoder.draw(canvas, 0, 0) || (canvas.black != black) || (canvas.color != color))
+    {
+      printf("FAIL %s color %d: draw\n", name, with_color);
+      fails++;
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  const char* dir = argc > 1 ? argv[1] : "../../bitmaps";
+  std::vector<std::string> names;
+  DIR* d = opendir(dir);
+  if (!d)
+  {
+    printf("no directory %s\n", dir);
+    return 1;
+  }
+  for (struct dirent* e; (e = readdir(d));)
+  {
+    if (strstr(e->d_name, ".bmp")) names.push_back(e->d_name);
+  }
+  closedir(d);
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    std::string path = std::string(dir) + "/" + names[i];
+    FILE* f = fopen(path.c_str(), "rb");
+    Bytes data;
+    for (int c; f && ((c = fgetc(f)) >= 0);) data.push_back(c);
+    if (f) fclose(f);
+    check(names[i].c_str(), data, false);
+    check(names[i].c_str(), data, true);
+  }
+  struct
+  {
+    const char* name;
+    Bytes data;
+  } generated[] =
+  {
+    {"1 bit, odd width", generate(61, 17, 1, false, false)},
+    {"1 bit, top down", generate(64, 9, 1, true, false)},
+    {"2 bits", generate(37, 11, 2, false, false)},
+    {"4 bits, OS/2 header", generate(45, 13, 4, false, true)},
+    {"4 bits, short palette", generate(45, 13, 4, false, false, 0, 5)},
+    {"8 bits, top down", generate(33, 21, 8, true, false)},
+    {"8 bits, wide", generate(8 * GxEPD2_SOURCE_BLOCK_SIZE + 8, 3, 8, false, false)},
+    {"16 bits, 555", generate(29, 15, 16, false, false)},
+    {"16 bits, 555 masks", generate(29, 15, 16, true, false, 555)},
+    {"16 bits, 565 masks", generate(30, 15, 16, false, false, 565)},
+    {"24 bits", generate(31, 19, 24, false, false)},
+    {"32 bits", generate(27, 12, 32, true, false)},
+    {"32 bits, masks", generate(27, 12, 32, false, false, 888)},
+    {"16 bits, unsupported masks", generate(29, 15, 16, false, false, 888)},
+  };
+  for (size_t i = 0; i < sizeof(generated) / sizeof(generated[0]); i++)
+  {
+    check(generated[i].name, generated[i].data, false);
+    check(generated[i].name, generated[i].data, true);
+  }
+  printf("%u bitmap files, %d checks, %s\n", unsigned(names.size()), checks, fails ? "FAILED" : "ok");
+  return fails ? 1 : 0;
+}
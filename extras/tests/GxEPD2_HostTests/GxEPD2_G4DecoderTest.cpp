@@ -0,0 +1,254 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host test of GxEPD2_G4Decoder: decodes T.6 fixtures with readRow(), write() and draw(), with header and raw,
+// and compares with the expected rows; checks rejection of images wider than GxEPD2_G4_MAX_WIDTH,
+// and errors on truncated and corrupt data.
+// The fixtures are single strips of TIFF files with compression 4 written by libtiff, not by GxEPD2_PackBitmap;
+// the expected rows are the patterns the TIFF files were made of, see pattern().
+//
+// build and run in this directory, on Linux or macOS:
+//   g++ -std=gnu++11 -Wall -I. -I../../../src GxEPD2_G4DecoderTest.cpp -o GxEPD2_G4DecoderTest && ./GxEPD2_G4DecoderTest
+// add -DGxEPD2_SOURCE_BLOCK_SIZE=64 -DGxEPD2_G4_INPUT_SIZE=16 for the buffer sizes of AVR,
+// or -DGxEPD2_G4_MAX_WIDTH=2048 to decode the fixture that is too wide by default
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_G4Decoder.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+// T.6 coded, 0 is white, as TIFF compression 4 with fill order 1; each ends with end of facsimile block
+static const uint8_t blank_16x4[] = {0xF0, 0x01, 0x00, 0x10};
+static const uint8_t box_16x6[] = {0x97, 0x0B, 0x9F, 0xFF, 0xC7, 0x18, 0x00, 0x80, 0x08};
+static const uint8_t diag_27x9[] =
+{
+  0x26, 0xA8, 0xF2, 0x30, 0x8B, 0xA3, 0xDD, 0x95, 0x69, 0xA4, 0x11, 0x75, 0x65, 0x3A, 0xD2, 0x61,
+  0x2B, 0x11, 0xB5, 0x9F, 0x0A, 0xB2, 0x87, 0x09, 0x25, 0x41, 0x17, 0x49, 0x34, 0x93, 0x49, 0x82,
+  0x49, 0x22, 0x3A, 0x4A, 0x93, 0x49, 0x32, 0x9D, 0x45, 0x22, 0x3A, 0x49, 0xA8, 0x00, 0x80, 0x08
+};
+static const uint8_t runs_320x4[] =
+{
+  0x20, 0x61, 0x92, 0x2C, 0x9A, 0x81, 0xE1, 0xA8, 0x57, 0x98, 0x68, 0x94, 0xE5, 0x39, 0x4E, 0x53,
+  0x94, 0xE5, 0x39, 0x4E, 0x53, 0x94, 0xE5, 0x39, 0x0C, 0x91, 0x47, 0x29, 0xCA, 0x72, 0x9C, 0xA7,
+  0x29, 0xCA, 0x72, 0x9C, 0xA7, 0x29, 0xCA, 0x72, 0x9C, 0xA7, 0x29, 0xCA, 0x72, 0x9C, 0xA7, 0x29,
+  0xCA, 0x72, 0x9C, 0xA7, 0x29, 0xCA, 0x72, 0x9C, 0xA7, 0x29, 0xCA, 0x72, 0x9C, 0xA7, 0x29, 0xD6,
+  0x22, 0x22, 0x22, 0x22, 0x22, 0x40, 0xF2, 0x5E, 0x62, 0x22, 0x22, 0x2C, 0x00, 0x40, 0x04
+};
+static const uint8_t wide_1872x3[] = {0x52, 0x52, 0x02, 0x00, 0x8C, 0x80, 0x89, 0x81, 0xE2, 0x80, 0x08, 0x00, 0x80};
+static const uint8_t wide_1880x3[] = {0x20, 0x33, 0x55, 0x25, 0x20, 0x20, 0x08, 0xE4, 0x04, 0x4C, 0x0F, 0x05, 0xC0, 0x04, 0x00, 0x40};
+
+// expected: true if pixel x, y of the fixture is black
+static bool pattern(const char* name, int x, int y)
+{
+  std::string n(name);
+  if (n == "blank") return false; // V0 only
+  if (n == "box") return (2 <= x) && (x < 13) && (1 <= y) && (y < 5) && !((4 <= x) && (x < 11) && (2 <= y) && (y < 4)); // vertical modes
+  if (n == "diag") return ((x + y) % 7 == 0) || ((x - y + 99) % 11 == 0) || ((y == 3) && (5 <= x) && (x < 20)); // pass and horizontal
+  if (n == "runs") // makeup codes
+    return ((y % 2 == 0) && (30 <= x) && (x < 230)) || ((y % 2 == 1) && ((x < 100) || (x >= 300))) || ((y == 2) && (x % 3 == 0));
+  if (n == "wide") return ((y == 1) && (40 <= x) && (x < 1850)) || ((y == 2) && (x >= 1800)) || (x == 1871); // extended makeup codes
+  return false;
+}
+
+// rows of (w + 7) / 8 bytes, bit 1 white, padding bits white as decoded
+static Bytes expected(const char* name, int w, int h)
+{
+  int wb = (w + 7) / 8;
+  Bytes rows(wb * h, 0xFF);
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      if (pattern(name, x, y)) rows[y * wb + x / 8] &= ~(0x80 >> (x % 8));
+    }
+  }
+  return rows;
+}
+
+static Bytes withHeader(const uint8_t* data, size_t size, uint16_t w, uint16_t h)
+{
+  const uint8_t header[] = {'G', '4', 0, 0, uint8_t(w), uint8_t(w >> 8), uint8_t(h), uint8_t(h >> 8)};
+  Bytes file(header, header + sizeof(header));
+  file.insert(file.end(), data, data + size);
+  return file;
+}
+
+// pixels as '0' or '1', bit 1 is white as for writeImage, '?' if not written
+struct Canvas
+{
+  int W, H;
+  std::string pixels;
+  Canvas(int w, int h) : W(w), H(h), pixels(w * h, '?') {}
+  void writeImage(const uint8_t* b, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool, bool)
+  {
+    int wb = (w + 7) / 8;
+    for (int i = 0; i < h; i++)
+    {
+      for (int j = 0; j < w; j++)
+      {
+        int v = ((b[i * wb + j / 8] >> (7 - j % 8)) & 1) ^ invert;
+        if ((y + i < H) && (x + j < W)) pixels[(y + i) * W + x + j] = '0' + v;
+      }
+    }
+  }
+  int16_t height()
+  {
+    return H;
+  }
+  // as Adafruit_GFX, set bits in color, others in bg
+  void drawBitmap(int16_t x, int16_t y, const uint8_t* b, int16_t w, int16_t h, uint16_t color, uint16_t bg)
+  {
+    int wb = (w + 7) / 8;
+    for (int i = 0; i < h; i++)
+    {
+      for (int j = 0; j < w; j++)
+      {
+        uint16_t c = (b[i * wb + j / 8] >> (7 - j % 8)) & 1 ? color : bg;
+        if ((y + i < H) && (x + j < W)) pixels[(y + i) * W + x + j] = c == GxEPD_BLACK ? '0' : '1';
+      }
+    }
+  }
+  std::string area(int x, int y, int w, int h) const
+  {
+    std::string s;
+    for (int i = 0; i < h; i++) s += pixels.substr((y + i) * W + x, w);
+    return s;
+  }
+};
+
+static std::string text(const Bytes& rows, int w, int h)
+{
+  int wb = (w + 7) / 8;
+  std::string s;
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++) s += '0' + ((rows[y * wb + x / 8] >> (7 - x % 8)) & 1);
+  }
+  return s;
+}
+
+static int checks = 0, fails = 0;
+
+static void fail(const char* name, const char* what)
+{
+  printf("FAIL %s: %s\n", name, what);
+  fails++;
+}
+
+static void check(const char* name, const uint8_t* data, size_t size, uint16_t w, uint16_t h)
+{
+  Bytes file = withHeader(data, size, w, h);
+  Bytes want = expected(name, w, h);
+  bool fits = w <= GxEPD2_G4_MAX_WIDTH;
+  checks++;
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_G4Decoder decoder(source);
+    if (decoder.begin() != fits) return fail(name, fits ? "begin" : "accepted width over GxEPD2_G4_MAX_WIDTH");
+    if (!fits)
+    {
+      Bytes row((w + 7) / 8);
+      if (decoder.valid() || (decoder.readRow(&row[0]) >= 0)) fail(name, "decoded width over GxEPD2_G4_MAX_WIDTH");
+      Canvas canvas(w, h);
+      if (decoder.write(canvas, 0, 0) || decoder.draw(canvas, 0, 0)) fail(name, "wrote width over GxEPD2_G4_MAX_WIDTH");
+      GxEPD2_MemorySource raw_source(data, size);
+      GxEPD2_G4Decoder raw(raw_source);
+      if (raw.begin(w, h)) fail(name, "raw: accepted width over GxEPD2_G4_MAX_WIDTH");
+      return;
+    }
+    if ((decoder.width() != w) || (decoder.height() != h) || (decoder.rowBytes() != (w + 7) / 8)) return fail(name, "size");
+    Bytes rows(want.size(), 0);
+    int n = 0;
+    while ((n < h) && (decoder.readRow(&rows[n * decoder.rowBytes()]) == n)) n++;
+    if ((n != h) || (rows != want)) fail(name, "readRow");
+    Bytes more(decoder.rowBytes());
+    if ((decoder.readRow(&more[0]) >= 0) || decoder.error()) fail(name, "end");
+  }
+  {
+    GxEPD2_MemorySource source(data, size);
+    GxEPD2_G4Decoder decoder(source);
+    Bytes rows(want.size(), 0);
+    int n = 0;
+    if (decoder.begin(w, h))
+    {
+      while ((n < h) && (decoder.readRow(&rows[n * decoder.rowBytes()]) == n)) n++;
+    }
+    if ((n != h) || (rows != want)) fail(name, "raw, without header");
+  }
+  for (int invert = 0; invert < 2; invert++)
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_G4Decoder decoder(source);
+    decoder.begin();
+    Canvas canvas(w + 16, h + 3);
+    std::string s = text(want, w, h);
+    if (invert) for (size_t i = 0; i < s.size(); i++) s[i] ^= 1;
+    if (!decoder.write(canvas, 16, 3, invert) || (canvas.area(16, 3, w, h) != s)) fail(name, invert ? "write, invert" : "write");
+  }
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_G4Decoder decoder(source);
+    decoder.begin();
+    Canvas canvas(w + 3, h - 1); // last row not drawn
+    if (!decoder.draw(canvas, 3, 0) || (canvas.area(3, 0, w, h - 1) != text(want, w, h - 1))) fail(name, "draw");
+  }
+  // truncated inside the coded rows, and corrupt: no row after the error
+  for (int variant = 0; variant < 2; variant++)
+  {
+    Bytes bad = file;
+    size_t cut = GxEPD2_G4Decoder::header_size + size / 2;
+    if (variant == 0) bad.resize(cut);
+    else memset(&bad[cut], 0, bad.size() - cut); // zeros are no code
+    GxEPD2_MemorySource source(&bad[0], bad.size());
+    GxEPD2_G4Decoder decoder(source);
+    decoder.begin();
+    Bytes row(decoder.rowBytes());
+    int n = 0;
+    while ((n <= h) && (decoder.readRow(&row[0]) >= 0)) n++;
+    bool stopped = (n < h) && decoder.error() && !decoder.valid() && (decoder.readRow(&row[0]) < 0);
+    // blank has all its rows in its first byte
+    if ((size > sizeof(blank_16x4)) && !stopped) fail(name, variant ? "corrupt data not detected" : "truncated data not detected");
+  }
+}
+
+int main()
+{
+  struct
+  {
+    const char* name;
+    const uint8_t* data;
+    size_t size;
+    uint16_t w, h;
+  } fixtures[] =
+  {
+    {"blank", blank_16x4, sizeof(blank_16x4), 16, 4},
+    {"box", box_16x6, sizeof(box_16x6), 16, 6},
+    {"diag", diag_27x9, sizeof(diag_27x9), 27, 9},
+    {"runs", runs_320x4, sizeof(runs_320x4), 320, 4},
+    {"wide", wide_1872x3, sizeof(wide_1872x3), 1872, 3},
+    {"wide", wide_1880x3, sizeof(wide_1880x3), 1880, 3}, // over the default GxEPD2_G4_MAX_WIDTH
+  };
+  for (size_t i = 0; i < sizeof(fixtures) / sizeof(fixtures[0]); i++)
+  {
+    check(fixtures[i].name, fixtures[i].data, fixtures[i].size, fixtures[i].w, fixtures[i].h);
+  }
+  {
+    checks++;
+    const uint8_t not_g4[] = {'G', 'P', 0, 0, 16, 0, 4, 0, 0xF0};
+    GxEPD2_MemorySource source(not_g4, sizeof(not_g4));
+    GxEPD2_G4Decoder decoder(source);
+    if (decoder.begin()) fail("header", "accepted other format");
+    GxEPD2_MemorySource short_source(not_g4, 5);
+    GxEPD2_G4Decoder short_decoder(short_source);
+    if (short_decoder.begin()) fail("header", "accepted short header");
+  }
+  printf("%d checks, %s\n", checks, fails ? "FAILED" : "ok");
+  return fails ? 1 : 0;
+}
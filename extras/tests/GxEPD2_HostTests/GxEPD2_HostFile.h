@@ -0,0 +1,62 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: a host file as Arduino Stream, in place of a File of SD or LittleFS, e.g. for GxEPD2_SpiTrace and its reader.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HostFile_H_
+#define _GxEPD2_HostFile_H_
+
+#include <Arduino.h>
+
+class GxEPD2_HostFile : public Stream
+{
+  public:
+    // mode as for fopen(), "rb" or "wb"
+    GxEPD2_HostFile(const char* path, const char* mode) : _file(fopen(path, mode)), _write_error(false) {};
+    ~GxEPD2_HostFile()
+    {
+      close();
+    };
+    operator bool() const
+    {
+      return _file != 0;
+    };
+    // false if the file could not be opened or a write failed
+    bool close()
+    {
+      bool ok = _file && !_write_error;
+      if (_file) ok = (0 == fclose(_file)) && ok;
+      _file = 0;
+      return ok;
+    };
+    using Print::write;
+    size_t write(uint8_t b)
+    {
+      if (_file && (fputc(b, _file) != EOF)) return 1;
+      _write_error = true;
+      return 0;
+    };
+    int available()
+    {
+      if (!_file) return 0;
+      int c = fgetc(_file);
+      if (c == EOF) return 0;
+      ungetc(c, _file);
+      return 1;
+    };
+    int read()
+    {
+      return _file ? fgetc(_file) : -1;
+    };
+  private:
+    FILE* _file;
+    bool _write_error;
+};
+
+#endif
@@ -0,0 +1,303 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host test of GxEPD2_HttpSource with GxEPD2_PosixClient, against a stand-in HTTP server on a local port in the same process.
+// The server sends the bitmaps of extras/bitmaps with Content-Length, chunked (random chunk sizes, extensions, trailer),
+// until close, in small pieces with pauses, or stalls after half of the body. Checks decoding by GxEPD2_BmpDecoder,
+// the body byte by byte with reads and skips, abort by the progress callback, status 404 and the timeout.
+//
+// build and run in this directory, on Linux or macOS:
+//   g++ -std=gnu++11 -Wall -pthread -I. -I../../../src GxEPD2_HttpSourceTest.cpp -o GxEPD2_HttpSourceTest && ./GxEPD2_HttpSourceTest ../../bitmaps
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BmpDecoder.h>
+#include <GxEPD2_HttpSource.h>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static std::string directory;
+
+static Bytes load(const std::string& name)
+{
+  Bytes data;
+  FILE* f = fopen((directory + "/" + name).c_str(), "rb");
+  for (int c; f && ((c = fgetc(f)) >= 0);) data.push_back(c);
+  if (f) fclose(f);
+  return data;
+}
+
+// stand-in HTTP server, one thread per connection; requests are GET /mode/name
+
+static void send_all(int fd, const void* data, size_t n)
+{
+  const uint8_t* p = (const uint8_t*)data;
+  while (n > 0)
+  {
+    ssize_t sent = send(fd, p, n, 0);
+    if (sent <= 0) return; // closed by the client, e.g. after abort
+    p += sent;
+    n -= sent;
+  }
+}
+
+static void send_all(int fd, const std::string& s)
+{
+  send_all(fd, s.data(), s.size());
+}
+
+static void serve(int fd)
+{
+  std::string request;
+  char c;
+  while ((request.find("\r\n\r\n") == std::string::npos) && (recv(fd, &c, 1, 0) == 1)) request += c;
+  size_t start = request.find(" /") + 2, end = request.find(' ', start);
+  std::string path = request.substr(start, end - start);
+  std::string mode = path.substr(0, path.find('/'));
+  Bytes body = load(path.substr(path.find('/') + 1));
+  if (body.empty())
+  {
+    send_all(fd, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+    close(fd);
+    return;
+  }
+  char length[64];
+  snprintf(length, sizeof(length), "Content-Length: %u\r\n", unsigned(body.size()));
+  // a header line longer than the line buffer of begin()
+  std::string headers = "HTTP/1.1 200 OK\r\nContent-Type: image/bmp\r\nX-Long-Header: " + std::string(300, 'x') + "\r\n";
+  uint32_t random = body.size();
+  if (mode == "chunked")
+  {
+    send_all(fd, headers + "transfer-encoding: Chunked\r\n\r\n");
+    for (size_t i = 0; i < body.size();)
+    {
+      random = random * 1103515245 + 12345;
+      size_t n = (random >> 8) % 3000 + 1;
+      if (n > body.size() - i) n = body.size() - i;
+      char size[32];
+      snprintf(size, sizeof(size), "%X%s\r\n", unsigned(n), (random >> 4) % 5 == 0 ? ";name=val" : "");
+      send_all(fd, size);
+      send_all(fd, &body[i], n);
+      send_all(fd, "\r\n");
+      i += n;
+    }
+    send_all(fd, "0\r\nX-Trailer: t\r\n\r\n");
+  }
+  else if (mode == "close") // no Content-Length, body ends at close
+  {
+    send_all(fd, headers + "Connection: close\r\n\r\n");
+    send_all(fd, &body[0], body.size());
+  }
+  else
+  {
+    send_all(fd, headers + length + "\r\n");
+    if (mode == "slow")
+    {
+      for (size_t i = 0; i < body.size(); i += 1460)
+      {
+        send_all(fd, &body[i], body.size() - i < 1460 ? body.size() - i : 1460);
+        usleep(500);
+      }
+    }
+    else if (mode == "stall")
+    {
+      send_all(fd, &body[0], body.size() / 2);
+      usleep(1000000);
+    }
+    else send_all(fd, &body[0], body.size());
+  }
+  close(fd);
+}
+
+static uint16_t listen_local()
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in a;
+  memset(&a, 0, sizeof(a));
+  a.sin_family = AF_INET;
+  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  a.sin_port = 0; // any free port
+  socklen_t size = sizeof(a);
+  if ((fd < 0) || (bind(fd, (struct sockaddr*)&a, size) != 0) || (listen(fd, 16) != 0) || (getsockname(fd, (struct sockaddr*)&a, &size) != 0)) return 0;
+  std::thread([fd]()
+  {
+    for (int c; (c = accept(fd, 0, 0)) >= 0;) std::thread(serve, c).detach();
+  }).detach();
+  return ntohs(a.sin_port);
+}
+
+// client side
+
+static uint16_t port;
+static uint8_t ring[1500];
+
+static bool request(GxEPD2_PosixClient& client, const std::string& path)
+{
+  if (!client.connect("127.0.0.1", port)) return false;
+  std::string r = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n";
+  return client.write((const uint8_t*)r.data(), r.size()) == r.size();
+}
+
+// controller memory stand-in, one character per pixel and plane
+struct Canvas
+{
+  int W, H;
+  std::string black, color;
+  Canvas(int w, int h) : W(w), H(h), black(w * h, '?'), color(w * h, '1') {}
+  void put(std::string& s, const uint8_t* data, int x, int y, int w, int h, bool invert, bool mirror_y)
+  {
+    int wb = (w + 7) / 8;
+    for (int i = 0; i < h; i++)
+    {
+      for (int j = 0; j < w; j++)
+      {
+        int row = mirror_y ? h - 1 - i : i;
+        int v = ((data[row * wb + j / 8] >> (7 - j % 8)) & 1) ^ invert;
+        if ((y + i < H) && (x + j < W)) s[(y + i) * W + x + j] = '0' + v;
+      }
+    }
+  }
+  void writeImage(const uint8_t* b, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool)
+  {
+    put(black, b, x, y, w, h, invert, mirror_y);
+  }
+  void writeImage(const uint8_t* b, const uint8_t* c, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool)
+  {
+    put(black, b, x, y, w, h, invert, mirror_y);
+    put(color, c, x, y, w, h, invert, mirror_y);
+  }
+  void writeNative(const uint8_t*, const uint8_t*, int16_t, int16_t, int16_t, int16_t, bool, bool, bool) {}
+};
+
+static int checks = 0, fails = 0;
+
+static void expect(bool ok, const char* what, const char* mode, const std::string& name)
+{
+  checks++;
+  if (ok) return;
+  printf("FAIL %s %s %s\n", what, mode, name.c_str());
+  fails++;
+}
+
+static uint32_t abort_at;
+
+static bool progress(uint32_t received, uint32_t total, void* context)
+{
+  (*(int*)context)++;
+  return received < abort_at;
+}
+
+int main(int argc, char** argv)
+{
+  directory = argc > 1 ? argv[1] : "../../bitmaps";
+  signal(SIGPIPE, SIG_IGN); // the client closes early on abort and timeout
+  port = listen_local();
+  if (!port)
+  {
+    printf("no local port\n");
+    return 1;
+  }
+  std::vector<std::string> names;
+  DIR* d = opendir(directory.c_str());
+  for (struct dirent* e; d && (e = readdir(d));)
+  {
+    if (strstr(e->d_name, ".bmp")) names.push_back(e->d_name);
+  }
+  if (d) closedir(d);
+  const char* modes[] = {"plain", "chunked", "close", "slow"};
+  for (size_t i = 0; i < names.size(); i++)
+  {
+    const std::string& name = names[i];
+    Bytes want = load(name);
+    // decoded through the HTTP source as from memory
+    GxEPD2_MemorySource memory(&want[0], want.size());
+    GxEPD2_BmpDecoder reference(memory);
+    if (reference.begin())
+    {
+      Canvas expected(reference.width(), reference.height());
+      bool written = reference.write(expected, 0, 0);
+      for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+      {
+        GxEPD2_PosixClient client;
+        bool ok = request(client, std::string("/") + modes[m] + "/" + name);
+        GxEPD2_HttpSource<GxEPD2_PosixClient> source(client, ring, sizeof(ring));
+        ok = ok && source.begin();
+        GxEPD2_BmpDecoder decoder(source);
+        ok = ok && decoder.begin();
+        Canvas canvas(reference.width(), reference.height());
+        ok = ok && (decoder.write(canvas, 0, 0) == written) && (canvas.black == expected.black) && (canvas.color == expected.color);
+        ok = ok && (source.chunked() == (m == 1)) && !source.aborted() && !source.timedOut();
+        expect(ok, "decode", modes[m], name);
+      }
+    }
+    if (want.size() <= 2000) continue;
+    // whole body, byte by byte, with a skip; Content-Length is the total, if sent
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++)
+    {
+      GxEPD2_PosixClient client;
+      bool ok = request(client, std::string("/") + modes[m] + "/" + name);
+      GxEPD2_HttpSource<GxEPD2_PosixClient> source(client, ring, sizeof(ring));
+      ok = ok && source.begin() && (source.status() == 200);
+      Bytes got(want.size() + 100);
+      uint16_t first = source.read(&got[0], 1000);
+      source.skip(7);
+      uint32_t n = 1007;
+      for (uint16_t k; (k = source.read(&got[n], 40000)) > 0;) n += k;
+      ok = ok && (first == 1000) && (n == want.size()) && !memcmp(&got[0], &want[0], 1000) && !memcmp(&got[1007], &want[1007], n - 1007);
+      ok = ok && (source.consumed() == want.size()) && (source.received() == want.size()) && (source.buffered() == 0);
+      ok = ok && (source.complete() || (m == 2)) && (source.total() == ((m == 0) || (m == 3) ? want.size() : 0));
+      expect(ok, "body", modes[m], name);
+    }
+    // abort by the progress callback, after half of the body
+    {
+      GxEPD2_PosixClient client;
+      bool ok = request(client, "/chunked/" + name);
+      GxEPD2_HttpSource<GxEPD2_PosixClient> source(client, ring, sizeof(ring));
+      int calls = 0;
+      abort_at = want.size() / 2;
+      source.onProgress(progress, &calls);
+      ok = ok && source.begin();
+      Bytes got(want.size());
+      uint32_t n = 0;
+      for (uint16_t k; (k = source.read(&got[n], 512)) > 0;) n += k;
+      ok = ok && source.aborted() && (source.received() >= abort_at) && (source.received() < want.size()) && (calls > 0);
+      ok = ok && (n <= source.received()) && (source.received() - n <= sizeof(ring)) && (source.read(&got[0], 1) == 0);
+      ok = ok && !memcmp(&got[0], &want[0], n);
+      expect(ok, "abort", "chunked", name);
+    }
+  }
+  {
+    GxEPD2_PosixClient client;
+    bool ok = request(client, "/plain/missing.bmp");
+    GxEPD2_HttpSource<GxEPD2_PosixClient> source(client, ring, sizeof(ring));
+    expect(ok && !source.begin() && (source.status() == 404), "status 404", "plain", "missing.bmp");
+  }
+  if (!names.empty())
+  {
+    // the server sends half of the body, then nothing for a second
+    Bytes want = load(names[0]);
+    GxEPD2_PosixClient client;
+    bool ok = request(client, "/stall/" + names[0]);
+    GxEPD2_HttpSource<GxEPD2_PosixClient> source(client, ring, sizeof(ring), 200);
+    ok = ok && source.begin();
+    Bytes got(want.size());
+    uint32_t n = 0;
+    uint32_t start = millis();
+    for (uint16_t k; (k = source.read(&got[n], 4096)) > 0;) n += k;
+    ok = ok && source.timedOut() && (n == want.size() / 2) && (millis() - start < 900) && !memcmp(&got[0], &want[0], n);
+    expect(ok, "timeout", "stall", names[0]);
+  }
+  printf("%u bitmap files, %d checks, %s\n", unsigned(names.size()), checks, fails ? "FAILED" : "ok");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,503 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host test of GxEPD2_PngDecoder: decodes generated PNG images of each color type and depth, with stored blocks and
+// every filter type, and two zlib fixtures of fixed and dynamic Huffman blocks, with readRow(), write() and draw();
+// compares with the pixels the images were made of; checks rejection of interlaced and unsupported images,
+// and errors on truncated and corrupt image data.
+//
+// build and run in this directory, on Linux or macOS:
+//   g++ -std=gnu++11 -Wall -I. -I../../../src GxEPD2_PngDecoderTest.cpp -o GxEPD2_PngDecoderTest && ./GxEPD2_PngDecoderTest
+// add -DGxEPD2_SOURCE_BLOCK_SIZE=64 -DGxEPD2_PNG_WINDOW_BITS=8 -DGxEPD2_PNG_MAX_ROW_BYTES=50 -DGxEPD2_PNG_INPUT_SIZE=16
+// -DGxEPD2_PNG_RGB565=0 for the configuration of AVR
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_PngDecoder.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+// zlib streams of the 48 x 16 greyscale image of 8 bits of sample(), filter type row % 5 as filtered();
+// by Python zlib, window of 9 bits (distances up to 250), strategy Z_FIXED and default: one fixed, one dynamic Huffman block
+static const uint8_t fixed_48x16[] =
+{
+  0x18, 0x19, 0x63, 0x60, 0x60, 0x8F, 0x0E, 0x58, 0xB6, 0xF2, 0xEB, 0x3F, 0x0E, 0xFE, 0xE0, 0x88,
+  0x75, 0x0B, 0xFF, 0x7E, 0x23, 0xC4, 0x67, 0xFC, 0xF7, 0x53, 0xE2, 0x7B, 0xD0, 0xCF, 0x00, 0x76,
+  0x3F, 0x4E, 0x0E, 0x76, 0x27, 0xCE, 0x80, 0xEF, 0x71, 0x04, 0xF8, 0x4C, 0xAB, 0xD6, 0x7C, 0xF8,
+  0xB4, 0x6D, 0xCB, 0x8E, 0x75, 0x40, 0xFA, 0xD1, 0xB6, 0x2D, 0x2B, 0xF6, 0x11, 0xE2, 0x33, 0x33,
+  0x3D, 0xFE, 0x73, 0x71, 0x46, 0x7D, 0xCA, 0x65, 0x9E, 0xCB, 0x7F, 0x1E, 0x2E, 0xC8, 0x4F, 0xB9,
+  0xFD, 0x87, 0x00, 0x9F, 0x65, 0x1D, 0xFB, 0x0F, 0x56, 0x0E, 0xE6, 0x27, 0x9C, 0x42, 0xDF, 0x39,
+  0xBE, 0xFE, 0x60, 0xFE, 0xF2, 0x53, 0x88, 0x00, 0x9F, 0xE1, 0xD7, 0x67, 0x66, 0xAE, 0x90, 0xD8,
+  0xA5, 0x6B, 0x3E, 0xFD, 0xE6, 0x66, 0x8A, 0x09, 0x5D, 0xBB, 0x84, 0x10, 0x9F, 0x71, 0xCD, 0xEF,
+  0x90, 0x9F, 0x7C, 0xEC, 0x3E, 0x7F, 0x83, 0xB8, 0x5D, 0x38, 0xF9, 0xBE, 0xC7, 0xFC, 0x0D, 0x22,
+  0xC0, 0x67, 0x5A, 0xB6, 0x65, 0xCB, 0xA6, 0x5F, 0x6F, 0xD6, 0x6C, 0xDB, 0xB6, 0x64, 0xCB, 0xA6,
+  0x57, 0x7F, 0xD6, 0x2C, 0x23, 0xC4, 0x67, 0xBE, 0x7F, 0xEF, 0xCB, 0x1D, 0x96, 0x0B, 0x6B, 0x4A,
+  0x22, 0xEE, 0xB1, 0x9C, 0x61, 0xB9, 0x31, 0xA7, 0x25, 0x81, 0x00, 0x9F, 0xE5, 0x1D, 0x27, 0x07,
+  0xFB, 0x0F, 0x4E, 0x8E, 0xEF, 0xFF, 0x7E, 0x4A, 0x7C, 0xE7, 0xF8, 0xF9, 0x83, 0x9D, 0x10, 0x9F,
+  0x61, 0xC1, 0xEA, 0xEF, 0x1F, 0xD8, 0x78, 0x03, 0xE3, 0x56, 0x2C, 0xFE, 0xFF, 0x83, 0x8F, 0x35,
+  0x32, 0x8C, 0x10, 0x9F, 0x31, 0xEE, 0xA7, 0x0F, 0xBB, 0xDF, 0x4F, 0x11, 0x76, 0x2F, 0x4E, 0x9F,
+  0xEF, 0x7E, 0x9C, 0x22, 0xDF, 0xA3, 0x08, 0xF0, 0x99, 0xD6, 0xAD, 0xD9, 0xB3, 0x6A, 0xD5, 0x96,
+  0x2F, 0xCF, 0xD6, 0xAD, 0x59, 0xB3, 0x6B, 0xD7, 0x96, 0x27, 0xDF, 0x08, 0xF1, 0x99, 0xDF, 0x34,
+  0xC6, 0x5D, 0xE6, 0xBA, 0xCA, 0x76, 0x75, 0x59, 0x61, 0xDC, 0xED, 0x5F, 0x77, 0xFF, 0xDD, 0x9D,
+  0x46, 0x80, 0xCF, 0xB2, 0x89, 0xFB, 0x05, 0x27, 0xDF, 0x77, 0x8E, 0xBF, 0x1C, 0xBF, 0x7F, 0xFC,
+  0xE4, 0x63, 0xFF, 0xF1, 0xF7, 0x07, 0x01, 0x3E, 0x43, 0x54, 0xF0, 0xF2, 0x75, 0x5F, 0xFE, 0x72,
+  0x32, 0x04, 0x45, 0xAF, 0x5F, 0xF6, 0xE7, 0x2B, 0x23, 0x07, 0x21, 0x3E, 0x00, 0x4B, 0xB1, 0xA8,
+  0x2D
+};
+static const uint8_t dynamic_48x16[] =
+{
+  0x18, 0xD3, 0x85, 0xC7, 0xCF, 0x4A, 0x02, 0x41, 0x1C, 0x00, 0xE0, 0xFD, 0xA7, 0x33, 0xA3, 0xB5,
+  0x81, 0x78, 0xF0, 0x79, 0xA2, 0x53, 0x88, 0xD8, 0x6A, 0x61, 0x6A, 0x4B, 0x07, 0xEF, 0x11, 0x74,
+  0x8F, 0xA0, 0x67, 0x88, 0x0E, 0x1D, 0x8C, 0x6A, 0x33, 0x9B, 0x36, 0x90, 0x65, 0x09, 0x89, 0x9E,
+  0xA0, 0x43, 0x21, 0x42, 0x60, 0x1A, 0x95, 0x44, 0x84, 0x84, 0xD8, 0xEA, 0xCC, 0xE8, 0xEE, 0x56,
+  0x6F, 0xF0, 0x3B, 0x7D, 0x7C, 0x92, 0x84, 0x4A, 0x59, 0xEB, 0x62, 0x1C, 0xE2, 0x85, 0x5C, 0xC1,
+  0x3E, 0x0E, 0x26, 0xD0, 0xE5, 0x50, 0xA4, 0x98, 0x21, 0xB2, 0x28, 0x43, 0x30, 0x5A, 0x24, 0x59,
+  0x66, 0x02, 0x57, 0xEA, 0x74, 0x38, 0x72, 0x9D, 0x1B, 0xFB, 0xDF, 0x37, 0xD7, 0xA9, 0xDD, 0x41,
+  0x57, 0x95, 0x77, 0xFF, 0xF1, 0x70, 0xB7, 0xD2, 0x9A, 0x6B, 0xF9, 0xAF, 0xD5, 0xAD, 0x4A, 0xC7,
+  0x07, 0xAE, 0xD9, 0x88, 0x47, 0xB0, 0xDA, 0x27, 0x09, 0x86, 0xC7, 0x5C, 0xF5, 0x44, 0x02, 0xB8,
+  0x34, 0xFD, 0x51, 0x63, 0xF9, 0x8D, 0x33, 0x3A, 0x9A, 0xC5, 0x95, 0xF2, 0xEA, 0xD5, 0x29, 0x74,
+  0x99, 0xCE, 0xF2, 0x42, 0x47, 0xE9, 0xC0, 0x88, 0x2F, 0x11, 0x9D, 0x95, 0x03, 0x03, 0xB8, 0x62,
+  0x39, 0x4E, 0x63, 0x3A, 0xA0, 0xAE, 0x7B, 0xEA, 0x34, 0xBE, 0x7C, 0x6A, 0x41, 0x57, 0x5F, 0x7A,
+  0xDE, 0xB3, 0xF6, 0x40, 0x77, 0x0A, 0x3D, 0xED, 0x5E, 0x7B, 0x3A, 0xDA, 0xDF, 0x04, 0xAE, 0x7D,
+  0x13, 0x8C, 0x38, 0xC1, 0x2C, 0x14, 0x29, 0x86, 0x05, 0x47, 0xD0, 0xA5, 0xEA, 0x25, 0x1B, 0x46,
+  0xE7, 0x57, 0xCC, 0xDA, 0xC9, 0x2F, 0xD7, 0x23, 0xEB, 0x6B, 0xD0, 0x65, 0x53, 0xA4, 0x51, 0x46,
+  0x24, 0xD1, 0x32, 0x49, 0xB3, 0x0C, 0x49, 0xB2, 0x22, 0x70, 0xC5, 0xA6, 0xB7, 0xF5, 0xBA, 0xE3,
+  0x7D, 0xD8, 0x94, 0x36, 0x9B, 0x4E, 0x7F, 0x02, 0x5D, 0x1D, 0xEC, 0x99, 0xAD, 0x58, 0x3B, 0xDA,
+  0xB6, 0xB6, 0xCD, 0xCE, 0xB4, 0x1B, 0x76, 0x0F, 0x80, 0x6B, 0x8D, 0xF8, 0x27, 0xD1, 0x19, 0x0E,
+  0xF0, 0x8C, 0x0B, 0x1D, 0xF1, 0x80, 0x03, 0x97, 0x8A, 0xB9, 0x73, 0xDB, 0x0B, 0x88, 0x64, 0x94,
+  0xAE, 0x2D, 0x7F, 0x2C, 0x63, 0xE8, 0x7F, 0x4B, 0xB1, 0xA8, 0x2D
+};
+
+struct Rgb
+{
+  uint8_t r, g, b;
+};
+
+static const Rgb white = {255, 255, 255};
+
+// white, black, red, yellow, greys and mixed colors
+static const Rgb palette[] = {{255, 255, 255}, {0, 0, 0}, {255, 0, 0}, {255, 255, 0}, {96, 96, 96}, {200, 200, 200}};
+
+// sample c of pixel x, y of the generated images: levels around the thresholds of white and red, with noise for the filters
+static uint16_t sample(int x, int y, int c, uint8_t depth)
+{
+  if (depth < 8) return (x + 2 * y) % (1 << depth);
+  uint8_t v = uint8_t(((x / 2 + 3 * y + 5 * c) % 4) * 85) ^ ((7 * x + y) & 0x0F);
+  return depth == 16 ? (uint16_t(v) << 8) | uint8_t(x * y + c) : v;
+}
+
+struct Image
+{
+  uint8_t type, depth, channels;
+  int w, h;
+  uint32_t row_bytes;
+  Bytes raw, plte, trns; // unfiltered rows, contents of PLTE and tRNS
+  std::vector<Rgb> pixels; // as shown, transparent is white
+};
+
+// palette images use indexes up to 7 of 6 entries, indexes beyond the palette are white
+// trns: palette entry 1 transparent, or the color of pixel 3, 1 for greyscale and true color
+static Image image(uint8_t type, uint8_t depth, bool trns, int w, int h)
+{
+  Image im;
+  im.type = type;
+  im.depth = depth;
+  im.channels = type == 2 ? 3 : type == 4 ? 2 : type == 6 ? 4 : 1;
+  im.w = w;
+  im.h = h;
+  im.row_bytes = (uint32_t(w) * im.channels * depth + 7) / 8;
+  im.raw.assign(im.row_bytes * h, 0);
+  int indexes = depth < 3 ? 1 << depth : 8;
+  int entries = indexes < 6 ? indexes : 6;
+  for (int i = 0; (type == 3) && (i < entries); i++)
+  {
+    im.plte.push_back(palette[i].r);
+    im.plte.push_back(palette[i].g);
+    im.plte.push_back(palette[i].b);
+  }
+  uint16_t key[3] = {0, 0, 0};
+  if (trns && (type == 3))
+  {
+    im.trns.push_back(255);
+    im.trns.push_back(0);
+  }
+  else if (trns)
+  {
+    for (int c = 0; c < im.channels; c++)
+    {
+      key[c] = sample(3, 1, c, depth);
+      im.trns.push_back(key[c] >> 8);
+      im.trns.push_back(key[c]);
+    }
+  }
+  for (int y = 0; y < h; y++)
+  {
+    for (int x = 0; x < w; x++)
+    {
+      uint16_t s[4];
+      for (int c = 0; c < im.channels; c++)
+      {
+        s[c] = type == 3 ? (x + 2 * y) % indexes : sample(x, y, c, depth);
+        uint32_t bit = y * im.row_bytes * 8 + (uint32_t(x) * im.channels + c) * depth;
+        if (depth == 16)
+        {
+          im.raw[bit / 8] = s[c] >> 8;
+          im.raw[bit / 8 + 1] = s[c];
+        }
+        else im.raw[bit / 8] |= s[c] << (8 - depth - bit % 8);
+      }
+      uint8_t v0 = depth == 16 ? s[0] >> 8 : s[0], v1 = depth == 16 ? s[1] >> 8 : s[1], v2 = depth == 16 ? s[2] >> 8 : s[2];
+      Rgb p = white;
+      if (type == 3)
+      {
+        if ((s[0] < entries) && !(trns && (s[0] == 1))) p = palette[s[0]];
+      }
+      else if (type == 0)
+      {
+        uint8_t g = depth < 8 ? s[0] * (255 / ((1 << depth) - 1)) : v0;
+        if (!trns || (s[0] != key[0])) p = {g, g, g};
+      }
+      else if (type == 4)
+      {
+        if (v1 >= 0x80) p = {v0, v0, v0};
+      }
+      else if (type == 2)
+      {
+        if (!trns || (s[0] != key[0]) || (s[1] != key[1]) || (s[2] != key[2])) p = {v0, v1, v2};
+      }
+      else if ((depth == 16 ? s[3] >> 8 : s[3]) >= 0x80) p = {v0, v1, v2};
+      im.pixels.push_back(p);
+    }
+  }
+  return im;
+}
+
+static uint8_t paeth(int a, int b, int c)
+{
+  int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+  return (pa <= pb) && (pa <= pc) ? a : pb <= pc ? b : c;
+}
+
+// rows with filter type row % 5: none, sub, up, average, paeth
+static Bytes filtered(const Image& im)
+{
+  uint32_t n = im.row_bytes, bpp = im.channels * im.depth / 8 > 0 ? im.channels * im.depth / 8 : 1;
+  Bytes out, prev(n, 0);
+  for (int y = 0; y < im.h; y++)
+  {
+    const uint8_t* r = &im.raw[y * n];
+    uint8_t f = y % 5;
+    out.push_back(f);
+    for (uint32_t i = 0; i < n; i++)
+    {
+      uint8_t a = i >= bpp ? r[i - bpp] : 0, b = prev[i], c = i >= bpp ? prev[i - bpp] : 0;
+      uint8_t predicted = f == 1 ? a : f == 2 ? b : f == 3 ? (a + b) / 2 : f == 4 ? paeth(a, b, c) : 0;
+      out.push_back(r[i] - predicted);
+    }
+    prev.assign(r, r + n);
+  }
+  return out;
+}
+
+static void put32(Bytes& d, uint32_t v) // big endian
+{
+  for (int i = 3; i >= 0; i--) d.push_back(v >> (8 * i));
+}
+
+// zlib stream of stored blocks of up to block bytes
+static Bytes stored(const Bytes& data, uint16_t block)
+{
+  Bytes z;
+  z.push_back(0x78);
+  z.push_back(0x01);
+  for (size_t i = 0; i < data.size(); i += block)
+  {
+    uint16_t n = data.size() - i < block ? data.size() - i : block;
+    z.push_back(i + n == data.size() ? 1 : 0); // last, stored
+    z.push_back(n);
+    z.push_back(n >> 8);
+    z.push_back(~n);
+    z.push_back(~n >> 8);
+    z.insert(z.end(), data.begin() + i, data.begin() + i + n);
+  }
+  uint32_t a = 1, b = 0;
+  for (size_t i = 0; i < data.size(); i++)
+  {
+    a = (a + data[i]) % 65521;
+    b = (b + a) % 65521;
+  }
+  put32(z, (b << 16) | a);
+  return z;
+}
+
+static void chunk(Bytes& png, const char* type, const Bytes& data)
+{
+  put32(png, data.size());
+  size_t start = png.size();
+  png.insert(png.end(), type, type + 4);
+  png.insert(png.end(), data.begin(), data.end());
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = start; i < png.size(); i++)
+  {
+    crc ^= png[i];
+    for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+  }
+  put32(png, ~crc);
+}
+
+// PNG file of im with image data zlib, split into IDAT chunks of 29 bytes, with an ancillary chunk to skip
+static Bytes png(const Image& im, const Bytes& zlib, uint8_t interlace = 0)
+{
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  Bytes file(signature, signature + 8), ihdr;
+  put32(ihdr, im.w);
+  put32(ihdr, im.h);
+  const uint8_t rest[] = {im.depth, im.type, 0, 0, interlace};
+  ihdr.insert(ihdr.end(), rest, rest + sizeof(rest));
+  chunk(file, "IHDR", ihdr);
+  const char text[] = "Comment\0GxEPD2_PngDecoderTest";
+  chunk(file, "tEXt", Bytes(text, text + sizeof(text) - 1));
+  if (!im.plte.empty()) chunk(file, "PLTE", im.plte);
+  if (!im.trns.empty()) chunk(file, "tRNS", im.trns);
+  for (size_t i = 0; i < zlib.size(); i += 29) chunk(file, "IDAT", Bytes(zlib.begin() + i, zlib.begin() + (i + 29 < zlib.size() ? i + 29 : zlib.size())));
+  chunk(file, "IEND", Bytes());
+  return file;
+}
+
+// 0 white, 1 black, 2 colored, as the decoder classifies
+static int classify(bool color, const Rgb& p)
+{
+  bool whitish = color ? (p.r > 0x80) && (p.g > 0x80) && (p.b > 0x80) : p.r + p.g + p.b > 3 * 0x80;
+  if (whitish) return 0;
+  if (color && ((p.r > 0xF0) || ((p.g > 0xF0) && (p.b > 0xF0)))) return 2;
+  return 1;
+}
+
+// pixels as '0' or '1' per plane, bit 1 is white as for writeImage, '?' if not written; colors of drawPixel
+struct Canvas
+{
+  int W, H;
+  std::string black, color;
+  std::vector<uint16_t> rgb;
+  Canvas(int w, int h) : W(w), H(h), black(w * h, '?'), color(w * h, '1'), rgb(w * h, 0) {}
+  void put(std::string& s, const uint8_t* data, int x, int y, int w, int h)
+  {
+    int wb = (w + 7) / 8;
+    for (int i = 0; i < h; i++)
+    {
+      for (int j = 0; j < w; j++)
+      {
+        if ((y + i < H) && (x + j < W)) s[(y + i) * W + x + j] = '0' + ((data[i * wb + j / 8] >> (7 - j % 8)) & 1);
+      }
+    }
+  }
+  void writeImage(const uint8_t* b, int16_t x, int16_t y, int16_t w, int16_t h, bool, bool, bool)
+  {
+    put(black, b, x, y, w, h);
+  }
+  void writeImage(const uint8_t* b, const uint8_t* c, int16_t x, int16_t y, int16_t w, int16_t h, bool, bool, bool)
+  {
+    put(black, b, x, y, w, h);
+    put(color, c, x, y, w, h);
+  }
+  int16_t height()
+  {
+    return H;
+  }
+  void drawPixel(int16_t x, int16_t y, uint16_t c)
+  {
+    if ((x >= W) || (y >= H)) return;
+    black[y * W + x] = c == GxEPD_BLACK ? '0' : '1';
+    color[y * W + x] = c == GxEPD_RED ? '0' : '1';
+    rgb[y * W + x] = c;
+  }
+  std::string area(const std::string& s, int x, int y, int w, int h) const
+  {
+    std::string a;
+    for (int i = 0; i < h; i++) a += s.substr((y + i) * W + x, w);
+    return a;
+  }
+};
+
+static int checks = 0, fails = 0;
+
+static void fail(const std::string& name, bool with_color, const char* what)
+{
+  printf("FAIL %s color %d: %s\n", name.c_str(), with_color, what);
+  fails++;
+}
+
+static void check(const std::string& name, const Image& im, const Bytes& file, bool with_color)
+{
+  bool color = with_color && (im.type != 0) && (im.type != 4);
+  bool fits = im.row_bytes <= GxEPD2_PNG_MAX_ROW_BYTES;
+  int w = im.w, h = im.h;
+  std::string black(w * h, '1'), colored(w * h, '1');
+  std::vector<uint16_t> rgb;
+  for (int i = 0; i < w * h; i++)
+  {
+    const Rgb& p = im.pixels[i];
+    int c = classify(color, p);
+    if (c == 1) black[i] = '0';
+    if (c == 2) colored[i] = '0';
+    bool classified = (im.type == 3) && !GxEPD2_PNG_RGB565; // palette without rgb565 draws as with multicolor false
+    rgb.push_back(classified ? (c == 0 ? GxEPD_WHITE : c == 2 ? GxEPD_RED : GxEPD_BLACK) : ((p.r & 0xF8) << 8) | ((p.g & 0xFC) << 3) | (p.b >> 3));
+  }
+  checks++;
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_PngDecoder decoder(source, with_color);
+    if (decoder.begin() != fits) return fail(name, with_color, fits ? "begin" : "accepted row over GxEPD2_PNG_MAX_ROW_BYTES");
+    if (!fits) return;
+    if ((decoder.width() != w) || (decoder.height() != h) || (decoder.depth() != im.depth) || (decoder.colorType() != im.type))
+    {
+      return fail(name, with_color, "header");
+    }
+    std::string b(w * h, '?'), c(w * h, '?');
+    Bytes row((w + 7) / 8), crow((w + 7) / 8);
+    int n = 0;
+    while ((n < h) && (decoder.readRow(&row[0], &crow[0]) == n))
+    {
+      for (int x = 0; x < w; x++)
+      {
+        b[n * w + x] = '0' + ((row[x / 8] >> (7 - x % 8)) & 1);
+        c[n * w + x] = '0' + ((crow[x / 8] >> (7 - x % 8)) & 1);
+      }
+      n++;
+    }
+    if ((n != h) || (b != black) || (c != colored)) fail(name, with_color, "readRow");
+    if ((decoder.readRow(&row[0], &crow[0]) >= 0) || decoder.error()) fail(name, with_color, "end");
+  }
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_PngDecoder decoder(source, with_color);
+    decoder.begin();
+    Canvas canvas(w + 8, h + 3);
+    if (!decoder.write(canvas, 8, 3) || (canvas.area(canvas.black, 8, 3, w, h) != black) || (canvas.area(canvas.color, 8, 3, w, h) != colored))
+    {
+      fail(name, with_color, "write");
+    }
+  }
+  for (int multicolor = 0; multicolor < 2; multicolor++)
+  {
+    GxEPD2_MemorySource source(&file[0], file.size());
+    GxEPD2_PngDecoder decoder(source, with_color);
+    decoder.begin();
+    Canvas canvas(w + 5, h - 1); // last row not drawn
+    bool ok = decoder.draw(canvas, 5, 0, multicolor);
+    if (multicolor && color)
+    {
+      for (int y = 0; y < h - 1; y++)
+      {
+        for (int x = 0; x < w; x++) ok = ok && (canvas.rgb[y * canvas.W + 5 + x] == rgb[y * w + x]);
+      }
+    }
+    else
+    {
+      ok = ok && (canvas.area(canvas.black, 5, 0, w, h - 1) == black.substr(0, w * (h - 1)));
+      ok = ok && (canvas.area(canvas.color, 5, 0, w, h - 1) == colored.substr(0, w * (h - 1)));
+    }
+    if (!ok) fail(name, with_color, multicolor ? "draw, multicolor" : "draw");
+  }
+}
+
+// begin() rejects the file
+static void rejected(const char* name, const Bytes& file)
+{
+  checks++;
+  GxEPD2_MemorySource source(&file[0], file.size());
+  GxEPD2_PngDecoder decoder(source);
+  if (decoder.begin()) fail(name, true, "accepted");
+}
+
+// begin() accepts the file, the rows stop early with error()
+static void broken(const char* name, const Bytes& file, int h)
+{
+  checks++;
+  GxEPD2_MemorySource source(&file[0], file.size());
+  GxEPD2_PngDecoder decoder(source);
+  if (!decoder.begin()) return fail(name, true, "begin");
+  Bytes row(GxEPD2_PNG_MAX_ROW_BYTES), crow(GxEPD2_PNG_MAX_ROW_BYTES);
+  int n = 0;
+  while ((n <= h) && (decoder.readRow(&row[0], &crow[0]) >= 0)) n++;
+  if ((n >= h) || !decoder.error() || decoder.valid() || (decoder.readRow(&row[0], &crow[0]) >= 0)) fail(name, true, "not detected");
+}
+
+// IHDR contents start at 16; the CRC is not updated, the decoder does not check it
+static Bytes patched(Bytes file, size_t pos, uint8_t value)
+{
+  file[pos] = value;
+  return file;
+}
+
+int main()
+{
+  struct
+  {
+    uint8_t type, depth;
+    bool trns;
+  } formats[] =
+  {
+    {0, 1, false}, {0, 2, false}, {0, 4, false}, {0, 8, false}, {0, 16, false}, {0, 8, true}, {0, 16, true},
+    {2, 8, false}, {2, 16, false}, {2, 8, true}, {2, 16, true},
+    {3, 1, false}, {3, 2, false}, {3, 4, false}, {3, 8, false}, {3, 8, true},
+    {4, 8, false}, {4, 16, false}, {6, 8, false}, {6, 16, false}
+  };
+  for (size_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++)
+  {
+    Image im = image(formats[i].type, formats[i].depth, formats[i].trns, 13, 10);
+    char name[48];
+    snprintf(name, sizeof(name), "type %u, %u bits%s, stored", formats[i].type, formats[i].depth, formats[i].trns ? ", tRNS" : "");
+    Bytes file = png(im, stored(filtered(im), 37));
+    check(name, im, file, false);
+    check(name, im, file, true);
+  }
+  {
+    Image im = image(2, 16, false, 401, 2); // 2406 bytes per row
+    check("row over GxEPD2_PNG_MAX_ROW_BYTES", im, png(im, stored(filtered(im), 1000)), true);
+  }
+  Image grey = image(0, 8, false, 48, 16);
+  Bytes fixed(fixed_48x16, fixed_48x16 + sizeof(fixed_48x16)), dynamic(dynamic_48x16, dynamic_48x16 + sizeof(dynamic_48x16));
+  checks++;
+  if (((fixed[2] >> 1) & 3) != 1) fail("fixed", false, "not a fixed Huffman block");
+  if (((dynamic[2] >> 1) & 3) != 2) fail("dynamic", false, "not a dynamic Huffman block");
+  check("fixed Huffman", grey, png(grey, fixed), false);
+  check("dynamic Huffman", grey, png(grey, dynamic), false);
+
+  Image small = image(0, 8, false, 13, 10);
+  Bytes data = filtered(small), z = stored(data, 37), file = png(small, z);
+  rejected("signature", patched(file, 1, 'p'));
+  rejected("interlaced", png(small, z, 1));
+  rejected("true color of 4 bits", patched(patched(file, 24, 4), 25, 2));
+  rejected("compression method", patched(file, 26, 1));
+  rejected("color type 5", patched(file, 25, 5));
+  rejected("truncated header", Bytes(file.begin(), file.begin() + 20));
+  rejected("IEND before IDAT", png(small, Bytes()));
+  Bytes dictionary = z;
+  dictionary[1] = 0x20 | (31 - ((0x78 << 8) | 0x20) % 31); // preset dictionary, valid check bits
+  rejected("zlib preset dictionary", png(small, dictionary));
+  rejected("zlib check bits", png(small, patched(z, 1, 0x02)));
+
+  broken("truncated stored", Bytes(file.begin(), file.begin() + file.size() / 2), small.h);
+  Bytes dynamic_file = png(grey, dynamic);
+  broken("truncated dynamic", Bytes(dynamic_file.begin(), dynamic_file.begin() + dynamic_file.size() / 2), grey.h);
+  broken("stored length check", png(small, patched(z, 5, z[5] ^ 1)), small.h);
+  broken("reserved block type", png(small, patched(z, 2, 0x07)), small.h);
+  Bytes bad_filter = data;
+  bad_filter[2 * (small.row_bytes + 1)] = 5; // filter type of row 2
+  broken("filter type 5", png(small, stored(bad_filter, 37)), small.h);
+  broken("dynamic code counts", png(grey, patched(dynamic, 2, dynamic[2] | 0xF8)), grey.h); // 288 literal/length codes
+  Bytes early = fixed;
+  early[2] &= 0x07; // end of block code right after the block header
+  for (size_t i = 3; i < early.size(); i++) early[i] = 0;
+  broken("end of data before the last row", png(grey, early), grey.h);
+
+  printf("%d checks, %s\n", checks, fails ? "FAILED" : "ok");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,72 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI trace compare, on the host: reads two trace files, e.g. of GxEPD2_SpiTraceRecord or of a File on a board,
+// and prints the CSV lines of GxEPD2_SpiTraceSummary::compare(): the counts of a, of b, and the difference b - a.
+// Exit status 1 if a trace is invalid; with -e also if the traces are not identical.
+//
+// usage: GxEPD2_SpiTraceCompare [-e] <trace file a> <trace file b>
+//
+// build in this directory, on Linux or macOS:
+//   g++ -std=gnu++11 -Wall -I. -I../../../src GxEPD2_SpiTraceCompare.cpp Arduino.cpp -o GxEPD2_SpiTraceCompare
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_SpiTrace.h>
+#include "GxEPD2_HostFile.h"
+
+// true if the files have the same bytes
+bool identical(const char* a, const char* b)
+{
+  GxEPD2_HostFile fa(a, "rb"), fb(b, "rb");
+  if (!fa || !fb) return false;
+  int ca, cb;
+  do
+  {
+    ca = fa.read();
+    cb = fb.read();
+  }
+  while ((ca == cb) && (ca >= 0));
+  return ca == cb;
+}
+
+bool summarize(const char* path, GxEPD2_SpiTraceSummary& summary)
+{
+  GxEPD2_HostFile in(path, "rb");
+  if (!in)
+  {
+    fprintf(stderr, "can't open %s\n", path);
+    return false;
+  }
+  GxEPD2_SpiTraceReader reader(in);
+  if (summary.add(reader)) return true;
+  fprintf(stderr, "trace %s invalid\n", path);
+  return false;
+}
+
+int main(int argc, char** argv)
+{
+  bool exact = (argc > 1) && !strcmp(argv[1], "-e");
+  if (argc != 3 + exact)
+  {
+    fprintf(stderr, "usage: %s [-e] <trace file a> <trace file b>\n", argv[0]);
+    return 2;
+  }
+  const char* path_a = argv[1 + exact];
+  const char* path_b = argv[2 + exact];
+  GxEPD2_SpiTraceSummary* a = new GxEPD2_SpiTraceSummary();
+  GxEPD2_SpiTraceSummary* b = new GxEPD2_SpiTraceSummary();
+  bool valid = summarize(path_a, *a);
+  valid = summarize(path_b, *b) && valid;
+  if (valid) GxEPD2_SpiTraceSummary::compare(Serial, *a, *b);
+  delete a;
+  delete b;
+  if (!valid) return 1;
+  bool same = identical(path_a, path_b);
+  Serial.println(same ? "traces identical" : "traces differ");
+  return !exact || same ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI trace record, on the host: runs an update sequence of GxEPD2_BW on GxEPD2_290_BN8 and records its command and
+// data stream into a trace file, then prints the CSV summary of the trace, read back from the file.
+// Traces of two library versions or of two sequences are compared with GxEPD2_SpiTraceCompare,
+// traces recorded with all data are replayed with GxEPD2_SpiTraceReplay.
+//
+// usage: GxEPD2_SpiTraceRecord <sequence> <trace file> [all]
+//   sequence: init (init only, the controller init is part of the first update), full, partial or fast (fast partial updates)
+//   all: records all data bytes, needed for replay; else data runs longer than GxEPD2_SPI_TRACE_CHUNK are checksums
+//
+// build in this directory, on Linux or macOS (one command line):
+//   g++ -std=gnu++11 -Wall -DGxEPD2_HOST_VIRTUAL_TIME=1 -I. -I../../../src GxEPD2_SpiTraceRecord.cpp Arduino.cpp
+//     ../../../src/GxEPD2_EPD.cpp ../../../src/epd/GxEPD2_290_BN8.cpp -o GxEPD2_SpiTraceRecord
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BW.h>
+#include <GxEPD2_SpiTrace.h>
+#include "GxEPD2_HostFile.h"
+
+GxEPD2_BW<GxEPD2_290_BN8, GxEPD2_290_BN8::HEIGHT> display(GxEPD2_290_BN8(/*CS=*/ 10, /*DC=*/ 8, /*RST=*/ 9, /*BUSY=*/ -1, SPI));
+
+void sequence_full()
+{
+  display.setFullWindow();
+  display.fillScreen(GxEPD_WHITE);
+  display.fillRect(10, 10, 50, 50, GxEPD_BLACK);
+  display.display(false);
+}
+
+void sequence_partial()
+{
+  sequence_full();
+  display.fillRect(10, 70, 50, 20, GxEPD_BLACK);
+  display.displayWindow(0, 64, 64, 32);
+  display.fillRect(10, 70, 50, 20, GxEPD_WHITE);
+  display.displayWindow(0, 64, 64, 32);
+}
+
+void sequence_fast()
+{
+  sequence_full();
+  for (uint16_t i = 0; i < 4; i++)
+  {
+    display.fillRect(10 + 20 * i, 70, 16, 20, GxEPD_BLACK);
+    display.display(true);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  if ((argc < 3) || ((argc > 3) && strcmp(argv[3], "all")))
+  {
+    fprintf(stderr, "usage: %s <init|full|partial|fast> <trace file> [all]\n", argv[0]);
+    return 2;
+  }
+  void (*sequence)() = 0;
+  if (!strcmp(argv[1], "full")) sequence = sequence_full;
+  else if (!strcmp(argv[1], "partial")) sequence = sequence_partial;
+  else if (!strcmp(argv[1], "fast")) sequence = sequence_fast;
+  else if (strcmp(argv[1], "init"))
+  {
+    fprintf(stderr, "unknown sequence %s\n", argv[1]);
+    return 2;
+  }
+  GxEPD2_HostFile out(argv[2], "wb");
+  if (!out)
+  {
+    fprintf(stderr, "can't create %s\n", argv[2]);
+    return 1;
+  }
+  GxEPD2_SpiTrace trace(out, argc > 3);
+  trace.attach(display.epd2);
+  display.init(0);
+  if (sequence) sequence();
+  display.hibernate();
+  trace.detach(display.epd2);
+  if (!out.close())
+  {
+    fprintf(stderr, "write error on %s\n", argv[2]);
+    return 1;
+  }
+  GxEPD2_HostFile in(argv[2], "rb");
+  GxEPD2_SpiTraceReader reader(in);
+  GxEPD2_SpiTraceSummary* summary = new GxEPD2_SpiTraceSummary();
+  bool valid = summary->add(reader);
+  Serial.println("trace,events,commands,data_bytes,transactions,busy_waits,busy_us,resets,redundant_commands");
+  summary->print(Serial, argv[1]);
+  delete summary;
+  if (!valid) fprintf(stderr, "trace %s invalid\n", argv[2]);
+  return valid ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI trace replay, on the host: sends a trace file recorded with all data through GxEPD2_replaySpiTrace()
+// to a GxEPD2_290_BN8 without bus, records what the replay sends, and checks that it is the trace again.
+// This verifies the trace format, the reader and the replay path of GxEPD2_EPD; on a board the same replay drives the panel.
+// Exit status 1 if the trace is not replayable or the replay differs.
+//
+// usage: GxEPD2_SpiTraceReplay <trace file> [replayed trace file]
+//
+// build in this directory, on Linux or macOS (one command line):
+//   g++ -std=gnu++11 -Wall -DGxEPD2_HOST_VIRTUAL_TIME=1 -I. -I../../../src GxEPD2_SpiTraceReplay.cpp Arduino.cpp
+//     ../../../src/GxEPD2_EPD.cpp ../../../src/epd/GxEPD2_290_BN8.cpp -o GxEPD2_SpiTraceReplay
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BW.h>
+#include <GxEPD2_SpiTrace.h>
+#include "GxEPD2_HostFile.h"
+#include <vector>
+
+// same pins as GxEPD2_SpiTraceRecord, the replay of a reset depends on RST
+GxEPD2_290_BN8 epd(/*CS=*/ 10, /*DC=*/ 8, /*RST=*/ 9, /*BUSY=*/ -1, SPI);
+
+bool load(const char* path, std::vector<uint8_t>& bytes)
+{
+  GxEPD2_HostFile in(path, "rb");
+  if (!in) return false;
+  for (int c; (c = in.read()) >= 0;) bytes.push_back(c);
+  return true;
+}
+
+// collects the replayed trace in RAM
+class TraceBytes : public Print
+{
+  public:
+    std::vector<uint8_t> bytes;
+    size_t write(uint8_t b)
+    {
+      bytes.push_back(b);
+      return 1;
+    }
+};
+
+int main(int argc, char** argv)
+{
+  if ((argc < 2) || (argc > 3))
+  {
+    fprintf(stderr, "usage: %s <trace file> [replayed trace file]\n", argv[0]);
+    return 2;
+  }
+  std::vector<uint8_t> trace;
+  if (!load(argv[1], trace) || trace.empty())
+  {
+    fprintf(stderr, "can't read %s\n", argv[1]);
+    return 1;
+  }
+  GxEPD2_SpiTraceReader reader(&trace[0], trace.size());
+  if (!reader.valid() || !reader.allData())
+  {
+    fprintf(stderr, "%s is not replayable, record it with all data\n", argv[1]);
+    return 1;
+  }
+  epd.init(0);
+  TraceBytes replayed;
+  GxEPD2_SpiTrace recorder(replayed, true);
+  recorder.attach(epd);
+  bool ok = GxEPD2_replaySpiTrace(reader, epd);
+  recorder.detach(epd);
+  if (argc > 2)
+  {
+    GxEPD2_HostFile out(argv[2], "wb");
+    if (!replayed.bytes.empty()) out.write(&replayed.bytes[0], replayed.bytes.size());
+    if (!out.close()) fprintf(stderr, "write error on %s\n", argv[2]);
+  }
+  GxEPD2_SpiTraceSummary* a = new GxEPD2_SpiTraceSummary();
+  GxEPD2_SpiTraceSummary* b = new GxEPD2_SpiTraceSummary();
+  GxEPD2_SpiTraceReader reader_a(&trace[0], trace.size());
+  GxEPD2_SpiTraceReader reader_b(&replayed.bytes[0], replayed.bytes.size());
+  ok = a->add(reader_a) && b->add(reader_b) && ok;
+  GxEPD2_SpiTraceSummary::compare(Serial, *a, *b);
+  delete a;
+  delete b;
+  bool same = ok && (replayed.bytes == trace);
+  Serial.println(!ok ? "replay failed" : same ? "replay identical" : "replay differs");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: SPI.h without a bus; transfers are dropped, reads return the byte sent.
+// The host programs observe the drivers through the SPI monitor of GxEPD2_EPD.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HostTests_SPI_H_
+#define _GxEPD2_HostTests_SPI_H_
+
+#include <Arduino.h>
+
+#define MSBFIRST 1
+#define SPI_MODE0 0
+
+class SPISettings
+{
+  public:
+    SPISettings(uint32_t clock = 4000000, uint8_t bit_order = MSBFIRST, uint8_t data_mode = SPI_MODE0)
+    {
+      (void) clock;
+      (void) bit_order;
+      (void) data_mode;
+    }
+};
+
+class SPIClass
+{
+  public:
+    void begin() {};
+    void begin(int8_t sck, int8_t miso, int8_t mosi, int8_t ss)
+    {
+      (void) sck;
+      (void) miso;
+      (void) mosi;
+      (void) ss;
+    };
+    void end() {};
+    void beginTransaction(SPISettings settings)
+    {
+      (void) settings;
+    };
+    void endTransaction() {};
+    uint8_t transfer(uint8_t data)
+    {
+      return data;
+    };
+    void transfer(void* buffer, size_t count)
+    {
+      (void) buffer;
+      (void) count;
+    };
+};
+
+extern SPIClass SPI; // defined in Arduino.cpp
+
+#endif
@@ -0,0 +1,17 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Host tests: GxEPD2_EPD.cpp includes avr/pgmspace.h; PROGMEM and pgm_read_byte() are in Arduino.h of this directory.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HostTests_pgmspace_H_
+#define _GxEPD2_HostTests_pgmspace_H_
+
+#include <Arduino.h>
+
+#endif
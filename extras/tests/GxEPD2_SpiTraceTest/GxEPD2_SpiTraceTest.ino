@@ -0,0 +1,116 @@
+// Display Library example for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI trace test: records the command and data stream of two update sequences, prints their summaries and the difference,
+// e.g. to verify that a change removed wire traffic, or to find redundant commands of a driver.
+// Optionally dumps the traces as hex lines, and replays the first trace (recorded with all data) to the panel.
+//
+// Needs ENABLE_GxEPD2_SPI_MONITOR (default, except AVR).
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <GxEPD2_BW.h>
+#include <GxEPD2_SpiTrace.h>
+
+// adapt to your panel and wiring, see GxEPD2_wiring_examples.h
+#if defined(ESP32)
+GxEPD2_BW<GxEPD2_290_BN8, GxEPD2_290_BN8::HEIGHT> display(GxEPD2_290_BN8(/*CS=5*/ SS, /*DC=*/ 17, /*RST=*/ 16, /*BUSY=*/ 4, SPI));
+#else
+GxEPD2_BW<GxEPD2_290_BN8, GxEPD2_290_BN8::HEIGHT> display(GxEPD2_290_BN8(/*CS=D8*/ SS, /*DC=D3*/ 0, /*RST=D4*/ 2, /*BUSY=D2*/ 4, SPI));
+#endif
+
+const bool dump_traces = false;
+const bool replay_first = false;
+
+const uint32_t trace_size = 16384;
+uint8_t* trace_a;
+uint8_t* trace_b;
+
+void sequence_full()
+{
+  display.setFullWindow();
+  display.fillScreen(GxEPD_WHITE);
+  display.fillRect(10, 10, 50, 50, GxEPD_BLACK);
+  display.display(false);
+}
+
+void sequence_partial()
+{
+  display.fillRect(10, 70, 50, 20, GxEPD_BLACK);
+  display.displayWindow(0, 64, 64, 32);
+  display.fillRect(10, 70, 50, 20, GxEPD_WHITE);
+  display.displayWindow(0, 64, 64, 32);
+}
+
+uint32_t record(uint8_t* buffer, void (*sequence)(), bool all_data)
+{
+  GxEPD2_SpiTraceBuffer sink(buffer, trace_size);
+  GxEPD2_SpiTrace trace(sink, all_data);
+  trace.attach(display.epd2);
+  sequence();
+  trace.detach(display.epd2);
+  if (sink.overflow()) Serial.println("trace buffer overflow");
+  return sink.length();
+}
+
+void dump(const char* name, const uint8_t* trace, uint32_t length)
+{
+  for (uint32_t i = 0; i < length; i++)
+  {
+    if (i % 32 == 0)
+    {
+      Serial.println();
+      Serial.print(name);
+      Serial.print(",");
+    }
+    if (trace[i] < 0x10) Serial.print("0");
+    Serial.print(trace[i], HEX);
+  }
+  Serial.println();
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  Serial.println();
+  Serial.println("setup");
+  trace_a = (uint8_t*) malloc(trace_size);
+  trace_b = (uint8_t*) malloc(trace_size);
+  if (!trace_a || !trace_b)
+  {
+    Serial.println("not enough RAM for traces");
+    return;
+  }
+  display.init(0);
+  uint32_t length_a = record(trace_a, sequence_full, replay_first);
+  uint32_t length_b = record(trace_b, sequence_partial, false);
+  GxEPD2_SpiTraceSummary* a = new GxEPD2_SpiTraceSummary();
+  GxEPD2_SpiTraceSummary* b = new GxEPD2_SpiTraceSummary();
+  GxEPD2_SpiTraceReader reader_a(trace_a, length_a);
+  GxEPD2_SpiTraceReader reader_b(trace_b, length_b);
+  if (!a->add(reader_a)) Serial.println("trace a invalid");
+  if (!b->add(reader_b)) Serial.println("trace b invalid");
+  GxEPD2_SpiTraceSummary::compare(Serial, *a, *b);
+  delete a;
+  delete b;
+  if (dump_traces)
+  {
+    dump("a", trace_a, length_a);
+    dump("b", trace_b, length_b);
+  }
+  if (replay_first)
+  {
+    GxEPD2_SpiTraceReader replay(trace_a, length_a);
+    Serial.println(GxEPD2_replaySpiTrace(replay, display.epd2) ? "replay done" : "replay failed");
+  }
+  display.hibernate();
+  Serial.println("setup done");
+}
+
+void loop()
+{
+}
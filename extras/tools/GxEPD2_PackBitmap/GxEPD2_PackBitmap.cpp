@@ -0,0 +1,390 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+//
+// GxEPD2_PackBitmap: host tool, packs a bitmap for GxEPD2_PackedBitmap, or codes it for GxEPD2_G4Decoder,
+// output is a C header with a PROGMEM array, or binary, e.g. for SPIFFS, SD or an HTTP server.
+//
+// build: g++ -O2 -o GxEPD2_PackBitmap GxEPD2_PackBitmap.cpp
+// usage: GxEPD2_PackBitmap [-c | -g] [-b] [-n name] input.bmp > output.h
+//        GxEPD2_PackBitmap [-g] [-b] [-n name] -r width height input.raw > output.h
+//   input.bmp : uncompressed BMP of 1, 4, 8, 24 or 32 bits per pixel; light pixels are white, dark pixels black
+//   -c        : two planes, red pixels go to the color plane (for 3-color panels)
+//   -g        : CCITT Group 4 (T.6) coded, one plane, for GxEPD2_G4Decoder; best for text and line art
+//   -b        : binary output, the packed or coded image with header, instead of a C header
+//   -r        : raw 1bpp rows, padded to bytes, as the bundled bitmaps (bit 1 white), e.g. a bitmap array saved as binary
+//   -n name   : name of the array, default: the input file name
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+typedef std::vector<uint8_t> Bytes;
+
+static uint32_t get(const Bytes& b, size_t i, int n)
+{
+  uint32_t v = 0;
+  for (int k = n - 1; k >= 0; k--) v = (v << 8) | b.at(i + k);
+  return v;
+}
+
+static bool readFile(const char* name, Bytes& bytes)
+{
+  FILE* f = fopen(name, "rb");
+  if (!f) return false;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) bytes.insert(bytes.end(), buffer, buffer + n);
+  fclose(f);
+  return true;
+}
+
+// fills black and color planes, bit 1 white, 0 black or color
+static bool decodeBMP(const Bytes& bmp, bool with_color, uint16_t& w, uint16_t& h, Bytes& black, Bytes& color)
+{
+  if ((bmp.size() < 54) || (bmp[0] != 'B') || (bmp[1] != 'M')) return false;
+  uint32_t offset = get(bmp, 10, 4);
+  int32_t width = int32_t(get(bmp, 18, 4));
+  int32_t height = int32_t(get(bmp, 22, 4));
+  uint16_t depth = get(bmp, 28, 2);
+  uint32_t compression = get(bmp, 30, 4);
+  uint32_t colors = get(bmp, 46, 4);
+  bool flip = height > 0; // bottom up
+  if (height < 0) height = -height;
+  if ((width <= 0) || (width > 65535) || (height > 65535) || (compression != 0)) return false;
+  if ((depth != 1) && (depth != 4) && (depth != 8) && (depth != 24) && (depth != 32)) return false;
+  if ((depth <= 8) && (colors == 0)) colors = 1 << depth;
+  size_t palette = 14 + get(bmp, 14, 4);
+  w = width;
+  h = height;
+  uint32_t wb = (w + 7) / 8;
+  uint32_t row_size = (uint32_t(width) * depth + 31) / 32 * 4;
+  black.assign(wb * h, 0xFF);
+  color.assign(with_color ? wb * h : 0, 0xFF);
+  for (uint32_t row = 0; row < h; row++)
+  {
+    size_t line = offset + size_t(flip ? h - 1 - row : row) * row_size;
+    for (uint32_t col = 0; col < w; col++)
+    {
+      uint8_t r, g, b;
+      if (depth <= 8)
+      {
+        uint32_t bit = col * depth;
+        uint8_t index = (bmp.at(line + bit / 8) >> (8 - depth - bit % 8)) & ((1 << depth) - 1);
+        if (index >= colors) return false;
+        b = bmp.at(palette + 4 * index);
+        g = bmp.at(palette + 4 * index + 1);
+        r = bmp.at(palette + 4 * index + 2);
+      }
+      else
+      {
+        size_t p = line + col * (depth / 8);
+        b = bmp.at(p);
+        g = bmp.at(p + 1);
+        r = bmp.at(p + 2);
+      }
+      uint8_t mask = 0x80 >> (col % 8);
+      size_t i = row * wb + col / 8;
+      if (with_color && (r >= 128) && (g < 128) && (b < 128)) color[i] &= ~mask;
+      else if ((r * 299 + g * 587 + b * 114) / 1000 < 128) black[i] &= ~mask;
+    }
+  }
+  return true;
+}
+
+// run length codes, see GxEPD2_PackedBitmap.h
+static void pack(const Bytes& in, Bytes& out)
+{
+  size_t i = 0, literal = 0; // start of pending literal bytes is i - literal
+  while (i <= in.size())
+  {
+    size_t run = 1;
+    while ((i + run < in.size()) && (in[i + run] == in[i]) && (run < 16449)) run++;
+    bool end = (i == in.size());
+    if (end || (run >= 3) || ((run == 2) && (literal == 0)) || (literal == 128))
+    {
+      if (literal > 0)
+      {
+        out.push_back(uint8_t(literal - 1));
+        out.insert(out.end(), in.begin() + (i - literal), in.begin() + i);
+        literal = 0;
+      }
+      if (end) break;
+      if (run >= 2)
+      {
+        if (run <= 65) out.push_back(uint8_t(0x80 | (run - 2)));
+        else
+        {
+          out.push_back(uint8_t(0xC0 | ((run - 66) >> 8)));
+          out.push_back(uint8_t((run - 66) & 0xFF));
+        }
+        out.push_back(in[i]);
+        i += run;
+        continue;
+      }
+    }
+    literal++;
+    i++;
+  }
+}
+
+// T.4 run length codes: code, length; terminating codes for runs 0..63, makeup codes for runs 64..1728 by run / 64 - 1
+struct Code
+{
+  uint16_t code;
+  uint8_t length;
+};
+
+static const Code white_terminating[64] =
+{
+  {0x35, 8}, {0x7, 6}, {0x7, 4}, {0x8, 4}, {0xB, 4}, {0xC, 4}, {0xE, 4}, {0xF, 4},
+  {0x13, 5}, {0x14, 5}, {0x7, 5}, {0x8, 5}, {0x8, 6}, {0x3, 6}, {0x34, 6}, {0x35, 6},
+  {0x2A, 6}, {0x2B, 6}, {0x27, 7}, {0xC, 7}, {0x8, 7}, {0x17, 7}, {0x3, 7}, {0x4, 7},
+  {0x28, 7}, {0x2B, 7}, {0x13, 7}, {0x24, 7}, {0x18, 7}, {0x2, 8}, {0x3, 8}, {0x1A, 8},
+  {0x1B, 8}, {0x12, 8}, {0x13, 8}, {0x14, 8}, {0x15, 8}, {0x16, 8}, {0x17, 8}, {0x28, 8},
+  {0x29, 8}, {0x2A, 8}, {0x2B, 8}, {0x2C, 8}, {0x2D, 8}, {0x4, 8}, {0x5, 8}, {0xA, 8},
+  {0xB, 8}, {0x52, 8}, {0x53, 8}, {0x54, 8}, {0x55, 8}, {0x24, 8}, {0x25, 8}, {0x58, 8},
+  {0x59, 8}, {0x5A, 8}, {0x5B, 8}, {0x4A, 8}, {0x4B, 8}, {0x32, 8}, {0x33, 8}, {0x34, 8}
+};
+
+static const Code white_makeup[27] =
+{
+  {0x1B, 5}, {0x12, 5}, {0x17, 6}, {0x37, 7}, {0x36, 8}, {0x37, 8}, {0x64, 8}, {0x65, 8},
+  {0x68, 8}, {0x67, 8}, {0xCC, 9}, {0xCD, 9}, {0xD2, 9}, {0xD3, 9}, {0xD4, 9}, {0xD5, 9},
+  {0xD6, 9}, {0xD7, 9}, {0xD8, 9}, {0xD9, 9}, {0xDA, 9}, {0xDB, 9}, {0x98, 9}, {0x99, 9},
+  {0x9A, 9}, {0x18, 6}, {0x9B, 9}
+};
+
+static const Code black_terminating[64] =
+{
+  {0x37, 10}, {0x2, 3}, {0x3, 2}, {0x2, 2}, {0x3, 3}, {0x3, 4}, {0x2, 4}, {0x3, 5},
+  {0x5, 6}, {0x4, 6}, {0x4, 7}, {0x5, 7}, {0x7, 7}, {0x4, 8}, {0x7, 8}, {0x18, 9},
+  {0x17, 10}, {0x18, 10}, {0x8, 10}, {0x67, 11}, {0x68, 11}, {0x6C, 11}, {0x37, 11}, {0x28, 11},
+  {0x17, 11}, {0x18, 11}, {0xCA, 12}, {0xCB, 12}, {0xCC, 12}, {0xCD, 12}, {0x68, 12}, {0x69, 12},
+  {0x6A, 12}, {0x6B, 12}, {0xD2, 12}, {0xD3, 12}, {0xD4, 12}, {0xD5, 12}, {0xD6, 12}, {0xD7, 12},
+  {0x6C, 12}, {0x6D, 12}, {0xDA, 12}, {0xDB, 12}, {0x54, 12}, {0x55, 12}, {0x56, 12}, {0x57, 12},
+  {0x64, 12}, {0x65, 12}, {0x52, 12}, {0x53, 12}, {0x24, 12}, {0x37, 12}, {0x38, 12}, {0x27, 12},
+  {0x28, 12}, {0x58, 12}, {0x59, 12}, {0x2B, 12}, {0x2C, 12}, {0x5A, 12}, {0x66, 12}, {0x67, 12}
+};
+
+static const Code black_makeup[27] =
+{
+  {0xF, 10}, {0xC8, 12}, {0xC9, 12}, {0x5B, 12}, {0x33, 12}, {0x34, 12}, {0x35, 12}, {0x6C, 13},
+  {0x6D, 13}, {0x4A, 13}, {0x4B, 13}, {0x4C, 13}, {0x4D, 13}, {0x72, 13}, {0x73, 13}, {0x74, 13},
+  {0x75, 13}, {0x76, 13}, {0x77, 13}, {0x52, 13}, {0x53, 13}, {0x54, 13}, {0x55, 13}, {0x5A, 13},
+  {0x5B, 13}, {0x64, 13}, {0x65, 13}
+};
+
+// makeup codes of both colors for runs 1792..2560, by (run - 1792) / 64
+static const Code extended_makeup[13] =
+{
+  {0x8, 11}, {0xC, 11}, {0xD, 11}, {0x12, 12}, {0x13, 12}, {0x14, 12}, {0x15, 12}, {0x16, 12},
+  {0x17, 12}, {0x1C, 12}, {0x1D, 12}, {0x1E, 12}, {0x1F, 12}
+};
+
+class BitWriter
+{
+  public:
+    BitWriter(Bytes& out) : _out(out), _bits(0), _n(0) {}
+    void put(uint16_t code, uint8_t length)
+    {
+      _bits = (_bits << length) | code;
+      _n += length;
+      while (_n >= 8)
+      {
+        _n -= 8;
+        _out.push_back(uint8_t(_bits >> _n));
+      }
+    }
+    void put(const Code& c)
+    {
+      put(c.code, c.length);
+    }
+    void flush()
+    {
+      if (_n > 0) _out.push_back(uint8_t(_bits << (8 - _n)));
+      _n = 0;
+    }
+  private:
+    Bytes& _out;
+    uint32_t _bits;
+    int _n;
+};
+
+static void putRun(BitWriter& bits, uint32_t run, bool black)
+{
+  while (run >= 2560 + 64)
+  {
+    bits.put(extended_makeup[12]);
+    run -= 2560;
+  }
+  if (run >= 1792) bits.put(extended_makeup[(run - 1792) / 64]);
+  else if (run >= 64) bits.put((black ? black_makeup : white_makeup)[run / 64 - 1]);
+  bits.put((black ? black_terminating : white_terminating)[run % 64]);
+}
+
+static bool isBlack(const uint8_t* row, uint32_t i)
+{
+  return !(row[i / 8] & (0x80 >> (i % 8)));
+}
+
+// first pixel after i with a color different from pixel i, pixel -1 is white; w if none
+static uint32_t changing(const uint8_t* row, int32_t i, uint32_t w)
+{
+  bool black = (i >= 0) && isBlack(row, i);
+  for (uint32_t k = i + 1; k < w; k++)
+  {
+    if (isBlack(row, k) != black) return k;
+  }
+  return w;
+}
+
+// T.6 coding of rows of (w + 7) / 8 bytes, bit 1 white, see GxEPD2_G4Decoder.h
+static void encodeG4(const Bytes& plane, uint16_t w, uint16_t h, Bytes& out)
+{
+  uint32_t wb = (w + 7) / 8;
+  Bytes white(wb, 0xFF);
+  BitWriter bits(out);
+  for (uint32_t y = 0; y < h; y++)
+  {
+    const uint8_t* ref = y > 0 ? &plane[(y - 1) * wb] : &white[0];
+    const uint8_t* cur = &plane[y * wb];
+    int32_t a0 = -1;
+    bool black = false;
+    while (a0 < int32_t(w))
+    {
+      uint32_t a1 = changing(cur, a0, w);
+      uint32_t b1 = changing(ref, a0, w);
+      if ((b1 < w) && (isBlack(ref, b1) == black)) b1 = changing(ref, b1, w);
+      uint32_t b2 = b1 < w ? changing(ref, b1, w) : w;
+      uint32_t start = a0 < 0 ? 0 : a0;
+      if (b2 < a1) // pass
+      {
+        bits.put(0x1, 4);
+        a0 = b2;
+      }
+      else if ((a1 + 3 >= b1) && (a1 <= b1 + 3)) // vertical
+      {
+        static const Code vertical[7] = {{0x2, 7}, {0x2, 6}, {0x2, 3}, {0x1, 1}, {0x3, 3}, {0x3, 6}, {0x3, 7}};
+        bits.put(vertical[a1 + 3 - b1]);
+        a0 = a1;
+        black = !black;
+      }
+      else // horizontal
+      {
+        uint32_t a2 = a1 < w ? changing(cur, a1, w) : w;
+        bits.put(0x1, 3);
+        putRun(bits, a1 - start, black);
+        putRun(bits, a2 - a1, !black);
+        a0 = a2;
+      }
+    }
+  }
+  bits.put(0x001, 12); // end of facsimile block
+  bits.put(0x001, 12);
+  bits.flush();
+}
+
+int main(int argc, char** argv)
+{
+  bool with_color = false, raw = false, g4 = false, binary = false;
+  uint16_t w = 0, h = 0;
+  std::string name;
+  int a = 1;
+  for (; a < argc - 1; a++)
+  {
+    if (!strcmp(argv[a], "-c")) with_color = true;
+    else if (!strcmp(argv[a], "-g")) g4 = true;
+    else if (!strcmp(argv[a], "-b")) binary = true;
+    else if (!strcmp(argv[a], "-n")) name = argv[++a];
+    else if (!strcmp(argv[a], "-r") && (a + 2 < argc - 1))
+    {
+      raw = true;
+      w = atoi(argv[++a]);
+      h = atoi(argv[++a]);
+    }
+    else break;
+  }
+  if ((a != argc - 1) || (with_color && g4))
+  {
+    fprintf(stderr, "usage: %s [-c | -g] [-b] [-n name] input.bmp | [-g] [-b] [-n name] -r width height input.raw\n", argv[0]);
+    return 1;
+  }
+  const char* input = argv[a];
+  Bytes file, black, color;
+  if (!readFile(input, file))
+  {
+    fprintf(stderr, "can't read %s\n", input);
+    return 1;
+  }
+  if (raw)
+  {
+    black = file;
+    if ((w == 0) || (h == 0) || (black.size() < size_t((w + 7) / 8) * h))
+    {
+      fprintf(stderr, "%s is too short for %u x %u\n", input, w, h);
+      return 1;
+    }
+    black.resize(size_t((w + 7) / 8) * h);
+  }
+  else if (!decodeBMP(file, with_color, w, h, black, color))
+  {
+    fprintf(stderr, "%s is not a supported BMP\n", input);
+    return 1;
+  }
+  if (name.empty())
+  {
+    name = input;
+    size_t slash = name.find_last_of("/\\");
+    if (slash != std::string::npos) name = name.substr(slash + 1);
+    name = name.substr(0, name.find('.'));
+    for (size_t k = 0; k < name.size(); k++) if (!isalnum((unsigned char)name[k])) name[k] = '_';
+    if (isdigit((unsigned char)name[0])) name = "_" + name;
+  }
+  Bytes out;
+  if (g4)
+  {
+    // limits of GxEPD2_G4Decoder::begin(), GxEPD2_G4_MAX_WIDTH is 400 on AVR, 1872 else
+    if (w > 1872) fprintf(stderr, "warning: width %u > 1872, rejected by GxEPD2_G4Decoder unless GxEPD2_G4_MAX_WIDTH is raised\n", w);
+    else if (w > 400) fprintf(stderr, "warning: width %u > 400, rejected by GxEPD2_G4Decoder on AVR\n", w);
+    if (h > 0x7FFF) fprintf(stderr, "warning: height %u > 32767, rejected by GxEPD2_G4Decoder\n", h);
+    const uint8_t header[] = {'G', '4', 0, 0, uint8_t(w), uint8_t(w >> 8), uint8_t(h), uint8_t(h >> 8)};
+    out.insert(out.end(), header, header + sizeof(header));
+    encodeG4(black, w, h, out);
+  }
+  else
+  {
+    Bytes plane0, plane1;
+    pack(black, plane0);
+    if (!color.empty()) pack(color, plane1);
+    const uint8_t header[] = {'G', 'P', uint8_t(color.empty() ? 0 : 1), 0, uint8_t(w), uint8_t(w >> 8), uint8_t(h), uint8_t(h >> 8),
+                              uint8_t(plane0.size()), uint8_t(plane0.size() >> 8), uint8_t(plane0.size() >> 16), uint8_t(plane0.size() >> 24)
+                             };
+    out.insert(out.end(), header, header + sizeof(header));
+    out.insert(out.end(), plane0.begin(), plane0.end());
+    out.insert(out.end(), plane1.begin(), plane1.end());
+  }
+  if (binary)
+  {
+    fwrite(&out[0], 1, out.size(), stdout);
+    return 0;
+  }
+  printf("// %s by GxEPD2_PackBitmap from %s, %u x %u, %u plane(s), %u bytes unpacked, %u bytes packed\n", g4 ? "G4 coded" : "packed",
+         input, w, h, color.empty() ? 1 : 2, unsigned(black.size() + color.size()), unsigned(out.size()));
+  printf("\n#if defined(ESP8266) || defined(ESP32)\n#include <pgmspace.h>\n#else\n#include <avr/pgmspace.h>\n#endif\n\n");
+  printf("const unsigned char %s[] PROGMEM = {\n", name.c_str());
+  for (size_t k = 0; k < out.size(); k++)
+  {
+    printf("0x%02X,%s", out[k], (k % 16 == 15) || (k == out.size() - 1) ? "\n" : "");
+  }
+  printf("};\n");
+  return 0;
+}
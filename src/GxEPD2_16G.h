@@ -0,0 +1,689 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// 16 grey levels template for the IT8951 controller panels (GxEPD2_it60, GxEPD2_it60_1448x1072).
+// Buffer of 4 bits per pixel (nibbles, first pixel in the high nibble), loaded unchanged with IT8951 4bpp image loads.
+// Refresh with the GC16 waveform, full screen or partial window.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_16G_H_
+#define _GxEPD2_16G_H_
+// uncomment next line to use class GFX of library GFX_Root instead of Adafruit_GFX
+//#include <GFX.h>
+
+#ifndef ENABLE_GxEPD2_GFX
+// default is off
+#define ENABLE_GxEPD2_GFX 0
+#endif
+
+#if ENABLE_GxEPD2_GFX
+#include "GxEPD2_GFX.h"
+#define GxEPD2_GFX_BASE_CLASS GxEPD2_GFX
+#elif defined(_GFX_H_)
+#define GxEPD2_GFX_BASE_CLASS GFX
+#else
+#include <Adafruit_GFX.h>
+#define GxEPD2_GFX_BASE_CLASS Adafruit_GFX
+#endif
+
+#include "GxEPD2_EPD.h"
+#include "it8951/GxEPD2_it60.h"
+#include "it8951/GxEPD2_it60_1448x1072.h"
+
+// luminance parts of the 565 color components, 0.299 R + 0.587 G + 0.114 B, sum 0..255
+static const uint8_t GxEPD2_16G_luminance_r[32] PROGMEM =
+{
+  0, 2, 5, 7, 10, 12, 15, 17, 20, 22, 25, 27, 30, 32, 34, 37,
+  39, 42, 44, 47, 49, 52, 54, 57, 59, 61, 64, 66, 69, 71, 74, 76
+};
+static const uint8_t GxEPD2_16G_luminance_g[64] PROGMEM =
+{
+  0, 2, 5, 7, 10, 12, 14, 17, 19, 21, 24, 26, 29, 31, 33, 36,
+  38, 40, 43, 45, 48, 50, 52, 55, 57, 59, 62, 64, 67, 69, 71, 74,
+  76, 78, 81, 83, 86, 88, 90, 93, 95, 97, 100, 102, 105, 107, 109, 112,
+  114, 116, 119, 121, 124, 126, 128, 131, 133, 135, 138, 140, 143, 145, 147, 150
+};
+static const uint8_t GxEPD2_16G_luminance_b[32] PROGMEM =
+{
+  0, 1, 2, 3, 4, 5, 6, 7, 8, 8, 9, 10, 11, 12, 13, 14,
+  15, 16, 17, 18, 19, 20, 21, 22, 23, 23, 24, 25, 26, 27, 28, 29
+};
+
+template<typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_16G : public GxEPD2_GFX_BASE_CLASS
+{
+  public:
+    GxEPD2_Type epd2;
+#if ENABLE_GxEPD2_GFX
+    GxEPD2_16G(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(epd2, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+#else
+    GxEPD2_16G(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+#endif
+    {
+      _page_height = page_height;
+      _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+      _mirror = false;
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    uint16_t pages()
+    {
+      return _pages;
+    }
+
+    uint16_t pageHeight()
+    {
+      return _page_height;
+    }
+
+    bool mirror(bool m)
+    {
+      _swap_ (_mirror, m);
+      return m;
+    }
+
+    // grey level 0 (black) .. 15 (white) of a 565 color, by luminance
+    static uint8_t greyLevel(uint16_t color)
+    {
+      uint16_t luminance = pgm_read_byte(&GxEPD2_16G_luminance_r[color >> 11]) + pgm_read_byte(&GxEPD2_16G_luminance_g[(color >> 5) & 0x3F])
+                           + pgm_read_byte(&GxEPD2_16G_luminance_b[color & 0x1F]);
+      return (luminance * 241 + 2048) >> 12; // * 15 / 255, rounded
+    }
+
+    // 565 color of grey level 0 (black) .. 15 (white), greyLevel(grey(level)) == level
+    static uint16_t grey(uint8_t level)
+    {
+      uint16_t rb = (uint16_t(level) * 31 + 7) / 15;
+      uint16_t g = (uint16_t(level) * 63 + 7) / 15;
+      return (rb << 11) | (g << 5) | rb;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+      if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+      if (_mirror) x = width() - x - 1;
+      // check rotation, move pixel around if necessary
+      switch (getRotation())
+      {
+        case 1:
+          _swap_(x, y);
+          x = WIDTH - x - 1;
+          break;
+        case 2:
+          x = WIDTH - x - 1;
+          y = HEIGHT - y - 1;
+          break;
+        case 3:
+          _swap_(x, y);
+          y = HEIGHT - y - 1;
+          break;
+      }
+      // transpose partial window to 0,0
+      x -= _pw_x;
+      y -= _pw_y;
+      // clip to (partial) window
+      if ((x < 0) || (x >= _pw_w) || (y < 0) || (y >= _pw_h)) return;
+      // adjust for current page
+      y -= _current_page * _page_height;
+      // check if in current page
+      if ((y < 0) || (y >= _page_height)) return;
+      uint8_t* p = _buffer + x / 2 + uint32_t(y) * (_pw_w / 2);
+      if (x & 1) *p = (*p & 0xF0) | greyLevel(color);
+      else *p = (*p & 0x0F) | (greyLevel(color) << 4);
+    }
+
+    // span kernel: rectangles are filled by rows of bytes in the buffer, in any rotation
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color)
+    {
+      int16_t x1 = gx_int16_max(x, 0), y1 = gx_int16_max(y, 0);
+      int16_t x2 = gx_int16_min(x + w, width()), y2 = gx_int16_min(y + h, height());
+      if ((x1 >= x2) || (y1 >= y2)) return;
+      uint16_t nx = x1, ny = y1, nw = x2 - x1, nh = y2 - y1;
+      if (_mirror) nx = width() - nx - nw;
+      _rotate(nx, ny, nw, nh);
+      // to (partial) window and current page
+      int16_t page_ys = _current_page * _page_height;
+      int16_t wx1 = gx_int16_max(int16_t(nx) - int16_t(_pw_x), 0);
+      int16_t wx2 = gx_int16_min(int16_t(nx + nw) - int16_t(_pw_x), _pw_w);
+      int16_t wy1 = gx_int16_max(int16_t(ny) - int16_t(_pw_y), page_ys);
+      int16_t wy2 = gx_int16_min(gx_int16_min(int16_t(ny + nh) - int16_t(_pw_y), _pw_h), page_ys + _page_height);
+      if ((wx1 >= wx2) || (wy1 >= wy2)) return;
+      uint8_t level = greyLevel(color);
+      for (int16_t row = wy1; row < wy2; row++)
+      {
+        _fillSpan(_buffer + uint32_t(row - page_ys) * (_pw_w / 2), wx1, wx2 - wx1, level);
+      }
+    }
+
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color)
+    {
+      fillRect(x, y, w, 1, color);
+    }
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color)
+    {
+      fillRect(x, y, 1, h, color);
+    }
+
+    // blit kernel: draws a bitmap of 4 bits per pixel (first pixel in the high nibble, 0 black .. 15 white) to the buffer
+    // rows are copied bytewise if not rotated, not mirrored and of the same nibble alignment, else pixel by pixel
+    void drawGreyBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, bool pgm = false)
+    {
+      int16_t wb = (w + 1) / 2; // width bytes, bitmaps are padded
+      if ((0 == getRotation()) && !_mirror)
+      {
+        int16_t page_ys = _current_page * _page_height;
+        int16_t wx1 = gx_int16_max(gx_int16_max(x, 0) - int16_t(_pw_x), 0);
+        int16_t wx2 = gx_int16_min(gx_int16_min(x + w, WIDTH) - int16_t(_pw_x), _pw_w);
+        int16_t wy1 = gx_int16_max(gx_int16_max(y, 0) - int16_t(_pw_y), page_ys);
+        int16_t wy2 = gx_int16_min(gx_int16_min(gx_int16_min(y + h, HEIGHT) - int16_t(_pw_y), _pw_h), page_ys + _page_height);
+        if ((wx1 >= wx2) || (wy1 >= wy2)) return;
+        int16_t sx = wx1 + _pw_x - x; // first source pixel
+        if (((sx ^ wx1) & 1) == 0)
+        {
+          for (int16_t row = wy1; row < wy2; row++)
+          {
+            _blitSpan(_buffer + uint32_t(row - page_ys) * (_pw_w / 2), wx1, bitmap + uint32_t(row + _pw_y - y) * wb, sx, wx2 - wx1, pgm);
+          }
+          return;
+        }
+      }
+      for (int16_t j = 0; j < h; j++)
+      {
+        for (int16_t i = 0; i < w; i++)
+        {
+          uint8_t data = _readByte(bitmap + uint32_t(j) * wb + i / 2, pgm);
+          drawPixel(x + i, y + j, grey(i & 1 ? data & 0x0F : data >> 4));
+        }
+      }
+    }
+
+    void init(uint32_t serial_diag_bitrate = 0) // = 0 : disabled
+    {
+      epd2.init(serial_diag_bitrate);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    // init method with additional parameters:
+    // initial false for re-init after processor deep sleep wake up, if display power supply was kept
+    // only relevant for b/w displays with fast partial update
+    // reset_duration = 20 is default; a value of 2 may help with "clever" reset circuit of newer boards from Waveshare
+    // pulldown_rst_mode true for alternate RST handling to avoid feeding 5V through RST pin
+    void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 20, bool pulldown_rst_mode = false)
+    {
+      epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    void fillScreen(uint16_t color) // grey level of color, to buffer
+    {
+      memset(_buffer, greyLevel(color) * 0x11, sizeof(_buffer));
+    }
+
+    // display buffer content to screen, useful for full screen buffer
+    // partial_update_mode true uses the fast b/w waveform (DU), for b/w content only
+    void display(bool partial_update_mode = false)
+    {
+      epd2.writeImage16G(_buffer, 0, 0, WIDTH, _page_height);
+      if (partial_update_mode) epd2.refresh(true);
+      else
+      {
+        epd2.refreshGrey(0, 0, WIDTH, HEIGHT);
+        epd2.powerOff();
+      }
+    }
+
+    // display part of buffer content to screen, useful for full screen buffer
+    // displayWindow, use parameters according to actual rotation.
+    // x and w should be multiple of 4, for rotation 0 or 2,
+    // y and h should be multiple of 4, for rotation 1 or 3,
+    // else window is increased as needed,
+    // this is an addressing limitation of the IT8951 4bpp image load
+    void displayWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      x = gx_uint16_min(x, width());
+      y = gx_uint16_min(y, height());
+      w = gx_uint16_min(w, width() - x);
+      h = gx_uint16_min(h, height() - y);
+      _rotate(x, y, w, h);
+      epd2.writeImagePart16G(_buffer, x, y, WIDTH, _page_height, x, y, w, h);
+      epd2.refreshGrey(x, y, w, h);
+    }
+
+    void setFullWindow()
+    {
+      _using_partial_mode = false;
+      _pw_x = 0;
+      _pw_y = 0;
+      _pw_w = WIDTH;
+      _pw_h = HEIGHT;
+    }
+
+    // setPartialWindow, use parameters according to actual rotation.
+    // x and w should be multiple of 4, for rotation 0 or 2,
+    // y and h should be multiple of 4, for rotation 1 or 3,
+    // else window is increased as needed,
+    // this is an addressing limitation of the IT8951 4bpp image load
+    void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      _pw_x = gx_uint16_min(x, width());
+      _pw_y = gx_uint16_min(y, height());
+      _pw_w = gx_uint16_min(w, width() - _pw_x);
+      _pw_h = gx_uint16_min(h, height() - _pw_y);
+      _rotate(_pw_x, _pw_y, _pw_w, _pw_h);
+      _using_partial_mode = true;
+      // make _pw_x, _pw_w multiple of 4
+      _pw_w += _pw_x % 4;
+      if (_pw_w % 4 > 0) _pw_w += 4 - _pw_w % 4;
+      _pw_x -= _pw_x % 4;
+    }
+
+    void firstPage()
+    {
+      fillScreen(GxEPD_WHITE);
+      _current_page = 0;
+    }
+
+    bool nextPage()
+    {
+      uint16_t page_ys = _current_page * _page_height;
+      if (_using_partial_mode)
+      {
+        uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
+        uint16_t dest_ys = _pw_y + page_ys; // transposed
+        uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, _pw_y + page_ye);
+        if (dest_ye > dest_ys)
+        {
+          epd2.writeImage16G(_buffer, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+        }
+        _current_page++;
+        if (_current_page == _pages)
+        {
+          _current_page = 0;
+          epd2.refreshGrey(_pw_x, _pw_y, _pw_w, _pw_h);
+          return false;
+        }
+      }
+      else // full update
+      {
+        epd2.writeImage16G(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+        _current_page++;
+        if (_current_page == _pages)
+        {
+          _current_page = 0;
+          epd2.refreshGrey(0, 0, WIDTH, HEIGHT);
+          epd2.powerOff();
+          return false;
+        }
+      }
+      fillScreen(GxEPD_WHITE);
+      return true;
+    }
+
+    // GxEPD style paged drawing; drawCallback() is called as many times as needed
+    void drawPaged(void (*drawCallback)(const void*), const void* pv)
+    {
+      for (_current_page = 0; _current_page < _pages; _current_page++)
+      {
+        uint16_t page_ys = _current_page * _page_height;
+        fillScreen(GxEPD_WHITE);
+        drawCallback(pv);
+        if (_using_partial_mode)
+        {
+          uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
+          uint16_t dest_ys = _pw_y + page_ys; // transposed
+          uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, _pw_y + page_ye);
+          if (dest_ye > dest_ys) epd2.writeImage16G(_buffer, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+        }
+        else epd2.writeImage16G(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+      }
+      _current_page = 0;
+      if (_using_partial_mode) epd2.refreshGrey(_pw_x, _pw_y, _pw_w, _pw_h);
+      else
+      {
+        epd2.refreshGrey(0, 0, WIDTH, HEIGHT);
+        epd2.powerOff();
+      }
+    }
+
+    // paged drawing of the full screen to a frame slot of the controller SDRAM, without screen refresh; see GxEPD2_it60::frame_slots
+    // drawCallback() is called as many times as needed; the partial window is ignored
+    void drawPagedToFrameSlot(uint8_t slot, void (*drawCallback)(const void*), const void* pv)
+    {
+      uint8_t selected = epd2.frameSlot();
+      epd2.selectFrameSlot(slot);
+      for (_current_page = 0; _current_page < _pages; _current_page++)
+      {
+        uint16_t page_ys = _current_page * _page_height;
+        fillScreen(GxEPD_WHITE);
+        drawCallback(pv);
+        epd2.writeImage16G(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+      }
+      _current_page = 0;
+      epd2.selectFrameSlot(selected);
+    }
+
+    // screen refresh from a frame slot, e.g. loaded with drawPagedToFrameSlot(); no data transfer
+    // partial_update_mode true uses the fast b/w waveform (DU), for b/w content only
+    void displayFrameSlot(uint8_t slot, bool partial_update_mode = false)
+    {
+      epd2.refreshFrameSlot(slot, partial_update_mode);
+      if (!partial_update_mode) epd2.powerOff();
+    }
+
+    // the part of the screen covered by the current page, in coordinates of the actual rotation;
+    // anything drawn outside of it is discarded, a picture loop may skip it, e.g. source rows of an image
+    void pageWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h)
+    {
+      uint16_t page_ys = gx_uint16_min(_current_page * _page_height, _pw_h);
+      uint16_t nx = _pw_x, ny = _pw_y + page_ys, nw = _pw_w, nh = gx_uint16_min(_page_height, _pw_h - page_ys);
+      _unrotate(nx, ny, nw, nh);
+      if (_mirror) nx = width() - nx - nw;
+      x = nx;
+      y = ny;
+      w = nw;
+      h = nh;
+    }
+
+    // bitmaps are drawn only where they intersect the current page, other rows of the bitmap are not read;
+    // the pixels of these rows are drawn by drawPixel()
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, false);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, false);
+    }
+    void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, true, false, true);
+    }
+
+    //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
+    void clearScreen(uint8_t value = 0xFF) // init controller memory and screen (default white)
+    {
+      epd2.clearScreen(value);
+    }
+    void writeScreenBuffer(uint8_t value = 0xFF) // init controller memory (default white)
+    {
+      epd2.writeScreenBuffer(value);
+    }
+    // write to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.writeImage(black, color, x, y, w, h, false, false, false);
+    }
+    void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+    }
+    // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write image pulled from source, by blocks of rows, to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(GxEPD2_ImageSource& source, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& source, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    void writeImage(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    // write native data pulled from data1 (and data2), 8 bits per pixel, to controller memory, without screen refresh
+    void writeNative(GxEPD2_ImageSource& data1, GxEPD2_ImageSource* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &data1, data2, 8, true, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    // write to controller memory, with screen refresh; x and w should be multiple of 8
+    void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.drawImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.drawImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.drawImage(black, color, x, y, w, h, false, false, false);
+    }
+    void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+    }
+    // write sprite of native data to controller memory, with screen refresh; x and w should be multiple of 8
+    void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write 4 bits per pixel bitmap to controller memory, without screen refresh; x and w should be multiple of 4
+    // 2 pixels per byte, first pixel in the high nibble; 0 black .. 15 white
+    void writeImage16G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage16G(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write 4 bits per pixel bitmap to controller memory, with screen refresh of its area with the grey waveform
+    void drawImage16G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage16G(bitmap, x, y, w, h, invert, mirror_y, pgm);
+      epd2.refreshGrey(x, y, w, h);
+    }
+    void refresh(bool partial_update_mode = false) // screen refresh from controller memory to full screen
+    {
+      epd2.refresh(partial_update_mode);
+      if (!partial_update_mode) epd2.powerOff();
+    }
+    void refresh(int16_t x, int16_t y, int16_t w, int16_t h) // screen refresh from controller memory, partial screen
+    {
+      epd2.refresh(x, y, w, h);
+    }
+    // turns off generation of panel driving voltages, avoids screen fading over time
+    void powerOff()
+    {
+      epd2.powerOff();
+    }
+    // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+    void hibernate()
+    {
+      epd2.hibernate();
+    }
+  private:
+    template <typename T> static inline void
+    _swap_(T & a, T & b)
+    {
+      T t = a;
+      a = b;
+      b = t;
+    };
+    static inline uint16_t gx_uint16_min(uint16_t a, uint16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline uint16_t gx_uint16_max(uint16_t a, uint16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    // set bits of the bitmap (cleared bits if invert) are drawn in color, the others in bg if opaque
+    void _drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg, bool invert, bool opaque, bool pgm)
+    {
+      int16_t px, py, pw, ph;
+      pageWindow(px, py, pw, ph);
+      // the part of the bitmap in the current page
+      int16_t i1 = gx_int16_max(px - x, 0), i2 = gx_int16_min(px + pw - x, w);
+      int16_t j1 = gx_int16_max(py - y, 0), j2 = gx_int16_min(py + ph - y, h);
+      if ((i1 >= i2) || (j1 >= j2)) return;
+      int16_t wb = (w + 7) / 8; // bitmap scanline pad = whole byte
+      uint8_t inv = invert ? 0xFF : 0x00;
+      for (int16_t j = j1; j < j2; j++)
+      {
+        for (int16_t i = i1; i < i2; i++)
+        {
+          uint8_t byte = _readByte(bitmap + uint32_t(j) * wb + i / 8, pgm) ^ inv;
+          if (byte & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+          else if (opaque) drawPixel(x + i, y + j, bg);
+        }
+      }
+    }
+    static inline int16_t gx_int16_min(int16_t a, int16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline int16_t gx_int16_max(int16_t a, int16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    static inline uint8_t _readByte(const uint8_t* p, bool pgm)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) return pgm_read_byte(p);
+#endif
+      return *p;
+    }
+    // fill w nibbles from nibble x of row with level
+    static void _fillSpan(uint8_t* row, int16_t x, int16_t w, uint8_t level)
+    {
+      uint8_t* p = row + x / 2;
+      if (x & 1)
+      {
+        *p = (*p & 0xF0) | level;
+        p++;
+        w--;
+      }
+      memset(p, level * 0x11, w / 2);
+      p += w / 2;
+      if (w & 1) *p = (*p & 0x0F) | (level << 4);
+    }
+    // copy w nibbles from nibble sx of src to nibble x of row, x and sx of same alignment
+    static void _blitSpan(uint8_t* row, int16_t x, const uint8_t* src, int16_t sx, int16_t w, bool pgm)
+    {
+      uint8_t* p = row + x / 2;
+      const uint8_t* s = src + sx / 2;
+      if (x & 1)
+      {
+        *p = (*p & 0xF0) | (_readByte(s++, pgm) & 0x0F);
+        p++;
+        w--;
+      }
+      int16_t n = w / 2;
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) memcpy_P(p, s, n);
+      else memcpy(p, s, n);
+#else
+      memcpy(p, s, n);
+#endif
+      p += n;
+      s += n;
+      if (w & 1) *p = (*p & 0x0F) | (_readByte(s, pgm) & 0xF0);
+    }
+    void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          _swap_(x, y);
+          _swap_(w, h);
+          x = WIDTH - x - w;
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          _swap_(x, y);
+          _swap_(w, h);
+          y = HEIGHT - y - h;
+          break;
+      }
+    }
+    // inverse of _rotate
+    void _unrotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          x = WIDTH - x - w;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          y = HEIGHT - y - h;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+      }
+    }
+  private:
+    uint8_t _buffer[(GxEPD2_Type::WIDTH / 2) * page_height];
+    bool _using_partial_mode, _mirror;
+    int16_t _current_page;
+    uint16_t _pages, _page_height;
+    uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+};
+
+#endif
@@ -0,0 +1,524 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Four grey levels template for b/w panels with two RAM planes and a custom grey waveform, e.g. SSD1680 (hasGreyLevels).
+// Packed buffer of 2 bits per pixel; the bit planes are split on transmit by the driver (writeImage4G).
+// Refresh is always full screen with the grey waveform; panels without grey waveform show the levels thresholded to b/w.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_4G_H_
+#define _GxEPD2_4G_H_
+// uncomment next line to use class GFX of library GFX_Root instead of Adafruit_GFX
+//#include <GFX.h>
+
+#ifndef ENABLE_GxEPD2_GFX
+// default is off
+#define ENABLE_GxEPD2_GFX 0
+#endif
+
+#if ENABLE_GxEPD2_GFX
+#include "GxEPD2_GFX.h"
+#define GxEPD2_GFX_BASE_CLASS GxEPD2_GFX
+#elif defined(_GFX_H_)
+#define GxEPD2_GFX_BASE_CLASS GFX
+#else
+#include <Adafruit_GFX.h>
+#define GxEPD2_GFX_BASE_CLASS Adafruit_GFX
+#endif
+
+#include "GxEPD2_EPD.h"
+#include "epd/GxEPD2_213_B74.h"
+#include "epd/GxEPD2_290_T94.h"
+#include "epd/GxEPD2_290_BN8.h"
+
+template<typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_4G : public GxEPD2_GFX_BASE_CLASS
+{
+  public:
+    GxEPD2_Type epd2;
+#if ENABLE_GxEPD2_GFX
+    GxEPD2_4G(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(epd2, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+#else
+    GxEPD2_4G(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+#endif
+    {
+      _page_height = page_height;
+      _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+      _mirror = false;
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    uint16_t pages()
+    {
+      return _pages;
+    }
+
+    uint16_t pageHeight()
+    {
+      return _page_height;
+    }
+
+    bool mirror(bool m)
+    {
+      _swap_ (_mirror, m);
+      return m;
+    }
+
+    // grey level 0 (black) .. 3 (white) of a 565 color, by luminance; GxEPD_DARKGREY is 1, GxEPD_LIGHTGREY is 2
+    static uint8_t greyLevel(uint16_t color)
+    {
+      switch (color)
+      {
+        case GxEPD_BLACK: return 0;
+        case GxEPD_DARKGREY: return 1;
+        case GxEPD_LIGHTGREY: return 2;
+        case GxEPD_WHITE: return 3;
+      }
+      uint16_t r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+      uint16_t luminance = (uint32_t(r) * 616 + uint32_t(g) * 600 + uint32_t(b) * 232) >> 8; // 0..250
+      return (luminance * 3 + 127) / 255;
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color)
+    {
+      if ((x < 0) || (x >= width()) || (y < 0) || (y >= height())) return;
+      if (_mirror) x = width() - x - 1;
+      // check rotation, move pixel around if necessary
+      switch (getRotation())
+      {
+        case 1:
+          _swap_(x, y);
+          x = WIDTH - x - 1;
+          break;
+        case 2:
+          x = WIDTH - x - 1;
+          y = HEIGHT - y - 1;
+          break;
+        case 3:
+          _swap_(x, y);
+          y = HEIGHT - y - 1;
+          break;
+      }
+      // transpose partial window to 0,0
+      x -= _pw_x;
+      y -= _pw_y;
+      // clip to (partial) window
+      if ((x < 0) || (x >= _pw_w) || (y < 0) || (y >= _pw_h)) return;
+      // adjust for current page
+      y -= _current_page * _page_height;
+      // check if in current page
+      if ((y < 0) || (y >= _page_height)) return;
+      uint16_t i = x / 4 + y * (_pw_w / 4);
+      uint8_t shift = 6 - 2 * (x % 4);
+      _buffer[i] = (_buffer[i] & (0xFF ^ (0x03 << shift))) | (greyLevel(color) << shift);
+    }
+
+    void init(uint32_t serial_diag_bitrate = 0) // = 0 : disabled
+    {
+      epd2.init(serial_diag_bitrate);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    // init method with additional parameters:
+    // initial false for re-init after processor deep sleep wake up, if display power supply was kept
+    // only relevant for b/w displays with fast partial update
+    // reset_duration = 20 is default; a value of 2 may help with "clever" reset circuit of newer boards from Waveshare
+    // pulldown_rst_mode true for alternate RST handling to avoid feeding 5V through RST pin
+    void init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset_duration = 20, bool pulldown_rst_mode = false)
+    {
+      epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
+      _using_partial_mode = false;
+      _current_page = 0;
+      setFullWindow();
+    }
+
+    void fillScreen(uint16_t color) // grey level of color, to buffer
+    {
+      uint8_t data = greyLevel(color) * 0x55;
+      for (uint16_t x = 0; x < sizeof(_buffer); x++)
+      {
+        _buffer[x] = data;
+      }
+    }
+
+    // display buffer content to screen, useful for full screen buffer
+    // always full refresh with the grey waveform, partial_update_mode is ignored
+    void display(bool partial_update_mode = false)
+    {
+      epd2.writeImage4G(_buffer, 0, 0, WIDTH, _page_height);
+      epd2.refresh4G();
+      epd2.powerOff();
+    }
+
+    // display part of buffer content to screen, useful for full screen buffer
+    // the grey waveform refreshes the full screen, the same as display()
+    void displayWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      display(false);
+    }
+
+    void setFullWindow()
+    {
+      _using_partial_mode = false;
+      _pw_x = 0;
+      _pw_y = 0;
+      _pw_w = WIDTH;
+      _pw_h = HEIGHT;
+    }
+
+    // setPartialWindow, use parameters according to actual rotation.
+    // x and w should be multiple of 8, for rotation 0 or 2,
+    // y and h should be multiple of 8, for rotation 1 or 3,
+    // else window is increased as needed,
+    // this is an addressing limitation of the e-paper controllers
+    // only the window is written to controller memory, refresh is full screen
+    void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      _pw_x = gx_uint16_min(x, width());
+      _pw_y = gx_uint16_min(y, height());
+      _pw_w = gx_uint16_min(w, width() - _pw_x);
+      _pw_h = gx_uint16_min(h, height() - _pw_y);
+      _rotate(_pw_x, _pw_y, _pw_w, _pw_h);
+      _using_partial_mode = true;
+      // make _pw_x, _pw_w multiple of 8
+      _pw_w += _pw_x % 8;
+      if (_pw_w % 8 > 0) _pw_w += 8 - _pw_w % 8;
+      _pw_x -= _pw_x % 8;
+    }
+
+    void firstPage()
+    {
+      fillScreen(GxEPD_WHITE);
+      _current_page = 0;
+    }
+
+    bool nextPage()
+    {
+      uint16_t page_ys = _current_page * _page_height;
+      if (_using_partial_mode)
+      {
+        uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
+        uint16_t dest_ys = _pw_y + page_ys; // transposed
+        uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, _pw_y + page_ye);
+        if (dest_ye > dest_ys)
+        {
+          epd2.writeImage4G(_buffer, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+        }
+      }
+      else // full update
+      {
+        epd2.writeImage4G(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+      }
+      _current_page++;
+      if (_current_page == _pages)
+      {
+        _current_page = 0;
+        epd2.refresh4G();
+        epd2.powerOff();
+        return false;
+      }
+      fillScreen(GxEPD_WHITE);
+      return true;
+    }
+
+    // GxEPD style paged drawing; drawCallback() is called as many times as needed
+    void drawPaged(void (*drawCallback)(const void*), const void* pv)
+    {
+      for (_current_page = 0; _current_page < _pages; _current_page++)
+      {
+        uint16_t page_ys = _current_page * _page_height;
+        fillScreen(GxEPD_WHITE);
+        drawCallback(pv);
+        if (_using_partial_mode)
+        {
+          uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height : HEIGHT;
+          uint16_t dest_ys = _pw_y + page_ys; // transposed
+          uint16_t dest_ye = gx_uint16_min(_pw_y + _pw_h, _pw_y + page_ye);
+          if (dest_ye > dest_ys) epd2.writeImage4G(_buffer, _pw_x, dest_ys, _pw_w, dest_ye - dest_ys);
+        }
+        else epd2.writeImage4G(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
+      }
+      epd2.refresh4G();
+      epd2.powerOff();
+      _current_page = 0;
+    }
+
+    // the part of the screen covered by the current page, in coordinates of the actual rotation;
+    // anything drawn outside of it is discarded, a picture loop may skip it, e.g. source rows of an image
+    void pageWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h)
+    {
+      uint16_t page_ys = gx_uint16_min(_current_page * _page_height, _pw_h);
+      uint16_t nx = _pw_x, ny = _pw_y + page_ys, nw = _pw_w, nh = gx_uint16_min(_page_height, _pw_h - page_ys);
+      _unrotate(nx, ny, nw, nh);
+      if (_mirror) nx = width() - nx - nw;
+      x = nx;
+      y = ny;
+      w = nw;
+      h = nh;
+    }
+
+    // bitmaps are drawn only where they intersect the current page, other rows of the bitmap are not read;
+    // the pixels of these rows are drawn by drawPixel()
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, false);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, false);
+    }
+    void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, true, false, true);
+    }
+
+    //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
+    void clearScreen(uint8_t value = 0xFF) // init controller memory and screen (default white)
+    {
+      epd2.clearScreen(value);
+    }
+    void writeScreenBuffer(uint8_t value = 0xFF) // init controller memory (default white)
+    {
+      epd2.writeScreenBuffer(value);
+    }
+    // write to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.writeImage(black, color, x, y, w, h, false, false, false);
+    }
+    void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+    }
+    // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.writeNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write image pulled from source, by blocks of rows, to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(GxEPD2_ImageSource& source, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& source, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    void writeImage(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    // write native data pulled from data1 (and data2), 1 bit per pixel, to controller memory, without screen refresh
+    void writeNative(GxEPD2_ImageSource& data1, GxEPD2_ImageSource* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &data1, data2, 1, true, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    // write to controller memory, with screen refresh; x and w should be multiple of 8
+    void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.drawImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.drawImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.drawImage(black, color, x, y, w, h, false, false, false);
+    }
+    void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                       int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+    }
+    // write sprite of native data to controller memory, with screen refresh; x and w should be multiple of 8
+    void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+    {
+      epd2.drawNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write 2 bits per pixel bitmap to controller memory, without screen refresh; x and w should be multiple of 8
+    // 4 pixels per byte, first pixel in the most significant bits; 0 black, 1 dark grey, 2 light grey, 3 white
+    void writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage4G(bitmap, x, y, w, h, invert, mirror_y, pgm);
+    }
+    // write 2 bits per pixel bitmap to controller memory, with full screen refresh with the grey waveform
+    void drawImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
+    {
+      epd2.writeImage4G(bitmap, x, y, w, h, invert, mirror_y, pgm);
+      epd2.refresh4G();
+      epd2.powerOff();
+    }
+    void refresh(bool partial_update_mode = false) // screen refresh from controller memory to full screen
+    {
+      epd2.refresh(partial_update_mode);
+      if (!partial_update_mode) epd2.powerOff();
+    }
+    void refresh(int16_t x, int16_t y, int16_t w, int16_t h) // screen refresh from controller memory, partial screen
+    {
+      epd2.refresh(x, y, w, h);
+    }
+    // turns off generation of panel driving voltages, avoids screen fading over time
+    void powerOff()
+    {
+      epd2.powerOff();
+    }
+    // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+    void hibernate()
+    {
+      epd2.hibernate();
+    }
+  private:
+    template <typename T> static inline void
+    _swap_(T & a, T & b)
+    {
+      T t = a;
+      a = b;
+      b = t;
+    };
+    static inline uint16_t gx_uint16_min(uint16_t a, uint16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline uint16_t gx_uint16_max(uint16_t a, uint16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    static inline int16_t gx_int16_min(int16_t a, int16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline int16_t gx_int16_max(int16_t a, int16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    static inline uint8_t _readByte(const uint8_t* p, bool pgm)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) return pgm_read_byte(p);
+#endif
+      return *p;
+    }
+    // set bits of the bitmap (cleared bits if invert) are drawn in color, the others in bg if opaque
+    void _drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg, bool invert, bool opaque, bool pgm)
+    {
+      int16_t px, py, pw, ph;
+      pageWindow(px, py, pw, ph);
+      // the part of the bitmap in the current page
+      int16_t i1 = gx_int16_max(px - x, 0), i2 = gx_int16_min(px + pw - x, w);
+      int16_t j1 = gx_int16_max(py - y, 0), j2 = gx_int16_min(py + ph - y, h);
+      if ((i1 >= i2) || (j1 >= j2)) return;
+      int16_t wb = (w + 7) / 8; // bitmap scanline pad = whole byte
+      uint8_t inv = invert ? 0xFF : 0x00;
+      for (int16_t j = j1; j < j2; j++)
+      {
+        for (int16_t i = i1; i < i2; i++)
+        {
+          uint8_t byte = _readByte(bitmap + uint32_t(j) * wb + i / 8, pgm) ^ inv;
+          if (byte & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+          else if (opaque) drawPixel(x + i, y + j, bg);
+        }
+      }
+    }
+    void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          _swap_(x, y);
+          _swap_(w, h);
+          x = WIDTH - x - w;
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          _swap_(x, y);
+          _swap_(w, h);
+          y = HEIGHT - y - h;
+          break;
+      }
+    }
+    // inverse of _rotate
+    void _unrotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          x = WIDTH - x - w;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          y = HEIGHT - y - h;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+      }
+    }
+  private:
+    uint8_t _buffer[(GxEPD2_Type::WIDTH / 4) * page_height];
+    bool _using_partial_mode, _mirror;
+    int16_t _current_page;
+    uint16_t _pages, _page_height;
+    uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+};
+
+#endif
@@ -297,30 +297,41 @@ class GxEPD2_7C : public GxEPD2_GFX_BASE_CLASS
       _current_page = 0;
     }
 
+    // the part of the screen covered by the current page, in coordinates of the actual rotation;
+    // anything drawn outside of it is discarded, a picture loop may skip it, e.g. source rows of an image
+    void pageWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h)
+    {
+      uint16_t page_ys = gx_uint16_min(_current_page * _page_height, _pw_h);
+      uint16_t nx = _pw_x, ny = _pw_y + page_ys, nw = _pw_w, nh = gx_uint16_min(_page_height, _pw_h - page_ys);
+      _unrotate(nx, ny, nw, nh);
+      if (_mirror) nx = width() - nx - nw;
+      x = nx;
+      y = ny;
+      w = nw;
+      h = nh;
+    }
+
+    // bitmaps are drawn only where they intersect the current page, other rows of the bitmap are not read;
+    // the pixels of these rows are drawn by drawPixel()
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, false);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, false);
+    }
     void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
     {
-      // taken from Adafruit_GFX.cpp, modified
-      int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-      uint8_t byte = 0;
-      for (int16_t j = 0; j < h; j++)
-      {
-        for (int16_t i = 0; i < w; i++ )
-        {
-          if (i & 7) byte <<= 1;
-          else
-          {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-            byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
-#else
-            byte = bitmap[j * byteWidth + i / 8];
-#endif
-          }
-          if (!(byte & 0x80))
-          {
-            drawPixel(x + i, y + j, color);
-          }
-        }
-      }
+      _drawBitmap(x, y, bitmap, w, h, color, color, true, false, true);
     }
 
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
@@ -365,6 +376,31 @@ class GxEPD2_7C : public GxEPD2_GFX_BASE_CLASS
     {
       epd2.writeNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
     }
+    // write image pulled from source, by blocks of rows, to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(GxEPD2_ImageSource& source, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& source, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    void writeImage(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
+    void writeImagePart(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+    }
+    // write native data pulled from data1 (and data2), 4 bits per pixel, to controller memory, without screen refresh
+    void writeNative(GxEPD2_ImageSource& data1, GxEPD2_ImageSource* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      if ((x == 0) && (y == 0) && (w == WIDTH) && (h == HEIGHT)) epd2.setPaged(); // for GxEPD2_565c paged workaround
+      GxEPD2_ImageSource::write(epd2, &data1, data2, 4, true, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+    }
     // write to controller memory, with screen refresh; x and w should be multiple of 8
     void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
     {
@@ -433,6 +469,42 @@ class GxEPD2_7C : public GxEPD2_GFX_BASE_CLASS
     {
       return (a > b ? a : b);
     };
+    static inline int16_t gx_int16_min(int16_t a, int16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline int16_t gx_int16_max(int16_t a, int16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    static inline uint8_t _readByte(const uint8_t* p, bool pgm)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) return pgm_read_byte(p);
+#endif
+      return *p;
+    }
+    // set bits of the bitmap (cleared bits if invert) are drawn in color, the others in bg if opaque
+    void _drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg, bool invert, bool opaque, bool pgm)
+    {
+      int16_t px, py, pw, ph;
+      pageWindow(px, py, pw, ph);
+      // the part of the bitmap in the current page
+      int16_t i1 = gx_int16_max(px - x, 0), i2 = gx_int16_min(px + pw - x, w);
+      int16_t j1 = gx_int16_max(py - y, 0), j2 = gx_int16_min(py + ph - y, h);
+      if ((i1 >= i2) || (j1 >= j2)) return;
+      int16_t wb = (w + 7) / 8; // bitmap scanline pad = whole byte
+      uint8_t inv = invert ? 0xFF : 0x00;
+      for (int16_t j = j1; j < j2; j++)
+      {
+        for (int16_t i = i1; i < i2; i++)
+        {
+          uint8_t byte = _readByte(bitmap + uint32_t(j) * wb + i / 8, pgm) ^ inv;
+          if (byte & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+          else if (opaque) drawPixel(x + i, y + j, bg);
+        }
+      }
+    }
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
     {
       switch (getRotation())
@@ -453,6 +525,27 @@ class GxEPD2_7C : public GxEPD2_GFX_BASE_CLASS
           break;
       }
     }
+    // inverse of _rotate
+    void _unrotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          x = WIDTH - x - w;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          y = HEIGHT - y - h;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+      }
+    }
     uint8_t color7(uint16_t color)
     {
       static uint16_t _prev_color = GxEPD_BLACK;
@@ -35,7 +35,40 @@
 #define GxEPD2_GFX_BASE_CLASS Adafruit_GFX
 #endif
 
+#ifndef ENABLE_GxEPD2_GHOSTING
+// default is on, except for AVR (RAM use: one byte per tile, see GxEPD2_Ghosting.h)
+#if defined(__AVR)
+#define ENABLE_GxEPD2_GHOSTING 0
+#else
+#define ENABLE_GxEPD2_GHOSTING 1
+#endif
+#endif
+
 #include "GxEPD2_EPD.h"
+#if ENABLE_GxEPD2_GHOSTING
+#include "GxEPD2_Ghosting.h"
+#endif
+
+#ifndef ENABLE_GxEPD2_FRAME_DIFF
+// default is off; if on, a full screen buffer (page_height == HEIGHT) keeps a copy of the last displayed frame
+#define ENABLE_GxEPD2_FRAME_DIFF 0
+#endif
+
+#ifndef ENABLE_GxEPD2_REFRESH_PLANNER
+// default is on, except for AVR (code size); the measured SPI cost per byte needs ENABLE_GxEPD2_TIMING_PROFILE
+#if defined(__AVR)
+#define ENABLE_GxEPD2_REFRESH_PLANNER 0
+#else
+#define ENABLE_GxEPD2_REFRESH_PLANNER 1
+#endif
+#endif
+
+#if ENABLE_GxEPD2_FRAME_DIFF || ENABLE_GxEPD2_REFRESH_PLANNER
+#include "GxEPD2_FrameDiff.h"
+#endif
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+#include "GxEPD2_RefreshPlanner.h"
+#endif
 #include "epd/GxEPD2_154.h"
 #include "epd/GxEPD2_154_D67.h"
 #include "epd/GxEPD2_154_T8.h"
@@ -83,6 +116,10 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
     GxEPD2_BW(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(epd2, GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
 #else
     GxEPD2_BW(GxEPD2_Type epd2_instance) : GxEPD2_GFX_BASE_CLASS(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT), epd2(epd2_instance)
+#endif
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+      , _planner(GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT, GxEPD2_Type::hasPartialUpdate, GxEPD2_Type::hasFastPartialUpdate,
+                 GxEPD2_Type::power_on_time, GxEPD2_Type::power_off_time, GxEPD2_Type::full_refresh_time, GxEPD2_Type::partial_refresh_time)
 #endif
     {
       _page_height = page_height;
@@ -91,6 +128,8 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       _mirror = false;
       _using_partial_mode = false;
       _current_page = 0;
+      _next_flips = 0xFFFFFFFF;
+      _dropFrame();
       setFullWindow();
     }
 
@@ -152,6 +191,8 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       epd2.init(serial_diag_bitrate);
       _using_partial_mode = false;
       _current_page = 0;
+      _fullRefreshed();
+      _dropFrame();
       setFullWindow();
     }
 
@@ -166,6 +207,8 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       epd2.init(serial_diag_bitrate, initial, reset_duration, pulldown_rst_mode);
       _using_partial_mode = false;
       _current_page = 0;
+      if (initial) _fullRefreshed(); // initial refresh will be full refresh
+      _dropFrame();
       setFullWindow();
     }
 
@@ -183,11 +226,15 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
     {
       if (partial_update_mode) epd2.writeImage(_buffer, 0, 0, WIDTH, _page_height);
       else epd2.writeImageForFullRefresh(_buffer, 0, 0, WIDTH, _page_height);
+      if (partial_update_mode) _accountFrameFlips();
       epd2.refresh(partial_update_mode);
+      if (partial_update_mode) _fastRefreshed(0, 0, WIDTH, HEIGHT);
+      else _fullRefreshed();
       if (epd2.hasFastPartialUpdate)
       {
         epd2.writeImageAgain(_buffer, 0, 0, WIDTH, _page_height);
       }
+      _keepFrame();
       if (!partial_update_mode) epd2.powerOff();
     }
 
@@ -204,13 +251,93 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       w = gx_uint16_min(w, width() - x);
       h = gx_uint16_min(h, height() - y);
       _rotate(x, y, w, h);
-      uint16_t y_part = _reverse ? HEIGHT - h - y : y;
-      epd2.writeImagePart(_buffer, x, y_part, WIDTH, _page_height, x, y, w, h);
-      epd2.refresh(x, y, w, h);
-      if (epd2.hasFastPartialUpdate)
+      _displayNativeWindow(x, y, w, h);
+    }
+
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+    // refresh planner: cost estimates from driver timing attributes, measured SPI cost and measured busy times
+    GxEPD2_RefreshPlanner& planner()
+    {
+      _updatePlanner();
+      return _planner;
+    }
+
+    // display changed rectangles of full screen buffer with the cheapest refresh: partial refresh of their bounding box,
+    // partial refresh of each rectangle, or full refresh; rectangles in native panel coordinates (rotation 0)
+    // a full refresh is also chosen if the ghosting budget asks for it
+    GxEPD2_RefreshPlanner::Plan displayPlanned(const GxEPD2_FrameDiff::Rect* rects, uint8_t count)
+    {
+      _next_flips = 0xFFFFFFFF;
+      _updatePlanner();
+      return _displayPlanned(_planner.plan(rects, count, _fullCleanupNeeded()), rects, count);
+    }
+#endif
+
+#if ENABLE_GxEPD2_FRAME_DIFF
+    // compare full screen buffer with the last displayed frame, word by word; native panel coordinates (rotation 0)
+    // result flipped is GxEPD2_FrameDiff::UNKNOWN if there is no last displayed frame, e.g. paged or after init
+    const GxEPD2_FrameDiff& diffFrame()
+    {
+      return _diffFrame(false);
+    }
+
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+    // display changes of full screen buffer against the last displayed frame with the cheapest refresh, see above
+    // nothing is done if the frame is identical (mode SKIP)
+    GxEPD2_RefreshPlanner::Plan displayPlanned()
+    {
+      _next_flips = 0xFFFFFFFF;
+      _updatePlanner();
+      const GxEPD2_FrameDiff& diff = _diffFrame(true);
+      if (diff.flipped == GxEPD2_FrameDiff::UNKNOWN)
       {
-        epd2.writeImagePartAgain(_buffer, x, y_part, WIDTH, _page_height, x, y, w, h);
+        GxEPD2_RefreshPlanner::Plan plan = _planner.plan(diff.rects, diff.count, _fullCleanupNeeded());
+        if (plan.mode == GxEPD2_RefreshPlanner::FULL) display(false);
+        else display(true);
+        return plan;
+      }
+      return _displayPlanned(_planner.plan(diff, _fullCleanupNeeded()), diff.rects, diff.count);
+    }
+
+    // display changes of full screen buffer, as displayPlanned()
+    // returns false if the frame is identical to the last displayed frame, no refresh done
+    bool displayChanged()
+    {
+      return displayPlanned().mode != GxEPD2_RefreshPlanner::SKIP;
+    }
+#endif
+#endif
+
+    // ghosting cleanup of a window, use parameters according to actual rotation, window is increased as for displayWindow
+    // uses the full waveform limited to the window, if supported by the controller (hasWindowedFullRefresh),
+    // else full refresh from controller memory; fast partial refreshes, e.g. through the inverse, don't clean up
+    void cleanupWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      x = gx_uint16_min(x, width());
+      y = gx_uint16_min(y, height());
+      w = gx_uint16_min(w, width() - x);
+      h = gx_uint16_min(h, height() - y);
+      _rotate(x, y, w, h);
+      // make x, w multiple of 8
+      w += x % 8;
+      if (w % 8 > 0) w += 8 - w % 8;
+      x -= x % 8;
+      if (GxEPD2_Type::hasWindowedFullRefresh)
+      {
+        epd2.refreshFull(x, y, w, h);
+        epd2.powerOff();
+      }
+      else
+      {
+        epd2.refresh(false);
+        epd2.powerOff();
+        _fullRefreshed();
+        return;
       }
+#if ENABLE_GxEPD2_GHOSTING
+      _ghosting.clear(x, y, w, h);
+#endif
+      _next_flips = 0xFFFFFFFF;
     }
 
     void setFullWindow()
@@ -258,6 +385,25 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       epd2.powerOff();
     }
 
+#if ENABLE_GxEPD2_TIMING_PROFILE
+    // expected busy time in us, measured, or from the driver timing attributes if not yet measured
+    // e.g. to sleep after an async full refresh instead of polling isBusy()
+    uint32_t expectedBusyTime(GxEPD2_TimingProfile::Operation op)
+    {
+      uint32_t fallback_ms = 0;
+      switch (op)
+      {
+        case GxEPD2_TimingProfile::POWER_ON: fallback_ms = GxEPD2_Type::power_on_time; break;
+        case GxEPD2_TimingProfile::POWER_OFF: fallback_ms = GxEPD2_Type::power_off_time; break;
+        case GxEPD2_TimingProfile::UPDATE_FULL: fallback_ms = GxEPD2_Type::full_refresh_time; break;
+        case GxEPD2_TimingProfile::UPDATE_PART: fallback_ms = GxEPD2_Type::partial_refresh_time; break;
+        case GxEPD2_TimingProfile::UPDATE_WINDOW: fallback_ms = GxEPD2_Type::full_refresh_time; break;
+        default: break;
+      }
+      return epd2.timingProfile().expected(op, fallback_ms * 1000);
+    }
+#endif
+
     bool nextPage()
     {
       if (1 == _pages)
@@ -267,16 +413,20 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
           uint32_t offset = _reverse ? (HEIGHT - _pw_h) * _pw_w / 8 : 0;
           epd2.writeImage(_buffer + offset, _pw_x, _pw_y, _pw_w, _pw_h);
           epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+          _fastRefreshed(_pw_x, _pw_y, _pw_w, _pw_h);
           if (epd2.hasFastPartialUpdate)
           {
             epd2.writeImageAgain(_buffer + offset, _pw_x, _pw_y, _pw_w, _pw_h);
             //epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h); // not needed
           }
+          _keepPartialWindow();
         }
         else // full update
         {
           epd2.writeImageForFullRefresh(_buffer, 0, 0, WIDTH, HEIGHT);
           epd2.refresh(false);
+          _fullRefreshed();
+          _keepFrame();
 #if defined(USE_EINK_DYNAMICDISPLAY)   // This macro defined in meshtastic/firmware
           // -- meshtastic: moved to endAsyncFull() --
 #else
@@ -319,6 +469,7 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
           if (!_second_phase)
           {
             epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+            _fastRefreshed(_pw_x, _pw_y, _pw_w, _pw_h);
             if (epd2.hasFastPartialUpdate)
             {
               _second_phase = true;
@@ -344,12 +495,18 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
             if (!_second_phase)
             {
               epd2.refresh(false); // full update after first phase
+              _fullRefreshed();
               _second_phase = true;
               fillScreen(GxEPD_WHITE);
               return true;
             }
             //else epd2.refresh(true); // partial update after second phase
-          } else epd2.refresh(false); // full update after only phase
+          }
+          else
+          {
+            epd2.refresh(false); // full update after only phase
+            _fullRefreshed();
+          }
           epd2.powerOff();
           return false;
         }
@@ -370,16 +527,20 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
           uint32_t offset = _reverse ? (HEIGHT - _pw_h) * _pw_w / 8 : 0;
           epd2.writeImage(_buffer + offset, _pw_x, _pw_y, _pw_w, _pw_h);
           epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+          _fastRefreshed(_pw_x, _pw_y, _pw_w, _pw_h);
           if (epd2.hasFastPartialUpdate)
           {
             epd2.writeImageAgain(_buffer + offset, _pw_x, _pw_y, _pw_w, _pw_h);
             //epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h); // not needed
           }
+          _keepPartialWindow();
         }
         else // full update
         {
           epd2.writeImageForFullRefresh(_buffer, 0, 0, WIDTH, HEIGHT);
           epd2.refresh(false);
+          _fullRefreshed();
+          _keepFrame();
           if (epd2.hasFastPartialUpdate)
           {
             epd2.writeImageAgain(_buffer, 0, 0, WIDTH, HEIGHT);
@@ -409,6 +570,7 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
             }
           }
           epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+          if (phase == 1) _fastRefreshed(_pw_x, _pw_y, _pw_w, _pw_h);
           if (!epd2.hasFastPartialUpdate) break;
           // else make both controller buffers have equal content
         }
@@ -423,6 +585,7 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
           epd2.writeImageForFullRefresh(_buffer, 0, page_ys, WIDTH, gx_uint16_min(_page_height, HEIGHT - page_ys));
         }
         epd2.refresh(false); // full update after first phase
+        _fullRefreshed();
         if (epd2.hasFastPartialUpdate)
         {
           // make both controller buffers have equal content
@@ -440,121 +603,202 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
       _current_page = 0;
     }
 
+    // the part of the screen covered by the current page, in coordinates of the actual rotation;
+    // anything drawn outside of it is discarded, a picture loop may skip it, e.g. source rows of an image
+    void pageWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h)
+    {
+      uint16_t page_ys = gx_uint16_min(_current_page * _page_height, _pw_h);
+      uint16_t nx = _pw_x, ny = _pw_y + page_ys, nw = _pw_w, nh = gx_uint16_min(_page_height, _pw_h - page_ys);
+      _unrotate(nx, ny, nw, nh);
+      if (_mirror) nx = width() - nx - nw;
+      x = nx;
+      y = ny;
+      w = nw;
+      h = nh;
+    }
+
+    // bitmaps are drawn only where they intersect the current page, other rows of the bitmap are not read;
+    // rows are blitted by byte shifts if not rotated and not mirrored, else drawn pixel by pixel
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, true);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, color, false, false, false);
+    }
+    void drawBitmap(int16_t x, int16_t y, uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg)
+    {
+      _drawBitmap(x, y, bitmap, w, h, color, bg, false, true, false);
+    }
     void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color)
     {
-      // taken from Adafruit_GFX.cpp, modified
-      int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-      uint8_t byte = 0;
-      for (int16_t j = 0; j < h; j++)
-      {
-        for (int16_t i = 0; i < w; i++ )
-        {
-          if (i & 7) byte <<= 1;
-          else
-          {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-            byte = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
-#else
-            byte = bitmap[j * byteWidth + i / 8];
-#endif
-          }
-          if (!(byte & 0x80))
-          {
-            drawPixel(x + i, y + j, color);
-          }
-        }
-      }
+      _drawBitmap(x, y, bitmap, w, h, color, color, true, false, true);
     }
 
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
     void clearScreen(uint8_t value = 0xFF) // init controller memory and screen (default white)
     {
       epd2.clearScreen(value);
+      _fillFrame(value);
     }
     void writeScreenBuffer(uint8_t value = 0xFF) // init controller memory (default white)
     {
       epd2.writeScreenBuffer(value);
+      _dropFrame();
     }
     // write to controller memory, without screen refresh; x and w should be multiple of 8
     void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
     {
       epd2.writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
     {
       epd2.writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.writeImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
     {
       epd2.writeImage(black, color, x, y, w, h, false, false, false);
+      _dropFrame();
     }
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void writeImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                         int16_t x, int16_t y, int16_t w, int16_t h)
     {
       epd2.writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+      _dropFrame();
     }
     // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
     void writeNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.writeNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
+    }
+    // write image pulled from source, by blocks of rows, to controller memory, without screen refresh; x and w should be multiple of 8
+    void writeImage(GxEPD2_ImageSource& source, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+      _dropFrame();
+    }
+    void writeImagePart(GxEPD2_ImageSource& source, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &source, 0, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+      _dropFrame();
+    }
+    void writeImage(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+      _dropFrame();
+    }
+    void writeImagePart(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &black, &color, 1, false, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y);
+      _dropFrame();
+    }
+    // write native data pulled from data1 (and data2), 1 bit per pixel, to controller memory, without screen refresh
+    void writeNative(GxEPD2_ImageSource& data1, GxEPD2_ImageSource* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false)
+    {
+      GxEPD2_ImageSource::write(epd2, &data1, data2, 1, true, 0, 0, w, h, x, y, w, h, invert, mirror_y);
+      _dropFrame();
     }
     // write to controller memory, with screen refresh; x and w should be multiple of 8
     void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
     {
       epd2.drawImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false)
     {
       epd2.drawImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.drawImage(black, color, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h)
     {
       epd2.drawImage(black, color, x, y, w, h, false, false, false);
+      _dropFrame();
     }
     void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                        int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                        int16_t x, int16_t y, int16_t w, int16_t h)
     {
       epd2.drawImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, false, false, false);
+      _dropFrame();
     }
     // write sprite of native data to controller memory, with screen refresh; x and w should be multiple of 8
     void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
     {
       epd2.drawNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
+      _dropFrame();
     }
     void refresh(bool partial_update_mode = false) // screen refresh from controller memory to full screen
     {
       epd2.refresh(partial_update_mode);
+      if (partial_update_mode) _fastRefreshed(0, 0, WIDTH, HEIGHT);
+      else _fullRefreshed();
       if (!partial_update_mode) epd2.powerOff();
     }
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h) // screen refresh from controller memory, partial screen
     {
       epd2.refresh(x, y, w, h);
+      if ((x >= 0) && (y >= 0) && (w > 0) && (h > 0)) _fastRefreshed(x, y, w, h);
     }
     // turns off generation of panel driving voltages, avoids screen fading over time
     void powerOff()
     {
       epd2.powerOff();
     }
+#if ENABLE_GxEPD2_GHOSTING
+    // ghosting budget: weighted count of fast partial refreshes per tile since last full refresh
+    // coordinates used by the budget itself are native panel coordinates (rotation 0)
+    GxEPD2_Ghosting& ghosting()
+    {
+      return _ghosting;
+    }
+    // number of pixels flipped by the next fast partial refresh, if known by the application;
+    // applies to the next refresh only, else a refresh counts as if all pixels in its window flipped
+    void setNextRefreshFlips(uint32_t flipped)
+    {
+      _next_flips = flipped;
+    }
+    // asks the ghosting policy if a cleanup refresh is needed, returns region according to actual rotation
+    // GxEPD2_Ghosting::FULL : do a full refresh, GxEPD2_Ghosting::REGION : cleanupWindow(x, y, w, h)
+    GxEPD2_Ghosting::Cleanup cleanupNeeded(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      GxEPD2_Ghosting::Cleanup cleanup = _ghosting.cleanupNeeded(x, y, w, h);
+      if (cleanup != GxEPD2_Ghosting::NONE) _unrotate(x, y, w, h);
+      return cleanup;
+    }
+#endif
     // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
     void hibernate()
     {
@@ -576,6 +820,290 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
     {
       return (a > b ? a : b);
     };
+    static inline int16_t gx_int16_min(int16_t a, int16_t b)
+    {
+      return (a < b ? a : b);
+    };
+    static inline int16_t gx_int16_max(int16_t a, int16_t b)
+    {
+      return (a > b ? a : b);
+    };
+    static inline uint8_t _readByte(const uint8_t* p, bool pgm)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) return pgm_read_byte(p);
+#endif
+      return *p;
+    }
+    // set bits of the bitmap (cleared bits if invert) are drawn in color, the others in bg if opaque
+    void _drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color, uint16_t bg, bool invert, bool opaque, bool pgm)
+    {
+      int16_t px, py, pw, ph;
+      pageWindow(px, py, pw, ph);
+      // the part of the bitmap in the current page
+      int16_t i1 = gx_int16_max(px - x, 0), i2 = gx_int16_min(px + pw - x, w);
+      int16_t j1 = gx_int16_max(py - y, 0), j2 = gx_int16_min(py + ph - y, h);
+      if ((i1 >= i2) || (j1 >= j2)) return;
+      int16_t wb = (w + 7) / 8; // bitmap scanline pad = whole byte
+      uint8_t inv = invert ? 0xFF : 0x00;
+      if ((0 == getRotation()) && !_mirror)
+      {
+        int16_t page_ys = _current_page * _page_height;
+        for (int16_t j = j1; j < j2; j++)
+        {
+          int16_t row = y + j - _pw_y - page_ys;
+          if (_reverse) row = _page_height - row - 1;
+          _blitBits(_buffer + uint32_t(row) * (_pw_w / 8), x + i1 - _pw_x, bitmap + uint32_t(j) * wb, i1, i2 - i1,
+                    inv, color ? 1 : 0, opaque ? (bg ? 1 : 0) : -1, pgm);
+        }
+        return;
+      }
+      for (int16_t j = j1; j < j2; j++)
+      {
+        for (int16_t i = i1; i < i2; i++)
+        {
+          uint8_t byte = _readByte(bitmap + uint32_t(j) * wb + i / 8, pgm) ^ inv;
+          if (byte & (0x80 >> (i & 7))) drawPixel(x + i, y + j, color);
+          else if (opaque) drawPixel(x + i, y + j, bg);
+        }
+      }
+    }
+    // blit kernel: bits sx .. sx + w - 1 of a bitmap row to bits x .. x + w - 1 of a buffer row, a byte at a time;
+    // set bits (after inv) become fg, cleared bits become bg, or are left as they are if bg < 0
+    static void _blitBits(uint8_t* row, int16_t x, const uint8_t* src, int16_t sx, int16_t w, uint8_t inv, int8_t fg, int8_t bg, bool pgm)
+    {
+      int16_t last = (sx + w - 1) / 8; // last source byte
+      for (int16_t k = x / 8; k <= (x + w - 1) / 8; k++)
+      {
+        int16_t b = 8 * k - x + sx; // source bit of the first bit of buffer byte k, > -8
+        uint8_t bits;
+        if (b < 0) bits = _readByte(src, pgm) >> -b;
+        else
+        {
+          bits = _readByte(src + b / 8, pgm) << (b & 7);
+          if ((b & 7) && (b / 8 < last)) bits |= _readByte(src + b / 8 + 1, pgm) >> (8 - (b & 7));
+        }
+        bits ^= inv;
+        uint8_t mask = 0xFF;
+        if (8 * k < x) mask >>= x - 8 * k;
+        if (8 * k + 8 > x + w) mask &= 0xFF << (8 * k + 8 - x - w);
+        uint8_t set = (fg ? bits : 0) | (bg > 0 ? ~bits : 0);
+        uint8_t clear = (fg ? 0 : bits) | (bg == 0 ? ~bits : 0);
+        row[k] = (row[k] | (set & mask)) & ~(clear & mask);
+      }
+    }
+    void _fastRefreshed(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+#if ENABLE_GxEPD2_GHOSTING
+      if (epd2.hasFastPartialUpdate) _ghosting.addFastRefresh(x, y, w, h, _next_flips);
+#endif
+      _next_flips = 0xFFFFFFFF;
+    }
+    void _fullRefreshed()
+    {
+#if ENABLE_GxEPD2_GHOSTING
+      _ghosting.clear();
+#endif
+      _next_flips = 0xFFFFFFFF;
+    }
+    // last displayed frame, kept for frame difference if full screen buffer
+    void _keepFrame()
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      if (!_full_frame) return;
+      memcpy(_previous, _buffer, sizeof(_buffer));
+      _previous_valid = true;
+#endif
+    }
+    // window of full screen buffer, x, w multiple of 8, y is buffer row
+    void _keepWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      if (!_full_frame) return;
+      uint16_t xb = x / 8, wb = gx_uint16_min((w + 7) / 8, WIDTH / 8 - xb);
+      for (uint16_t row = y; row < y + h; row++)
+      {
+        memcpy(_previous + row * (WIDTH / 8) + xb, _buffer + row * (WIDTH / 8) + xb, wb);
+      }
+#endif
+    }
+    // buffer holds partial window content
+    void _keepPartialWindow()
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      if (!_full_frame) return;
+      if (_reverse)
+      {
+        _dropFrame();
+        return;
+      }
+      for (uint16_t row = 0; row < _pw_h; row++)
+      {
+        memcpy(_previous + (_pw_y + row) * (WIDTH / 8) + _pw_x / 8, _buffer + row * (_pw_w / 8), _pw_w / 8);
+      }
+#endif
+    }
+    void _fillFrame(uint8_t value)
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      if (!_full_frame) return;
+      memset(_previous, value, sizeof(_previous));
+      _previous_valid = true;
+#endif
+    }
+    void _dropFrame()
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      _previous_valid = false;
+#endif
+    }
+    // account exact flipped pixels per tile of the next full screen fast refresh in the ghosting budget
+    void _accountFrameFlips()
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF
+      _diffFrame(true);
+#endif
+    }
+    // account exact flipped pixels per tile of a window refresh (native coordinates) against the last displayed frame,
+    // unless the flips are already accounted or given by the application
+    void _accountWindowFlips(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+#if ENABLE_GxEPD2_FRAME_DIFF && ENABLE_GxEPD2_GHOSTING
+      if (!_full_frame || _using_partial_mode || !_previous_valid || !epd2.hasFastPartialUpdate || (_next_flips != 0xFFFFFFFF)) return;
+      if ((w == 0) || (h == 0)) return;
+      const uint16_t wb = WIDTH / 8;
+      const uint16_t tile_bytes = GxEPD2_GHOSTING_TILE_SIZE / 8;
+      uint16_t xb0 = x / 8, xb1 = gx_uint16_min((x + w + 7) / 8, wb); // bytes, exclusive end
+      uint16_t y1 = gx_uint16_min(y + h, HEIGHT);
+      for (uint16_t ty = y / GxEPD2_GHOSTING_TILE_SIZE; ty * GxEPD2_GHOSTING_TILE_SIZE < y1; ty++)
+      {
+        uint16_t ry0 = gx_uint16_max(y, ty * GxEPD2_GHOSTING_TILE_SIZE);
+        uint16_t ry1 = gx_uint16_min(y1, (ty + 1) * GxEPD2_GHOSTING_TILE_SIZE);
+        for (uint16_t tx = xb0 / tile_bytes; tx * tile_bytes < xb1; tx++)
+        {
+          uint16_t b0 = gx_uint16_max(xb0, tx * tile_bytes);
+          uint16_t b1 = gx_uint16_min(xb1, (tx + 1) * tile_bytes);
+          uint16_t flips = 0;
+          for (uint16_t ry = ry0; ry < ry1; ry++)
+          {
+            uint32_t row = uint32_t(_reverse ? HEIGHT - 1 - ry : ry) * wb; // buffer rows are reversed
+            for (uint16_t b = b0; b < b1; b++) flips += __builtin_popcount(uint8_t(_buffer[row + b] ^ _previous[row + b]));
+          }
+          _ghosting.addTileFlips(tx, ty, flips);
+        }
+      }
+      _next_flips = 0; // accounted per tile
+#else
+      (void) x;
+      (void) y;
+      (void) w;
+      (void) h;
+#endif
+    }
+#if ENABLE_GxEPD2_FRAME_DIFF
+    // account_flips: add flipped pixels per tile to the ghosting budget, if possible, and set _next_flips to 0
+    const GxEPD2_FrameDiff& _diffFrame(bool account_flips)
+    {
+      if (!_full_frame || _using_partial_mode || !_previous_valid)
+      {
+        _diff.unknown(WIDTH, HEIGHT);
+        return _diff;
+      }
+#if ENABLE_GxEPD2_GHOSTING
+      if (account_flips && epd2.hasFastPartialUpdate && !_reverse)
+      {
+        uint16_t tile_flips[(GxEPD2_Type::WIDTH + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE];
+        _diff.compare(_buffer, _previous, WIDTH, HEIGHT, GxEPD2_GHOSTING_TILE_SIZE, tile_flips, _tileRowFlips, this);
+        _next_flips = 0; // accounted per tile
+      }
+      else
+#endif
+        _diff.compare(_buffer, _previous, WIDTH, HEIGHT);
+      if (_reverse) // buffer rows are reversed
+      {
+        for (uint8_t i = 0; i < _diff.count; i++) _diff.rects[i].y = HEIGHT - _diff.rects[i].y - _diff.rects[i].h;
+        if (_diff.count > 0) _diff.bounds.y = HEIGHT - _diff.bounds.y - _diff.bounds.h;
+      }
+      return _diff;
+    }
+#if ENABLE_GxEPD2_GHOSTING
+    static void _tileRowFlips(uint16_t ty, const uint16_t* flips, uint16_t tiles, const void* pv)
+    {
+      GxEPD2_BW* self = (GxEPD2_BW*) pv;
+      for (uint16_t tx = 0; tx < tiles; tx++) self->_ghosting.addTileFlips(tx, ty, flips[tx]);
+    }
+#endif
+#endif
+    // partial refresh of window of full screen buffer, native coordinates
+    void _displayNativeWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      uint16_t y_part = _reverse ? HEIGHT - h - y : y;
+      epd2.writeImagePart(_buffer, x, y_part, WIDTH, _page_height, x, y, w, h);
+      epd2.refresh(x, y, w, h);
+      _accountWindowFlips(x, y, w, h);
+      _fastRefreshed(x, y, w, h);
+      if (epd2.hasFastPartialUpdate)
+      {
+        epd2.writeImagePartAgain(_buffer, x, y_part, WIDTH, _page_height, x, y, w, h);
+      }
+      _keepWindow(x, y_part, w, h);
+    }
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+    GxEPD2_RefreshPlanner::Plan _displayPlanned(const GxEPD2_RefreshPlanner::Plan& plan, const GxEPD2_FrameDiff::Rect* rects, uint8_t count)
+    {
+      uint32_t flips = _next_flips; // 0 if accounted per tile
+      switch (plan.mode)
+      {
+        case GxEPD2_RefreshPlanner::SKIP:
+          break;
+        case GxEPD2_RefreshPlanner::FULL:
+          display(false);
+          break;
+        case GxEPD2_RefreshPlanner::BOUNDING_BOX:
+          {
+            uint16_t x0 = WIDTH, y0 = HEIGHT, x1 = 0, y1 = 0;
+            for (uint8_t i = 0; i < count; i++)
+            {
+              x0 = gx_uint16_min(x0, rects[i].x);
+              y0 = gx_uint16_min(y0, rects[i].y);
+              x1 = gx_uint16_max(x1, rects[i].x + rects[i].w);
+              y1 = gx_uint16_max(y1, rects[i].y + rects[i].h);
+            }
+            _next_flips = flips;
+            _displayNativeWindow(x0, y0, x1 - x0, y1 - y0);
+          }
+          break;
+        case GxEPD2_RefreshPlanner::WINDOWS:
+          for (uint8_t i = 0; i < count; i++)
+          {
+            _next_flips = flips;
+            _displayNativeWindow(rects[i].x, rects[i].y, rects[i].w, rects[i].h);
+          }
+          break;
+      }
+      _next_flips = 0xFFFFFFFF;
+      return plan;
+    }
+    // take measured busy times and SPI cost per byte from the driver, once available
+    // the byte cost is measured over the data bursts only, init, power on and busy waits are not in it
+    void _updatePlanner()
+    {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+      const GxEPD2_TimingProfile& t = epd2.timingProfile();
+      _planner.setTiming(t.average(GxEPD2_TimingProfile::UPDATE_FULL), t.average(GxEPD2_TimingProfile::UPDATE_PART), t.transferByteNs(),
+                         t.average(GxEPD2_TimingProfile::POWER_ON), t.average(GxEPD2_TimingProfile::POWER_OFF));
+#endif
+    }
+#endif
+    bool _fullCleanupNeeded()
+    {
+#if ENABLE_GxEPD2_GHOSTING
+      uint16_t x, y, w, h;
+      return _ghosting.cleanupNeeded(x, y, w, h) == GxEPD2_Ghosting::FULL;
+#else
+      return false;
+#endif
+    }
     void _rotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
     {
       switch (getRotation())
@@ -596,6 +1124,27 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
           break;
       }
     }
+    // inverse of _rotate
+    void _unrotate(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h)
+    {
+      switch (getRotation())
+      {
+        case 1:
+          x = WIDTH - x - w;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+        case 2:
+          x = WIDTH - x - w;
+          y = HEIGHT - y - h;
+          break;
+        case 3:
+          y = HEIGHT - y - h;
+          _swap_(x, y);
+          _swap_(w, h);
+          break;
+      }
+    }
   private:
     uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
     bool _using_partial_mode, _second_phase, _mirror, _reverse;
@@ -603,6 +1152,19 @@ class GxEPD2_BW : public GxEPD2_GFX_BASE_CLASS
     int16_t _current_page;
     uint16_t _pages, _page_height;
     uint16_t _pw_x, _pw_y, _pw_w, _pw_h;
+    uint32_t _next_flips;
+#if ENABLE_GxEPD2_REFRESH_PLANNER
+    GxEPD2_RefreshPlanner _planner;
+#endif
+#if ENABLE_GxEPD2_GHOSTING
+    GxEPD2_GhostingTiles<GxEPD2_Type::WIDTH, GxEPD2_Type::HEIGHT> _ghosting;
+#endif
+#if ENABLE_GxEPD2_FRAME_DIFF
+    static const bool _full_frame = (page_height >= GxEPD2_Type::HEIGHT);
+    uint8_t _previous[_full_frame ? (GxEPD2_Type::WIDTH / 8) * page_height : 1];
+    bool _previous_valid;
+    GxEPD2_FrameDiff _diff;
+#endif
 };
 
 #endif
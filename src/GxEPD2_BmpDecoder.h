@@ -0,0 +1,366 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// BMP decoder: streaming decoder of uncompressed BMP files of 1, 2, 4, 8, 16, 24 or 32 bits per pixel, pulled from a GxEPD2_ImageSource.
+// Reads by blocks, maps palette indexes with masks precomputed once per file, and decodes rows with one loop per depth.
+// Decodes to controller memory (write), or to the buffer of the template classes, paged or full (draw).
+// Pixel classification is the same as in the BMP examples: whitish, else colored (reddish or yellowish) if with color, else black.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_BmpDecoder_H_
+#define _GxEPD2_BmpDecoder_H_
+
+#include "GxEPD2.h"
+#include "GxEPD2_ImageSource.h"
+
+// bytes of the input buffer on the stack, multiple of 2, 3 and 4
+#ifndef GxEPD2_BMP_INPUT_SIZE
+#if defined(__AVR)
+#define GxEPD2_BMP_INPUT_SIZE 48
+#else
+#define GxEPD2_BMP_INPUT_SIZE 480
+#endif
+#endif
+
+// keep the palette as rgb565 for multicolor drawing, e.g. for GxEPD2_7C; 512 bytes
+#if !defined(GxEPD2_BMP_RGB565) && !defined(__AVR)
+#define GxEPD2_BMP_RGB565 1
+#endif
+
+class GxEPD2_BmpDecoder
+{
+  public:
+    // source positioned at the start of the file; with_color: colored pixels to the color plane, else black
+    GxEPD2_BmpDecoder(GxEPD2_ImageSource& source, bool with_color = true) :
+      _source(source), _valid(false), _with_color(with_color), _color(false), _bottom_up(true), _w(0), _h(0), _depth(0), _format(0), _row_size(0), _row(0) {};
+    // parses the headers and the palette, leaves the source at the first row; call again after rewind of the source
+    bool begin()
+    {
+      uint8_t b[40];
+      _valid = false;
+      _row = 0;
+      if ((_source.read(b, 18) < 18) || (b[0] != 'B') || (b[1] != 'M')) return false;
+      uint32_t offset = _get(b + 10, 4);
+      uint32_t header_size = _get(b + 14, 4);
+      uint32_t consumed = 18;
+      bool core = header_size == 12; // OS/2 BITMAPCOREHEADER
+      if ((header_size != 12) && (header_size < 40)) return false;
+      uint16_t n = core ? 8 : 36;
+      if (_source.read(b, n) < n) return false;
+      consumed += n;
+      int32_t width = core ? int16_t(_get(b, 2)) : int32_t(_get(b, 4));
+      int32_t height = core ? int16_t(_get(b + 2, 2)) : int32_t(_get(b + 4, 4));
+      uint16_t planes = _get(b + (core ? 4 : 8), 2);
+      _depth = _get(b + (core ? 6 : 10), 2);
+      uint32_t compression = core ? 0 : _get(b + 12, 4);
+      uint32_t colors = core ? 0 : _get(b + 28, 4);
+      _bottom_up = height > 0;
+      if (height < 0) height = -height;
+      if ((planes != 1) || (width <= 0) || (width > 0x7FFF) || (height == 0) || (height > 0x7FFF)) return false;
+      if ((_depth != 1) && (_depth != 2) && (_depth != 4) && (_depth != 8) && (_depth != 16) && (_depth != 24) && (_depth != 32)) return false;
+      _w = width;
+      _h = height;
+      _color = _with_color && (_depth > 1); // 1 bit per pixel is black and white
+      _row_size = ((uint32_t(_w) * _depth + 31) / 32) * 4;
+      _format = 0; // 555 for 16 bits per pixel, BGR(A) for 24 and 32
+      if (compression == 3) // BI_BITFIELDS, masks follow 40 byte header, or are part of larger headers
+      {
+        if (_source.read(b, 12) < 12) return false;
+        consumed += 12;
+        uint32_t red = _get(b, 4), green = _get(b + 4, 4), blue = _get(b + 8, 4);
+        if ((_depth == 16) && (red == 0xF800) && (green == 0x07E0) && (blue == 0x001F)) _format = 1; // 565
+        else if ((_depth == 16) && (red == 0x7C00) && (green == 0x03E0) && (blue == 0x001F)) _format = 0;
+        else if ((_depth == 32) && (red == 0x00FF0000) && (green == 0x0000FF00) && (blue == 0x000000FF)) _format = 0;
+        else return false;
+      }
+      else if (compression != 0) return false; // RLE or embedded JPEG or PNG
+      if (14 + header_size > consumed)
+      {
+        _source.skip(14 + header_size - consumed);
+        consumed = 14 + header_size;
+      }
+      if (_depth <= 8)
+      {
+        uint16_t entries = (colors > 0) && (colors < (1u << _depth)) ? colors : 1 << _depth;
+        uint8_t entry = core ? 3 : 4;
+        memset(_white, 0xFF, sizeof(_white)); // indexes beyond the palette
+        memset(_colored, 0, sizeof(_colored));
+        for (uint16_t i = 0; i < entries; i += 8)
+        {
+          uint16_t c = entries - i < 8 ? entries - i : 8;
+          if (_source.read(b, c * entry) < c * entry) return false;
+          consumed += c * entry;
+          for (uint16_t k = 0; k < c; k++) _palette(i + k, b[k * entry + 2], b[k * entry + 1], b[k * entry]);
+        }
+      }
+      if (offset < consumed) return false;
+      _source.skip(offset - consumed);
+      _valid = true;
+      return true;
+    };
+    bool valid() const
+    {
+      return _valid;
+    };
+    int16_t width() const
+    {
+      return _w;
+    };
+    int16_t height() const
+    {
+      return _h;
+    };
+    uint8_t depth() const
+    {
+      return _depth;
+    };
+    // rows are stored bottom to top, the usual case
+    bool bottomUp() const
+    {
+      return _bottom_up;
+    };
+    // bytes per row in the file, with padding; readRow() reads exactly one row, so a seekable source may be positioned
+    // at any row in between, e.g. to read bottom up files top to bottom; the index returned then is that of file order
+    uint32_t rowSize() const
+    {
+      return _row_size;
+    };
+    // decodes the next row in file order to rows of (width + 7) / 8 bytes, bit 1 is white, 0 black or color, as for writeImage
+    // color may be 0; returns the index of the row from the top, or -1 at end or on error
+    int16_t readRow(uint8_t* black, uint8_t* color)
+    {
+      if (!_valid || (_row >= _h)) return -1;
+      uint16_t wb = (_w + 7) / 8;
+      memset(black, 0xFF, wb);
+      if (color) memset(color, 0xFF, wb);
+      _BitSink sink(*this, black, _color ? color : 0); // stays white without color
+      if (!_decodeRow(sink)) return -1;
+      if (_w % 8) black[wb - 1] |= 0xFF >> (_w % 8); // white border for w % 8 != 0
+      return _nextRow();
+    };
+    // writes the image to controller memory of target, the display or display.epd2, at x, y, without refresh; x should be multiple of 8
+    // 1 bit per pixel images with black and white palette are written from the source directly, without decoding
+    // a decoded row needs to fit GxEPD2_SOURCE_BLOCK_SIZE bytes, else returns false
+    template <class Target> bool write(Target& target, int16_t x, int16_t y)
+    {
+      if (!_valid || (_row != 0)) return false;
+      bool invert;
+      if ((_depth == 1) && (_w % 8 == 0) && _plain(invert))
+      {
+        _row = _h;
+        return GxEPD2_ImageSource::write(target, &_source, 0, 1, false, 0, 0, _row_size * 8, _h, x, y, _w, _h, invert, _bottom_up);
+      }
+      uint8_t black[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint8_t color[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint16_t wb = (_w + 7) / 8;
+      uint16_t rows = GxEPD2_SOURCE_BLOCK_SIZE / wb;
+      if (rows == 0) return false;
+      for (int16_t y1 = 0; y1 < _h; y1 += rows)
+      {
+        int16_t n = rows < _h - y1 ? rows : _h - y1;
+        for (int16_t i = 0; i < n; i++)
+        {
+          if (readRow(black + i * wb, _color ? color + i * wb : 0) < 0) return false;
+        }
+        // rows of the block are in file order, mirrored if bottom up
+        int16_t by = _bottom_up ? y + _h - y1 - n : y + y1;
+        if (_color) target.writeImage(black, color, x, by, _w, n, false, _bottom_up, false);
+        else target.writeImage(black, x, by, _w, n, false, _bottom_up, false);
+      }
+      return true;
+    };
+    // draws the image to the buffer of gfx, e.g. inside the picture loop; rows outside gfx.height() are decoded, not drawn
+    // multicolor draws rgb565 colors, e.g. for GxEPD2_7C, else black, white and colored (GxEPD_RED)
+    template <class GFX> bool draw(GFX& gfx, int16_t x, int16_t y, bool multicolor = false)
+    {
+      if (!_valid || (_row != 0)) return false;
+      _DrawSink<GFX> sink(*this, gfx, x, multicolor);
+      while (_row < _h)
+      {
+        int16_t yrow = y + (_bottom_up ? _h - 1 - _row : _row);
+        if ((yrow < 0) || (yrow >= gfx.height())) sink.skip = true;
+        else
+        {
+          sink.skip = false;
+          sink.y = yrow;
+        }
+        if (!_decodeRow(sink)) return false;
+        _nextRow();
+      }
+      return true;
+    };
+  private:
+    static uint32_t _get(const uint8_t* b, uint8_t n)
+    {
+      uint32_t v = 0;
+      while (n-- > 0) v = (v << 8) | b[n];
+      return v;
+    };
+    bool _whitish(uint8_t r, uint8_t g, uint8_t b) const
+    {
+      return _color ? (r > 0x80) && (g > 0x80) && (b > 0x80) : uint16_t(r) + g + b > 3 * 0x80;
+    };
+    static bool _reddish(uint8_t r, uint8_t g, uint8_t b)
+    {
+      return (r > 0xF0) || ((g > 0xF0) && (b > 0xF0)); // reddish or yellowish
+    };
+    static uint16_t _rgb565(uint8_t r, uint8_t g, uint8_t b)
+    {
+      return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    };
+    void _palette(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+      uint8_t mask = 1 << (i % 8);
+      if (!_whitish(r, g, b)) _white[i / 8] &= ~mask;
+      if (_reddish(r, g, b)) _colored[i / 8] |= mask;
+#if GxEPD2_BMP_RGB565
+      _rgb[i] = _rgb565(r, g, b);
+#endif
+    };
+    // 1 bit per pixel with palette black and white, or white and black
+    bool _plain(bool& invert) const
+    {
+      uint8_t map = _white[0] & 0x03;
+      invert = map == 0x01;
+      return (map == 0x01) || (map == 0x02);
+    };
+    int16_t _nextRow()
+    {
+      int16_t row = _bottom_up ? _h - 1 - _row : _row;
+      _row++;
+      return row;
+    };
+    // decodes the next row, calls sink.index(col, index) for palette images, sink.rgb(col, r, g, b) for true color images
+    template <class Sink> bool _decodeRow(Sink& sink)
+    {
+      uint8_t in[GxEPD2_BMP_INPUT_SIZE];
+      uint32_t remain = _row_size;
+      uint16_t col = 0;
+      while (remain > 0)
+      {
+        uint16_t n = remain < sizeof(in) ? remain : sizeof(in);
+        if (_source.read(in, n) < n)
+        {
+          _valid = false;
+          return false;
+        }
+        remain -= n;
+        uint32_t end = col + uint32_t(n) * 8 / _depth;
+        if (end > uint32_t(_w)) end = _w;
+        const uint8_t* p = in;
+        switch (_depth)
+        {
+          case 1:
+            for (; col < end; p++)
+            {
+              uint8_t v = *p;
+              for (uint8_t k = 0; (k < 8) && (col < end); k++, col++, v <<= 1) sink.index(col, v >> 7);
+            }
+            break;
+          case 2:
+            for (; col < end; p++)
+            {
+              uint8_t v = *p;
+              for (uint8_t k = 0; (k < 4) && (col < end); k++, col++, v <<= 2) sink.index(col, v >> 6);
+            }
+            break;
+          case 4:
+            for (; col < end; p++)
+            {
+              sink.index(col++, *p >> 4);
+              if (col < end) sink.index(col++, *p & 0x0F);
+            }
+            break;
+          case 8:
+            for (; col < end; p++) sink.index(col++, *p);
+            break;
+          case 16:
+            if (_format == 1) // 565
+            {
+              for (; col < end; p += 2) sink.rgb(col++, p[1] & 0xF8, ((p[1] & 0x07) << 5) | ((p[0] & 0xE0) >> 3), (p[0] & 0x1F) << 3);
+            }
+            else // 555
+            {
+              for (; col < end; p += 2) sink.rgb(col++, (p[1] & 0x7C) << 1, ((p[1] & 0x03) << 6) | ((p[0] & 0xE0) >> 2), (p[0] & 0x1F) << 3);
+            }
+            break;
+          case 24:
+            for (; col < end; p += 3) sink.rgb(col++, p[2], p[1], p[0]);
+            break;
+          case 32:
+            for (; col < end; p += 4) sink.rgb(col++, p[2], p[1], p[0]);
+            break;
+        }
+      }
+      return true;
+    };
+    // to rows of bits, as for writeImage
+    struct _BitSink
+    {
+      _BitSink(GxEPD2_BmpDecoder& d, uint8_t* b, uint8_t* c) : decoder(d), black(b), color(c) {};
+      void index(uint16_t col, uint8_t i)
+      {
+        uint8_t mask = 1 << (i % 8);
+        if (decoder._white[i / 8] & mask) return;
+        if (color && (decoder._colored[i / 8] & mask)) color[col / 8] &= ~(0x80 >> (col % 8));
+        else black[col / 8] &= ~(0x80 >> (col % 8));
+      };
+      void rgb(uint16_t col, uint8_t r, uint8_t g, uint8_t b)
+      {
+        if (decoder._whitish(r, g, b)) return;
+        if (color && _reddish(r, g, b)) color[col / 8] &= ~(0x80 >> (col % 8));
+        else black[col / 8] &= ~(0x80 >> (col % 8));
+      };
+      GxEPD2_BmpDecoder& decoder;
+      uint8_t* black;
+      uint8_t* color;
+    };
+    // to pixels of the buffer
+    template <class GFX> struct _DrawSink
+    {
+      _DrawSink(GxEPD2_BmpDecoder& d, GFX& g, int16_t x0, bool m) : decoder(d), gfx(g), x(x0), y(0), multicolor(m), skip(false) {};
+      void index(uint16_t col, uint8_t i)
+      {
+        if (skip) return;
+#if GxEPD2_BMP_RGB565
+        if (multicolor && decoder._color)
+        {
+          gfx.drawPixel(x + col, y, decoder._rgb[i]);
+          return;
+        }
+#endif
+        uint8_t mask = 1 << (i % 8);
+        bool colored = decoder._color && (decoder._colored[i / 8] & mask);
+        gfx.drawPixel(x + col, y, decoder._white[i / 8] & mask ? GxEPD_WHITE : colored ? GxEPD_RED : GxEPD_BLACK);
+      };
+      void rgb(uint16_t col, uint8_t r, uint8_t g, uint8_t b)
+      {
+        if (skip) return;
+        if (multicolor && decoder._color) gfx.drawPixel(x + col, y, _rgb565(r, g, b));
+        else gfx.drawPixel(x + col, y, decoder._whitish(r, g, b) ? GxEPD_WHITE : decoder._color && _reddish(r, g, b) ? GxEPD_RED : GxEPD_BLACK);
+      };
+      GxEPD2_BmpDecoder& decoder;
+      GFX& gfx;
+      int16_t x, y;
+      bool multicolor, skip;
+    };
+    GxEPD2_ImageSource& _source;
+    bool _valid, _with_color, _color, _bottom_up;
+    int16_t _w, _h;
+    uint16_t _depth;
+    uint8_t _format;
+    uint32_t _row_size;
+    int16_t _row;
+    uint8_t _white[32]; // bit per palette index: whitish
+    uint8_t _colored[32]; // bit per palette index: reddish or yellowish
+#if GxEPD2_BMP_RGB565
+    uint16_t _rgb[256];
+#endif
+};
+
+#endif
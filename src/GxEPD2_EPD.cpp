@@ -11,6 +11,12 @@
 
 #include "GxEPD2_EPD.h"
 
+#if ENABLE_GxEPD2_SPI_MONITOR
+#define GxEPD2_MONITOR(event, value) if (_spi_monitor) _spi_monitor(event, value, _spi_monitor_pv)
+#else
+#define GxEPD2_MONITOR(event, value)
+#endif
+
 #if defined(ESP8266) || defined(ESP32)
 #include <pgmspace.h>
 #else
@@ -30,6 +36,15 @@ GxEPD2_EPD::GxEPD2_EPD(int8_t cs, int8_t dc, int8_t rst, int8_t busy, int8_t bus
   _hibernating = false;
   _init_display_done = false;
   _reset_duration = 20;
+#if ENABLE_GxEPD2_SPI_MONITOR
+  _spi_monitor = 0;
+  _spi_monitor_pv = 0;
+#endif
+#if ENABLE_GxEPD2_TIMING_PROFILE
+  _async_full_start = 0;
+  _transfer_start = 0;
+  _transfer_n = 0;
+#endif
 }
 
 void GxEPD2_EPD::init(uint32_t serial_diag_bitrate)
@@ -70,10 +85,57 @@ void GxEPD2_EPD::init(uint32_t serial_diag_bitrate, bool initial, uint16_t reset
   _spi.begin();
 }
 
+void GxEPD2_EPD::writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  // no grey waveform: light grey and white to white, dark grey and black to black, by blocks of whole rows
+  if ((w <= 0) || (h <= 0)) return;
+  uint32_t wb = (uint32_t(w) + 3) / 4; // width bytes of the 2 bits per pixel bitmap
+  uint8_t block[GxEPD2_SOURCE_BLOCK_SIZE];
+  uint16_t part = gx_uint16_min(w, GxEPD2_SOURCE_BLOCK_SIZE * 8); // pixels per row in the block, parts of rows if too wide
+  uint16_t pb = (part + 7) / 8; // bytes per row in the block
+  uint16_t rows = part < w ? 1 : GxEPD2_SOURCE_BLOCK_SIZE / pb;
+  for (int16_t i = 0; i < h; i += rows)
+  {
+    int16_t n = gx_uint16_min(rows, h - i);
+    for (int16_t xs = 0; xs < w; xs += part)
+    {
+      int16_t ws = gx_uint16_min(part, w - xs);
+      for (int16_t k = 0; k < n; k++)
+      {
+        uint32_t row = mirror_y ? h - 1 - (i + k) : i + k;
+        for (int16_t j = 0; j < (ws + 7) / 8; j++)
+        {
+          uint32_t idx = row * wb + (xs + j * 8) / 4;
+          uint32_t idx1 = xs + j * 8 + 4 < w ? idx + 1 : idx; // padded bitmap row
+          uint8_t b0, b1;
+          if (pgm)
+          {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+            b0 = pgm_read_byte(&bitmap[idx]);
+            b1 = pgm_read_byte(&bitmap[idx1]);
+#else
+            b0 = bitmap[idx];
+            b1 = bitmap[idx1];
+#endif
+          }
+          else
+          {
+            b0 = bitmap[idx];
+            b1 = bitmap[idx1];
+          }
+          block[k * pb + j] = _greyPlane(b0, b1, false); // most significant bit: level 2 or 3
+        }
+      }
+      writeImage(block, x + xs, y + i, ws, n, invert);
+    }
+  }
+}
+
 void GxEPD2_EPD::_reset()
 {
   if (_rst >= 0)
   {
+    GxEPD2_MONITOR(SPI_RESET, 0);
     if (_pulldown_rst_mode)
     {
       digitalWrite(_rst, LOW);
@@ -101,7 +163,12 @@ void GxEPD2_EPD::_waitWhileBusy(const char* comment, uint16_t busy_time)
   // For full refreshes, meshtastic/firmare will poll GxEPD2_EPD::isBusy() instead of waiting here (for EInkDynamicDisplay only)
 #if defined(USE_EINK_DYNAMICDISPLAY)
   if (_isUpdatingFull(comment))
+  {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+    _async_full_start = micros() | 1; // measured by isBusy() polling
+#endif
     return;
+  }
 #endif
 
   if (_busy >= 0)
@@ -110,7 +177,14 @@ void GxEPD2_EPD::_waitWhileBusy(const char* comment, uint16_t busy_time)
     unsigned long start = micros();
     while (1)
     {
-      if (digitalRead(_busy) != _busy_level) break;
+      if (digitalRead(_busy) != _busy_level)
+      {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+        _timing_profile.record(GxEPD2_TimingProfile::operation(comment), micros() - start);
+#endif
+        GxEPD2_MONITOR(SPI_BUSY, micros() - start + 1000);
+        break;
+      }
       delay(1);
       if (micros() - start > _busy_timeout)
       {
@@ -132,7 +206,11 @@ void GxEPD2_EPD::_waitWhileBusy(const char* comment, uint16_t busy_time)
     }
     (void) start;
   }
-  else delay(busy_time);
+  else
+  {
+    GxEPD2_MONITOR(SPI_BUSY, uint32_t(busy_time) * 1000);
+    delay(busy_time);
+  }
 }
 
 void GxEPD2_EPD::_writeCommand(uint8_t c)
@@ -140,8 +218,11 @@ void GxEPD2_EPD::_writeCommand(uint8_t c)
   _spi.beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
+  GxEPD2_MONITOR(SPI_COMMAND, c);
   _spi.transfer(c);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
   _spi.endTransaction();
 }
@@ -150,8 +231,11 @@ void GxEPD2_EPD::_writeData(uint8_t d)
 {
   _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
+  GxEPD2_MONITOR(SPI_DATA, d);
   _spi.transfer(d);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
 }
 
@@ -159,11 +243,14 @@ void GxEPD2_EPD::_writeData(const uint8_t* data, uint16_t n)
 {
   _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
   for (uint16_t i = 0; i < n; i++)
   {
+    GxEPD2_MONITOR(SPI_DATA, *data);
     _spi.transfer(*data++);
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
 }
 
@@ -171,16 +258,20 @@ void GxEPD2_EPD::_writeDataPGM(const uint8_t* data, uint16_t n, int16_t fill_wit
 {
   _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
   for (uint16_t i = 0; i < n; i++)
   {
+    GxEPD2_MONITOR(SPI_DATA, pgm_read_byte(&*data));
     _spi.transfer(pgm_read_byte(&*data++));
   }
   while (fill_with_zeroes > 0)
   {
+    GxEPD2_MONITOR(SPI_DATA, 0x00);
     _spi.transfer(0x00);
     fill_with_zeroes--;
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
 }
 
@@ -190,15 +281,21 @@ void GxEPD2_EPD::_writeDataPGM_sCS(const uint8_t* data, uint16_t n, int16_t fill
   for (uint8_t i = 0; i < n; i++)
   {
     if (_cs >= 0) digitalWrite(_cs, LOW);
+    GxEPD2_MONITOR(SPI_BEGIN, 0);
+    GxEPD2_MONITOR(SPI_DATA, pgm_read_byte(&*data));
     _spi.transfer(pgm_read_byte(&*data++));
     if (_cs >= 0) digitalWrite(_cs, HIGH);
+    GxEPD2_MONITOR(SPI_END, 0);
   }
   while (fill_with_zeroes > 0)
   {
     if (_cs >= 0) digitalWrite(_cs, LOW);
+    GxEPD2_MONITOR(SPI_BEGIN, 0);
+    GxEPD2_MONITOR(SPI_DATA, 0x00);
     _spi.transfer(0x00);
     fill_with_zeroes--;
     if (_cs >= 0) digitalWrite(_cs, HIGH);
+    GxEPD2_MONITOR(SPI_END, 0);
   }
   _spi.endTransaction();
 }
@@ -208,13 +305,17 @@ void GxEPD2_EPD::_writeCommandData(const uint8_t* pCommandData, uint8_t datalen)
   _spi.beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
+  GxEPD2_MONITOR(SPI_COMMAND, *pCommandData);
   _spi.transfer(*pCommandData++);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
   for (uint8_t i = 0; i < datalen - 1; i++)  // sub the command
   {
+    GxEPD2_MONITOR(SPI_DATA, *pCommandData);
     _spi.transfer(*pCommandData++);
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
 }
 
@@ -223,36 +324,229 @@ void GxEPD2_EPD::_writeCommandDataPGM(const uint8_t* pCommandData, uint8_t datal
   _spi.beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
+  GxEPD2_MONITOR(SPI_COMMAND, pgm_read_byte(&*pCommandData));
   _spi.transfer(pgm_read_byte(&*pCommandData++));
   if (_dc >= 0) digitalWrite(_dc, HIGH);
   for (uint8_t i = 0; i < datalen - 1; i++)  // sub the command
   {
+    GxEPD2_MONITOR(SPI_DATA, pgm_read_byte(&*pCommandData));
     _spi.transfer(pgm_read_byte(&*pCommandData++));
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
 }
 
 void GxEPD2_EPD::_startTransfer()
 {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+  _transfer_n = 0;
+  _transfer_start = micros();
+#endif
   _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
+  GxEPD2_MONITOR(SPI_BEGIN, 0);
 }
 
 void GxEPD2_EPD::_transfer(uint8_t value)
 {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+  _transfer_n++;
+#endif
+  GxEPD2_MONITOR(SPI_DATA, value);
   _spi.transfer(value);
 }
 
+void GxEPD2_EPD::_transfer(uint8_t* buffer, uint16_t n)
+{
+#if ENABLE_GxEPD2_TIMING_PROFILE
+  _transfer_n += n;
+#endif
+#if ENABLE_GxEPD2_SPI_MONITOR
+  if (_spi_monitor)
+  {
+    for (uint16_t i = 0; i < n; i++) _spi_monitor(SPI_DATA, buffer[i], _spi_monitor_pv);
+  }
+#endif
+#if defined(ESP8266) || defined(ESP32)
+  _spi.writeBytes(buffer, n);
+#else
+  _spi.transfer(buffer, n);
+#endif
+}
+
 void GxEPD2_EPD::_endTransfer()
 {
   if (_cs >= 0) digitalWrite(_cs, HIGH);
+  GxEPD2_MONITOR(SPI_END, 0);
   _spi.endTransaction();
+#if ENABLE_GxEPD2_TIMING_PROFILE
+#if ENABLE_GxEPD2_SPI_MONITOR
+  if (_spi_monitor) return; // the monitor adds its time per byte
+#endif
+  _timing_profile.transferred(_transfer_n, micros() - _transfer_start);
+#endif
 }
 
+void GxEPD2_EPD::_writeImageData(const uint8_t bitmap[], int16_t wb, int16_t h, int16_t wb_bitmap, int16_t h_bitmap, int16_t xb, int16_t y,
+                                 bool invert, bool mirror_y, bool pgm)
+{
+  // flags resolved once per call, not per byte; rows addressed by pointer step, no index multiply
+  int32_t row_step = mirror_y ? -int32_t(wb_bitmap) : int32_t(wb_bitmap);
+  const uint8_t* row = bitmap + xb + int32_t(mirror_y ? h_bitmap - 1 - y : y) * wb_bitmap;
+  _startTransfer();
+  if (pgm)
+  {
+    if (invert) _writeImageRows<true, true>(row, wb, h, row_step);
+    else _writeImageRows<true, false>(row, wb, h, row_step);
+  }
+  else
+  {
+    if (invert) _writeImageRows<false, true>(row, wb, h, row_step);
+    else _writeImageRows<false, false>(row, wb, h, row_step);
+  }
+  _endTransfer();
+}
+
+template <bool pgm, bool invert> void GxEPD2_EPD::_writeImageRows(const uint8_t* row, int16_t wb, int16_t h, int32_t row_step)
+{
+  // rows, or blocks of short rows, are collected into the stage and sent by burst; the transfer is continuous, burst size doesn't matter
+  uint32_t stage[_stage_words];
+  uint8_t* bytes = (uint8_t*) stage;
+  uint16_t n = 0;
+  for (int16_t i = 0; i < h; i++, row += row_step)
+  {
+    const uint8_t* p = row;
+    uint16_t remaining = wb;
+    while (remaining > 0)
+    {
+      uint16_t c = gx_uint16_min(remaining, sizeof(stage) - n);
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (pgm) memcpy_P(bytes + n, p, c);
+      else memcpy(bytes + n, p, c);
+#else
+      memcpy(bytes + n, p, c);
+#endif
+      p += c;
+      n += c;
+      remaining -= c;
+      if (n == sizeof(stage))
+      {
+        if (invert) for (uint16_t k = 0; k < _stage_words; k++) stage[k] = ~stage[k];
+        _transfer(bytes, n);
+        n = 0;
+      }
+    }
+  }
+  if (n > 0)
+  {
+    if (invert) for (uint16_t k = 0; k < (n + 3) / 4; k++) stage[k] = ~stage[k];
+    _transfer(bytes, n);
+  }
+}
+
+void GxEPD2_EPD::_writeGreyPlaneData(const uint8_t bitmap[], int16_t wb, int16_t h, int16_t wb_bitmap, int16_t h_bitmap, int16_t xb, int16_t y,
+                                     bool lsb, bool invert, bool mirror_y, bool pgm)
+{
+  // two bitmap bytes per plane byte, as _writeImageData
+  int32_t row_step = mirror_y ? -int32_t(wb_bitmap) : int32_t(wb_bitmap);
+  const uint8_t* row = bitmap + 2 * xb + int32_t(mirror_y ? h_bitmap - 1 - y : y) * wb_bitmap;
+  uint8_t mask = invert ? 0x00 : 0xFF;
+  _startTransfer();
+  if (pgm) _writeGreyPlaneRows<true>(row, wb, h, row_step, wb_bitmap - 2 * xb, lsb, mask);
+  else _writeGreyPlaneRows<false>(row, wb, h, row_step, wb_bitmap - 2 * xb, lsb, mask);
+  _endTransfer();
+}
+
+template <bool pgm> void GxEPD2_EPD::_writeGreyPlaneRows(const uint8_t* row, int16_t wb, int16_t h, int32_t row_step, int16_t row_bytes, bool lsb, uint8_t mask)
+{
+  // plane bytes are collected into the stage and sent by burst, as by _writeImageRows
+  uint32_t stage[_stage_words];
+  uint8_t* bytes = (uint8_t*) stage;
+  uint16_t n = 0;
+  for (int16_t i = 0; i < h; i++, row += row_step)
+  {
+    for (int16_t j = 0; j < wb; j++)
+    {
+      const uint8_t* p0 = row + 2 * j;
+      const uint8_t* p1 = 2 * j + 1 < row_bytes ? p0 + 1 : p0; // last byte of odd width rows
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      uint8_t b0 = pgm ? pgm_read_byte(p0) : *p0;
+      uint8_t b1 = pgm ? pgm_read_byte(p1) : *p1;
+#else
+      uint8_t b0 = *p0;
+      uint8_t b1 = *p1;
+#endif
+      bytes[n++] = _greyPlane(b0, b1, lsb) ^ mask;
+      if (n == sizeof(stage))
+      {
+        _transfer(bytes, n);
+        n = 0;
+      }
+    }
+  }
+  if (n > 0) _transfer(bytes, n);
+}
+
+void GxEPD2_EPD::_writeDataFill(uint8_t value, uint32_t n)
+{
+  uint32_t stage[_stage_words];
+  _startTransfer();
+  while (n > 0)
+  {
+    uint16_t c = n < sizeof(stage) ? n : sizeof(stage);
+    memset(stage, value, c); // refilled, the burst overwrites it
+    _transfer((uint8_t*) stage, c);
+    n -= c;
+  }
+  _endTransfer();
+}
+
+#if ENABLE_GxEPD2_SPI_MONITOR
+void GxEPD2_EPD::replaySpiEvent(SpiEvent event, uint32_t value)
+{
+  switch (event)
+  {
+    case SPI_BEGIN:
+      _spi.beginTransaction(_spi_settings);
+      if (_cs >= 0) digitalWrite(_cs, LOW);
+      break;
+    case SPI_COMMAND:
+      if (_dc >= 0) digitalWrite(_dc, LOW);
+      _spi.transfer(value);
+      if (_dc >= 0) digitalWrite(_dc, HIGH);
+      break;
+    case SPI_DATA:
+      _spi.transfer(value);
+      break;
+    case SPI_END:
+      if (_cs >= 0) digitalWrite(_cs, HIGH);
+      _spi.endTransaction();
+      break;
+    case SPI_BUSY:
+      _waitWhileBusy("replay", value / 1000); // reports itself
+      return;
+    case SPI_RESET:
+      _reset(); // reports itself
+      return;
+  }
+  GxEPD2_MONITOR(event, value);
+}
+#endif
+
 // Polled by meshtastic/firmware, during async full-refresh
 bool GxEPD2_EPD::isBusy() {
-  return (digitalRead(_busy) == _busy_level);
+  bool busy = (digitalRead(_busy) == _busy_level);
+#if ENABLE_GxEPD2_TIMING_PROFILE
+  if (!busy && _async_full_start)
+  {
+    // resolution is the polling interval
+    _timing_profile.record(GxEPD2_TimingProfile::UPDATE_FULL, micros() - _async_full_start);
+    _async_full_start = 0;
+  }
+#endif
+  return busy;
 }
 
 // Used to skip _waitWhileBusy(), for meshtastic async
@@ -16,9 +16,20 @@
 #include <SPI.h>
 
 #include <GxEPD2.h>
+#include "GxEPD2_TimingProfile.h"
+#include "GxEPD2_ImageSource.h"
 
 #pragma GCC diagnostic ignored "-Wunused-parameter"
 
+// SPI monitor hook, for statistics and traces of the command and data stream; compiled into GxEPD2_EPD.cpp, override by build flag only
+#ifndef ENABLE_GxEPD2_SPI_MONITOR
+#if defined(__AVR)
+#define ENABLE_GxEPD2_SPI_MONITOR 0
+#else
+#define ENABLE_GxEPD2_SPI_MONITOR 1
+#endif
+#endif
+
 class GxEPD2_EPD
 {
   public:
@@ -80,6 +91,22 @@ class GxEPD2_EPD
     //    virtual void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
     virtual void refresh(bool partial_update_mode = false) = 0; // screen refresh from controller memory to full screen
     virtual void refresh(int16_t x, int16_t y, int16_t w, int16_t h) = 0; // screen refresh from controller memory, partial screen
+    // screen refresh from controller memory with full waveform, limited to the window if hasWindowedFullRefresh, else full screen
+    static const bool hasWindowedFullRefresh = false;
+    virtual void refreshFull(int16_t x, int16_t y, int16_t w, int16_t h)
+    {
+      refresh(false);
+    }
+    // four grey levels, for controllers with two RAM planes and a custom grey waveform (hasGreyLevels), see GxEPD2_4G
+    // bitmap 2 bits per pixel, 4 pixels per byte, first pixel in the most significant bits; 0 black, 1 dark grey, 2 light grey, 3 white
+    static const bool hasGreyLevels = false;
+    // write to controller memory, without screen refresh; x and w should be multiple of 8; default: thresholded to black and white
+    virtual void writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    // screen refresh from controller memory to full screen with the grey waveform; default: full refresh
+    virtual void refresh4G()
+    {
+      refresh(false);
+    }
     virtual void powerOff() = 0; // turns off generation of panel driving voltages, avoids screen fading over time
     virtual void hibernate() = 0; // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
     virtual void setPaged() {}; // for GxEPD2_154c paged workaround
@@ -92,6 +119,33 @@ class GxEPD2_EPD
       return (a > b ? a : b);
     };
     bool isBusy();  // Used in meshtastic/firmware, to poll after nextPage(), for async full refresh
+#if ENABLE_GxEPD2_TIMING_PROFILE
+    // measured busy durations per operation, e.g. timingProfile().expected(GxEPD2_TimingProfile::UPDATE_FULL, full_refresh_time * 1000ul)
+    GxEPD2_TimingProfile& timingProfile()
+    {
+      return _timing_profile;
+    }
+#endif
+#if ENABLE_GxEPD2_SPI_MONITOR
+    enum SpiEvent
+    {
+      SPI_BEGIN,    // CS active
+      SPI_COMMAND,  // command byte (DC low), value is the command
+      SPI_DATA,     // data byte (DC high), value is the byte
+      SPI_END,      // CS inactive
+      SPI_BUSY,     // busy wait done, value is the elapsed (or delayed) time in us
+      SPI_RESET     // reset pulse
+    };
+    typedef void (*SpiMonitor)(SpiEvent event, uint32_t value, void* pv);
+    // called for each event of the controllers connected through GxEPD2_EPD methods, 0 to remove
+    void setSpiMonitor(SpiMonitor monitor, void* pv = 0)
+    {
+      _spi_monitor = monitor;
+      _spi_monitor_pv = pv;
+    }
+    // sends a recorded event to the controller, for replay of traces; busy waits for the busy line, or value us if not connected
+    void replaySpiEvent(SpiEvent event, uint32_t value);
+#endif
   protected:
     void _reset();
     void _waitWhileBusy(const char* comment = 0, uint16_t busy_time = 5000);
@@ -105,7 +159,37 @@ class GxEPD2_EPD
     void _startTransfer();
     void _transfer(uint8_t value);
     void _endTransfer();
+    void _transfer(uint8_t* buffer, uint16_t n); // n bytes as one burst, buffer content is lost (full duplex)
+    // h rows of wb bytes of a bitmap with wb_bitmap bytes per row and h_bitmap rows, from byte column xb and row y, in one transfer
+    void _writeImageData(const uint8_t bitmap[], int16_t wb, int16_t h, int16_t wb_bitmap, int16_t h_bitmap, int16_t xb, int16_t y,
+                         bool invert, bool mirror_y, bool pgm);
+    template <bool pgm, bool invert> void _writeImageRows(const uint8_t* row, int16_t wb, int16_t h, int32_t row_step);
+    // one bit plane of h rows of wb bytes of a 2 bits per pixel bitmap with wb_bitmap bytes per row and h_bitmap rows,
+    // from plane byte column xb and row y, in one transfer; set bits select the darker waveforms, unless invert
+    void _writeGreyPlaneData(const uint8_t bitmap[], int16_t wb, int16_t h, int16_t wb_bitmap, int16_t h_bitmap, int16_t xb, int16_t y,
+                             bool lsb, bool invert, bool mirror_y, bool pgm);
+    template <bool pgm> void _writeGreyPlaneRows(const uint8_t* row, int16_t wb, int16_t h, int32_t row_step, int16_t row_bytes, bool lsb, uint8_t mask);
+    // rows are staged word aligned for word wise invert, and sent by burst of up to this size
+    static const uint16_t _stage_words = 16;
+    void _writeDataFill(uint8_t value, uint32_t n); // n data bytes of value, in one transfer
     bool _isUpdatingFull(const char* comment);  // Meshtastic: Determine if _waitWhileBusy() should be skipped (for async), by comparing the comment string..
+    // one byte of a bit plane from two bytes of a 2 bits per pixel bitmap; lsb false: most significant bits
+    static inline uint8_t _greyPlane(uint8_t b0, uint8_t b1, bool lsb)
+    {
+      if (lsb)
+      {
+        b0 <<= 1;
+        b1 <<= 1;
+      }
+      return _greyNibble(b0) | (_greyNibble(b1) >> 4);
+    }
+    // gathers bits 7, 5, 3, 1 into bits 7..4
+    static inline uint8_t _greyNibble(uint8_t b)
+    {
+      b &= 0xAA;
+      b = (b | (b << 1)) & 0xCC;
+      return (b | (b << 2)) & 0xF0;
+    }
   protected:
     int8_t _cs, _dc, _rst, _busy, _busy_level;
     uint32_t _busy_timeout;
@@ -116,6 +200,16 @@ class GxEPD2_EPD
     bool _init_display_done;
     uint16_t _reset_duration;
     SPIClass &_spi;
+#if ENABLE_GxEPD2_SPI_MONITOR
+    SpiMonitor _spi_monitor;
+    void* _spi_monitor_pv;
+#endif
+#if ENABLE_GxEPD2_TIMING_PROFILE
+    GxEPD2_TimingProfile _timing_profile;
+    unsigned long _async_full_start; // 0: no async full refresh pending
+    unsigned long _transfer_start;
+    uint32_t _transfer_n; // data bytes since _startTransfer()
+#endif
 };
 
 #endif
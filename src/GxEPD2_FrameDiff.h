@@ -0,0 +1,245 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Frame difference of two 1bpp frame buffers, compared word by word,
+// result is the number of flipped pixels and a short list of byte aligned changed rectangles.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_FrameDiff_H_
+#define _GxEPD2_FrameDiff_H_
+
+#include <Arduino.h>
+
+// maximum number of changed rectangles reported, nearest rectangles are merged if more
+#ifndef GxEPD2_FRAME_DIFF_MAX_RECTS
+#define GxEPD2_FRAME_DIFF_MAX_RECTS 4
+#endif
+
+// changed rows separated by up to this number of unchanged rows are reported in one rectangle
+#ifndef GxEPD2_FRAME_DIFF_MERGE_ROWS
+#define GxEPD2_FRAME_DIFF_MERGE_ROWS 8
+#endif
+
+class GxEPD2_FrameDiff
+{
+  public:
+#if UINTPTR_MAX > 0xFFFFFFFF
+    typedef uint64_t word_t;
+#else
+    typedef uint32_t word_t;
+#endif
+    struct Rect
+    {
+      uint16_t x, y, w, h; // x and w are multiple of 8
+    };
+    static const uint8_t max_rects = GxEPD2_FRAME_DIFF_MAX_RECTS;
+    static const uint32_t UNKNOWN = 0xFFFFFFFF;
+    // called at the end of each tile row with changes; flips[tiles] holds flipped pixels per tile of this tile row
+    typedef void (*TileRowFlips)(uint16_t ty, const uint16_t* flips, uint16_t tiles, const void* pv);
+    // results
+    uint32_t flipped; // pixels that differ, UNKNOWN if no previous frame to compare
+    uint8_t count;    // number of rectangles in rects, 0 if identical
+    Rect rects[max_rects];
+    Rect bounds;      // bounding box of all changes
+    GxEPD2_FrameDiff()
+    {
+      unknown(0, 0);
+    }
+    bool identical() const
+    {
+      return 0 == flipped;
+    }
+    // no previous frame: report whole frame as changed
+    void unknown(uint16_t width, uint16_t height)
+    {
+      flipped = UNKNOWN;
+      bounds.x = bounds.y = 0;
+      bounds.w = width;
+      bounds.h = height;
+      rects[0] = bounds;
+      count = (width > 0) && (height > 0) ? 1 : 0;
+    }
+    // compare frames of width x height pixels, rows padded to bytes, MSB is leftmost pixel
+    // optionally reports flipped pixels per tile of tile_size (multiple of 8) through tileRowFlips,
+    // tile_flips must have room for (width + tile_size - 1) / tile_size counters
+    void compare(const uint8_t* current, const uint8_t* previous, uint16_t width, uint16_t height,
+                 uint16_t tile_size = 0, uint16_t* tile_flips = 0, TileRowFlips tileRowFlips = 0, const void* pv = 0)
+    {
+      const uint16_t wb = (width + 7) / 8;
+      const uint16_t words = wb / sizeof(word_t);
+      const uint16_t tile_bytes = tile_size / 8;
+      const uint16_t tiles = tile_bytes ? (wb + tile_bytes - 1) / tile_bytes : 0;
+      const bool tiled = tile_flips && tileRowFlips && (tile_bytes > 0);
+      const bool word_in_tile = tiled && (tile_bytes % sizeof(word_t) == 0);
+      bool tile_row_changed = false;
+      flipped = 0;
+      count = 0;
+      uint16_t bx0 = wb, bx1 = 0, by0 = height, by1 = 0; // bounds, bytes and rows inclusive
+      bool band_open = false;
+      uint16_t band_x0 = 0, band_x1 = 0, band_y0 = 0, band_y1 = 0;
+      if (tiled) memset(tile_flips, 0, tiles * sizeof(uint16_t));
+      for (uint16_t row = 0; row < height; row++)
+      {
+        const uint8_t* c = current + uint32_t(row) * wb;
+        const uint8_t* p = previous + uint32_t(row) * wb;
+        uint16_t x0 = wb, x1 = 0; // changed bytes of this row, inclusive
+        for (uint16_t i = 0; i < words; i++)
+        {
+          word_t cw, pw;
+          memcpy(&cw, c + i * sizeof(word_t), sizeof(word_t));
+          memcpy(&pw, p + i * sizeof(word_t), sizeof(word_t));
+          word_t d = cw ^ pw;
+          if (!d) continue;
+          uint16_t first = i * sizeof(word_t) + _firstByte(d);
+          uint16_t last = i * sizeof(word_t) + _lastByte(d);
+          if (first < x0) x0 = first;
+          x1 = last;
+          uint16_t bits = _popcount(d);
+          flipped += bits;
+          if (word_in_tile) tile_flips[(i * sizeof(word_t)) / tile_bytes] += bits;
+          else if (tiled)
+          {
+            for (uint16_t b = first; b <= last; b++) tile_flips[b / tile_bytes] += _popcount(word_t(c[b] ^ p[b]));
+          }
+        }
+        for (uint16_t b = words * sizeof(word_t); b < wb; b++) // tail bytes
+        {
+          uint8_t d = c[b] ^ p[b];
+          if (!d) continue;
+          if (b < x0) x0 = b;
+          x1 = b;
+          uint16_t bits = _popcount(word_t(d));
+          flipped += bits;
+          if (tiled) tile_flips[b / tile_bytes] += bits;
+        }
+        if (x0 <= x1) // row changed
+        {
+          tile_row_changed = true;
+          if (x0 < bx0) bx0 = x0;
+          if (x1 > bx1) bx1 = x1;
+          if (row < by0) by0 = row;
+          by1 = row;
+          if (band_open && (row - band_y1 <= GxEPD2_FRAME_DIFF_MERGE_ROWS))
+          {
+            if (x0 < band_x0) band_x0 = x0;
+            if (x1 > band_x1) band_x1 = x1;
+            band_y1 = row;
+          }
+          else
+          {
+            if (band_open) _push(band_x0, band_y0, band_x1, band_y1);
+            band_open = true;
+            band_x0 = x0;
+            band_x1 = x1;
+            band_y0 = band_y1 = row;
+          }
+        }
+        if (tiled && ((row + 1) % tile_size == 0 || (row + 1) == height))
+        {
+          if (tile_row_changed)
+          {
+            tileRowFlips(row / tile_size, tile_flips, tiles, pv);
+            memset(tile_flips, 0, tiles * sizeof(uint16_t));
+          }
+          tile_row_changed = false;
+        }
+      }
+      if (band_open) _push(band_x0, band_y0, band_x1, band_y1);
+      if (count > 0)
+      {
+        bounds.x = bx0 * 8;
+        bounds.y = by0;
+        bounds.w = (bx1 - bx0 + 1) * 8;
+        bounds.h = by1 - by0 + 1;
+      }
+      else bounds.x = bounds.y = bounds.w = bounds.h = 0;
+    }
+    // number of changed pixels in rectangles, i.e. pixels transmitted for a refresh of all rects
+    uint32_t area() const
+    {
+      uint32_t a = 0;
+      for (uint8_t i = 0; i < count; i++) a += uint32_t(rects[i].w) * rects[i].h;
+      return a;
+    }
+  private:
+    // rectangles are pushed in ascending y order; if full, merge the pair with the smallest gap in y
+    void _push(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+    {
+      Rect r = {uint16_t(x0 * 8), y0, uint16_t((x1 - x0 + 1) * 8), uint16_t(y1 - y0 + 1)};
+      if (count < max_rects)
+      {
+        rects[count++] = r;
+        return;
+      }
+      uint8_t best = max_rects - 1; // merge r into last
+      uint16_t best_gap = r.y - (rects[max_rects - 1].y + rects[max_rects - 1].h);
+      for (uint8_t i = 0; i + 1 < max_rects; i++)
+      {
+        uint16_t gap = rects[i + 1].y - (rects[i].y + rects[i].h);
+        if (gap < best_gap)
+        {
+          best_gap = gap;
+          best = i;
+        }
+      }
+      Rect& a = rects[best];
+      const Rect& b = (best == max_rects - 1) ? r : rects[best + 1];
+      uint16_t xe = (a.x + a.w > b.x + b.w) ? a.x + a.w : b.x + b.w;
+      if (b.x < a.x) a.x = b.x;
+      a.w = xe - a.x;
+      a.h = b.y + b.h - a.y;
+      if (best < max_rects - 1)
+      {
+        for (uint8_t i = best + 1; i + 1 < max_rects; i++) rects[i] = rects[i + 1];
+        rects[max_rects - 1] = r;
+      }
+    }
+    static inline uint16_t _popcount(word_t d)
+    {
+#if UINTPTR_MAX > 0xFFFFFFFF
+      return __builtin_popcountll(d);
+#else
+      return __builtin_popcountl(d);
+#endif
+    }
+    // byte index in memory order of first and last non zero byte of d, loaded from memory
+    static inline uint8_t _firstByte(word_t d)
+    {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+      return _clz(d) / 8;
+#else
+      return _ctz(d) / 8;
+#endif
+    }
+    static inline uint8_t _lastByte(word_t d)
+    {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+      return (sizeof(word_t) * 8 - 1 - _ctz(d)) / 8;
+#else
+      return (sizeof(word_t) * 8 - 1 - _clz(d)) / 8;
+#endif
+    }
+    static inline uint8_t _ctz(word_t d)
+    {
+#if UINTPTR_MAX > 0xFFFFFFFF
+      return __builtin_ctzll(d);
+#else
+      return __builtin_ctzl(d);
+#endif
+    }
+    static inline uint8_t _clz(word_t d)
+    {
+#if UINTPTR_MAX > 0xFFFFFFFF
+      return __builtin_clzll(d);
+#else
+      return __builtin_clzl(d);
+#endif
+    }
+};
+
+#endif
@@ -0,0 +1,363 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// G4 decoder: streaming decoder of CCITT Group 4 (T.6, fax) compressed 1bpp images, pulled from a GxEPD2_ImageSource.
+// Each row is coded relative to the previous row, text and line art compress far better than with run length codes.
+// Decodes row by row, with two rows of state, to controller memory (write), or to the buffer of the template classes (draw).
+// Encode images with extras/tools/GxEPD2_PackBitmap -g.
+//
+// Format:
+//   header: 'G', '4', 0, 0, width (uint16_t), height (uint16_t), little endian
+//   data:   T.6 coded rows, most significant bit first, 0 is white, as TIFF compression 4 with fill order 1
+//   raw T.6 data without header, e.g. a single strip of a TIFF file, is decoded after begin(width, height)
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_G4Decoder_H_
+#define _GxEPD2_G4Decoder_H_
+
+#include "GxEPD2.h"
+#include "GxEPD2_ImageSource.h"
+
+// maximum width of images, two rows of width / 8 bytes are kept in the decoder
+#ifndef GxEPD2_G4_MAX_WIDTH
+#if defined(__AVR)
+#define GxEPD2_G4_MAX_WIDTH 400
+#else
+#define GxEPD2_G4_MAX_WIDTH 1872
+#endif
+#endif
+
+// bytes of the input buffer in the decoder
+#ifndef GxEPD2_G4_INPUT_SIZE
+#if defined(__AVR)
+#define GxEPD2_G4_INPUT_SIZE 16
+#else
+#define GxEPD2_G4_INPUT_SIZE 64
+#endif
+#endif
+
+class GxEPD2_G4Decoder
+{
+  public:
+    static const uint8_t header_size = 8;
+    // source positioned at the start of the image
+    GxEPD2_G4Decoder(GxEPD2_ImageSource& source) :
+      _source(source), _valid(false), _error(false), _w(0), _h(0), _row(0), _bits(0), _nbits(0), _in_pos(0), _in_len(0),
+      _ref(_rows[0]), _cur(_rows[1]) {};
+    // reads the header, leaves the source at the coded rows
+    bool begin()
+    {
+      uint8_t h[header_size];
+      if ((_source.read(h, header_size) < header_size) || (h[0] != 'G') || (h[1] != '4')) return _valid = false;
+      return begin(h[4] | uint16_t(h[5]) << 8, h[6] | uint16_t(h[7]) << 8);
+    };
+    // for raw T.6 data of width x height pixels, without header
+    bool begin(uint16_t width, uint16_t height)
+    {
+      _w = width;
+      _h = height;
+      _row = 0;
+      _bits = 0;
+      _nbits = 0;
+      _in_pos = 0;
+      _in_len = 0;
+      _error = false;
+      _valid = (_w > 0) && (_w <= GxEPD2_G4_MAX_WIDTH) && (_h > 0) && (_h <= 0x7FFF);
+      memset(_cur, 0xFF, sizeof(_rows[1])); // white reference row for the first row
+      return _valid;
+    };
+    bool valid() const
+    {
+      return _valid;
+    };
+    // the coded data is invalid or ended early
+    bool error() const
+    {
+      return _error;
+    };
+    uint16_t width() const
+    {
+      return _w;
+    };
+    uint16_t height() const
+    {
+      return _h;
+    };
+    uint16_t rowBytes() const
+    {
+      return (_w + 7) / 8;
+    };
+    // decodes the next row to (width + 7) / 8 bytes, bit 1 is white, 0 black, as for writeImage
+    // returns the index of the row, or -1 at end or on error
+    int16_t readRow(uint8_t* row)
+    {
+      if (!_next()) return -1;
+      memcpy(row, _cur, rowBytes());
+      return _row - 1;
+    };
+    // writes the image to controller memory of target, the display or display.epd2, at x, y, without refresh; x should be multiple of 8
+    // blocks of rows of up to GxEPD2_SOURCE_BLOCK_SIZE bytes, or parts of single rows
+    template <class Target> bool write(Target& target, int16_t x, int16_t y, bool invert = false)
+    {
+      if (!_valid || (_row != 0)) return false;
+      uint16_t wb = rowBytes();
+      uint16_t rows = GxEPD2_SOURCE_BLOCK_SIZE / wb;
+      if (rows > 0)
+      {
+        uint8_t block[GxEPD2_SOURCE_BLOCK_SIZE];
+        for (int16_t y1 = 0; y1 < _h; y1 += rows)
+        {
+          int16_t n = rows < _h - y1 ? rows : _h - y1;
+          for (int16_t i = 0; i < n; i++)
+          {
+            if (readRow(block + i * wb) < 0) return false;
+          }
+          target.writeImage(block, x, y + y1, _w, n, invert, false, false);
+        }
+      }
+      else
+      {
+        const uint16_t part = GxEPD2_SOURCE_BLOCK_SIZE * 8;
+        for (int16_t y1 = 0; y1 < _h; y1++)
+        {
+          if (!_next()) return false;
+          for (uint16_t x1 = 0; x1 < _w; x1 += part)
+          {
+            uint16_t w1 = part < _w - x1 ? part : _w - x1;
+            target.writeImage(_cur + x1 / 8, x + x1, y + y1, w1, 1, invert, false, false);
+          }
+        }
+      }
+      return true;
+    };
+    // draws the image to the buffer of gfx, e.g. inside the picture loop, with color for black and bg for white
+    // rows outside gfx.height() are decoded, not drawn
+    template <class GFX> bool draw(GFX& gfx, int16_t x, int16_t y, uint16_t color = GxEPD_BLACK, uint16_t bg = GxEPD_WHITE)
+    {
+      if (!_valid || (_row != 0)) return false;
+      while (_row < _h)
+      {
+        int16_t yrow = y + _row;
+        if (!_next()) return false;
+        if ((yrow >= 0) && (yrow < gfx.height())) gfx.drawBitmap(x, yrow, _cur, _w, 1, bg, color);
+      }
+      return true;
+    };
+  private:
+    enum Mode {PASS = 4, HORIZONTAL = 5, INVALID = 6}; // vertical modes are -3..3
+    // decodes the next row to _cur, the previous row is the reference
+    bool _next()
+    {
+      if (!_valid || (_row >= _h)) return false;
+      uint8_t* swap = _ref;
+      _ref = _cur;
+      _cur = swap;
+      memset(_cur, 0xFF, rowBytes());
+      int16_t a0 = -1;
+      bool black = false;
+      while (a0 < int16_t(_w))
+      {
+        int8_t mode = _mode();
+        int16_t b1 = _changing(_ref, a0);
+        if ((b1 < _w) && (_black(_ref, b1) == black)) b1 = _changing(_ref, b1); // of opposite color to a0
+        int16_t start = a0 < 0 ? 0 : a0;
+        if (mode == PASS)
+        {
+          int16_t b2 = b1 < _w ? _changing(_ref, b1) : _w;
+          if (black) _fill(start, b2);
+          a0 = b2;
+        }
+        else if (mode == HORIZONTAL)
+        {
+          int16_t r1 = _run(black);
+          int16_t r2 = _run(!black);
+          if ((r1 < 0) || (r2 < 0) || (int32_t(start) + r1 + r2 > _w)) break;
+          _fill(black ? start : start + r1, black ? start + r1 : start + r1 + r2);
+          a0 = start + r1 + r2;
+        }
+        else if (mode != INVALID)
+        {
+          int16_t a1 = b1 + mode;
+          if ((a1 < start) || (a1 > _w)) break;
+          if (black) _fill(start, a1);
+          a0 = a1;
+          black = !black;
+        }
+        else break;
+      }
+      if (a0 < int16_t(_w))
+      {
+        _error = true;
+        _valid = false;
+        return false;
+      }
+      _row++;
+      return true;
+    };
+    int8_t _mode()
+    {
+      uint8_t c = _peek(7);
+      if (c & 0x40) return _consume(1) ? 0 : INVALID; // 1: V0
+      if (c & 0x20) return _consume(3) ? (c & 0x10 ? 1 : -1) : INVALID; // 011: VR1, 010: VL1
+      if (c & 0x10) return _consume(3) ? HORIZONTAL : INVALID; // 001
+      if (c & 0x08) return _consume(4) ? PASS : INVALID; // 0001
+      if (c & 0x04) return _consume(6) ? (c & 0x02 ? 2 : -2) : INVALID; // 000011: VR2, 000010: VL2
+      if (c & 0x02) return _consume(7) ? (c & 0x01 ? 3 : -3) : INVALID; // 0000011: VR3, 0000010: VL3
+      return INVALID; // extensions, end of facsimile block or end of data
+    };
+    // run length of makeup codes followed by a terminating code, -1 on invalid code
+    int16_t _run(bool black)
+    {
+      int16_t run = 0;
+      while (true)
+      {
+        uint8_t length;
+        int16_t r = _code(black, _peek(13), length);
+        if ((r < 0) || !_consume(length)) return -1;
+        run += r;
+        if (r < 64) return run;
+        if (run > int16_t(_w)) return -1;
+      }
+    };
+    // T.4 run length codes, sorted by code length: code, code length << 12 | run length
+    static int16_t _code(bool black, uint16_t bits, uint8_t& length)
+    {
+      static const uint16_t white[][2] PROGMEM =
+      {
+        {0x7, 0x4002}, {0x8, 0x4003}, {0xB, 0x4004}, {0xC, 0x4005}, {0xE, 0x4006}, {0xF, 0x4007},
+        {0x13, 0x5008}, {0x14, 0x5009}, {0x7, 0x500A}, {0x8, 0x500B}, {0x1B, 0x5040}, {0x12, 0x5080},
+        {0x7, 0x6001}, {0x8, 0x600C}, {0x3, 0x600D}, {0x34, 0x600E}, {0x35, 0x600F}, {0x2A, 0x6010}, {0x2B, 0x6011},
+        {0x17, 0x60C0}, {0x18, 0x6680},
+        {0x27, 0x7012}, {0xC, 0x7013}, {0x8, 0x7014}, {0x17, 0x7015}, {0x3, 0x7016}, {0x4, 0x7017}, {0x28, 0x7018},
+        {0x2B, 0x7019}, {0x13, 0x701A}, {0x24, 0x701B}, {0x18, 0x701C}, {0x37, 0x7100},
+        {0x35, 0x8000}, {0x2, 0x801D}, {0x3, 0x801E}, {0x1A, 0x801F}, {0x1B, 0x8020}, {0x12, 0x8021}, {0x13, 0x8022},
+        {0x14, 0x8023}, {0x15, 0x8024}, {0x16, 0x8025}, {0x17, 0x8026}, {0x28, 0x8027}, {0x29, 0x8028}, {0x2A, 0x8029},
+        {0x2B, 0x802A}, {0x2C, 0x802B}, {0x2D, 0x802C}, {0x4, 0x802D}, {0x5, 0x802E}, {0xA, 0x802F}, {0xB, 0x8030},
+        {0x52, 0x8031}, {0x53, 0x8032}, {0x54, 0x8033}, {0x55, 0x8034}, {0x24, 0x8035}, {0x25, 0x8036}, {0x58, 0x8037},
+        {0x59, 0x8038}, {0x5A, 0x8039}, {0x5B, 0x803A}, {0x4A, 0x803B}, {0x4B, 0x803C}, {0x32, 0x803D}, {0x33, 0x803E},
+        {0x34, 0x803F}, {0x36, 0x8140}, {0x37, 0x8180}, {0x64, 0x81C0}, {0x65, 0x8200}, {0x68, 0x8240}, {0x67, 0x8280},
+        {0xCC, 0x92C0}, {0xCD, 0x9300}, {0xD2, 0x9340}, {0xD3, 0x9380}, {0xD4, 0x93C0}, {0xD5, 0x9400}, {0xD6, 0x9440},
+        {0xD7, 0x9480}, {0xD8, 0x94C0}, {0xD9, 0x9500}, {0xDA, 0x9540}, {0xDB, 0x9580}, {0x98, 0x95C0}, {0x99, 0x9600},
+        {0x9A, 0x9640}, {0x9B, 0x96C0}
+      };
+      static const uint16_t black_codes[][2] PROGMEM =
+      {
+        {0x3, 0x2002}, {0x2, 0x2003}, {0x2, 0x3001}, {0x3, 0x3004}, {0x3, 0x4005}, {0x2, 0x4006}, {0x3, 0x5007},
+        {0x5, 0x6008}, {0x4, 0x6009}, {0x4, 0x700A}, {0x5, 0x700B}, {0x7, 0x700C}, {0x4, 0x800D}, {0x7, 0x800E},
+        {0x18, 0x900F},
+        {0x37, 0xA000}, {0x17, 0xA010}, {0x18, 0xA011}, {0x8, 0xA012}, {0xF, 0xA040},
+        {0x67, 0xB013}, {0x68, 0xB014}, {0x6C, 0xB015}, {0x37, 0xB016}, {0x28, 0xB017}, {0x17, 0xB018}, {0x18, 0xB019},
+        {0xCA, 0xC01A}, {0xCB, 0xC01B}, {0xCC, 0xC01C}, {0xCD, 0xC01D}, {0x68, 0xC01E}, {0x69, 0xC01F}, {0x6A, 0xC020},
+        {0x6B, 0xC021}, {0xD2, 0xC022}, {0xD3, 0xC023}, {0xD4, 0xC024}, {0xD5, 0xC025}, {0xD6, 0xC026}, {0xD7, 0xC027},
+        {0x6C, 0xC028}, {0x6D, 0xC029}, {0xDA, 0xC02A}, {0xDB, 0xC02B}, {0x54, 0xC02C}, {0x55, 0xC02D}, {0x56, 0xC02E},
+        {0x57, 0xC02F}, {0x64, 0xC030}, {0x65, 0xC031}, {0x52, 0xC032}, {0x53, 0xC033}, {0x24, 0xC034}, {0x37, 0xC035},
+        {0x38, 0xC036}, {0x27, 0xC037}, {0x28, 0xC038}, {0x58, 0xC039}, {0x59, 0xC03A}, {0x2B, 0xC03B}, {0x2C, 0xC03C},
+        {0x5A, 0xC03D}, {0x66, 0xC03E}, {0x67, 0xC03F}, {0xC8, 0xC080}, {0xC9, 0xC0C0}, {0x5B, 0xC100}, {0x33, 0xC140},
+        {0x34, 0xC180}, {0x35, 0xC1C0},
+        {0x6C, 0xD200}, {0x6D, 0xD240}, {0x4A, 0xD280}, {0x4B, 0xD2C0}, {0x4C, 0xD300}, {0x4D, 0xD340}, {0x72, 0xD380},
+        {0x73, 0xD3C0}, {0x74, 0xD400}, {0x75, 0xD440}, {0x76, 0xD480}, {0x77, 0xD4C0}, {0x52, 0xD500}, {0x53, 0xD540},
+        {0x54, 0xD580}, {0x55, 0xD5C0}, {0x5A, 0xD600}, {0x5B, 0xD640}, {0x64, 0xD680}, {0x65, 0xD6C0}
+      };
+      static const uint16_t extended[][2] PROGMEM = // makeup codes of both colors
+      {
+        {0x8, 0xB700}, {0xC, 0xB740}, {0xD, 0xB780}, {0x12, 0xC7C0}, {0x13, 0xC800}, {0x14, 0xC840}, {0x15, 0xC880},
+        {0x16, 0xC8C0}, {0x17, 0xC900}, {0x1C, 0xC940}, {0x1D, 0xC980}, {0x1E, 0xC9C0}, {0x1F, 0xCA00}
+      };
+      int16_t r = black ? _find(black_codes, sizeof(black_codes) / sizeof(black_codes[0]), bits, length)
+                  : _find(white, sizeof(white) / sizeof(white[0]), bits, length);
+      return r >= 0 ? r : _find(extended, sizeof(extended) / sizeof(extended[0]), bits, length);
+    };
+    static int16_t _find(const uint16_t table[][2], uint8_t n, uint16_t bits, uint8_t& length)
+    {
+      for (uint8_t i = 0; i < n; i++)
+      {
+        uint16_t e = _word(&table[i][1]);
+        length = e >> 12;
+        if ((bits >> (13 - length)) == _word(&table[i][0])) return e & 0x0FFF;
+      }
+      return -1;
+    };
+    static uint16_t _word(const uint16_t* p)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      return pgm_read_word(p);
+#else
+      return *p;
+#endif
+    };
+    // next n bits, zeros past the end of data
+    uint16_t _peek(uint8_t n)
+    {
+      while (_nbits <= 24)
+      {
+        if (_in_pos >= _in_len)
+        {
+          _in_len = _source.read(_in, sizeof(_in));
+          _in_pos = 0;
+          if (_in_len == 0) break;
+        }
+        _bits |= uint32_t(_in[_in_pos++]) << (24 - _nbits);
+        _nbits += 8;
+      }
+      return _bits >> (32 - n);
+    };
+    bool _consume(uint8_t n)
+    {
+      if (n > _nbits) return false;
+      _bits <<= n;
+      _nbits -= n;
+      return true;
+    };
+    bool _black(const uint8_t* row, int16_t i) const
+    {
+      return !(row[i >> 3] & (0x80 >> (i & 7)));
+    };
+    // position of the first pixel after i with a color different from pixel i, pixel -1 is white; width if none
+    int16_t _changing(const uint8_t* row, int16_t i) const
+    {
+      bool black = (i >= 0) && _black(row, i);
+      int16_t w = _w;
+      for (i++; (i < w) && (i & 7); i++)
+      {
+        if (_black(row, i) != black) return i;
+      }
+      uint8_t same = black ? 0x00 : 0xFF;
+      while ((i < w) && (row[i >> 3] == same)) i += 8;
+      for (; i < w; i++)
+      {
+        if (_black(row, i) != black) return i;
+      }
+      return w;
+    };
+    // black pixels from, to (exclusive) of the current row
+    void _fill(int16_t from, int16_t to)
+    {
+      if (from >= to) return;
+      uint16_t i = from >> 3, j = (to - 1) >> 3;
+      uint8_t first = 0xFF >> (from & 7);
+      uint8_t last = 0xFF << (7 - ((to - 1) & 7));
+      if (i == j) _cur[i] &= ~(first & last);
+      else
+      {
+        _cur[i] &= ~first;
+        memset(_cur + i + 1, 0, j - i - 1);
+        _cur[j] &= ~last;
+      }
+    };
+    GxEPD2_ImageSource& _source;
+    bool _valid, _error;
+    uint16_t _w, _h, _row;
+    uint32_t _bits;
+    uint8_t _nbits, _in_pos, _in_len;
+    uint8_t _in[GxEPD2_G4_INPUT_SIZE];
+    uint8_t _rows[2][(GxEPD2_G4_MAX_WIDTH + 7) / 8];
+    uint8_t* _ref;
+    uint8_t* _cur;
+};
+
+#endif
@@ -58,6 +58,8 @@ class GxEPD2_GFX : public GxEPD2_GFX_ROOT_CLASS
     virtual void firstPage() = 0;
     virtual bool nextPage() = 0;
     virtual void drawPaged(void (*drawCallback)(const void*), const void* pv) = 0;
+    // the part of the screen covered by the current page, in coordinates of the actual rotation
+    virtual void pageWindow(int16_t& x, int16_t& y, int16_t& w, int16_t& h) = 0;
     virtual void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color) = 0;
     //  Support for Bitmaps (Sprites) to Controller Buffer and to Screen
     virtual void clearScreen(uint8_t value = 0xFF) = 0; // init controller memory and screen (default white)
@@ -74,6 +76,14 @@ class GxEPD2_GFX : public GxEPD2_GFX_ROOT_CLASS
                                 int16_t x, int16_t y, int16_t w, int16_t h) = 0; // default options false
     // write sprite of native data to controller memory, without screen refresh; x and w should be multiple of 8
     virtual void writeNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
+    // write image or native data pulled from source, by blocks of rows, to controller memory, without screen refresh; x and w should be multiple of 8
+    virtual void writeImage(GxEPD2_ImageSource& source, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false) = 0;
+    virtual void writeImagePart(GxEPD2_ImageSource& source, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false) = 0;
+    virtual void writeImage(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false) = 0;
+    virtual void writeImagePart(GxEPD2_ImageSource& black, GxEPD2_ImageSource& color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false) = 0;
+    virtual void writeNative(GxEPD2_ImageSource& data1, GxEPD2_ImageSource* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false) = 0;
     // write to controller memory, with screen refresh; x and w should be multiple of 8
     virtual void drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false) = 0;
     virtual void drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
@@ -0,0 +1,221 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Ghosting budget: coarse per tile account of fast partial refreshes since the last cleanup refresh.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_Ghosting_H_
+#define _GxEPD2_Ghosting_H_
+
+#include <Arduino.h>
+
+// tile edge length in pixels, native panel orientation; a multiple of 8 keeps tiles byte aligned
+#ifndef GxEPD2_GHOSTING_TILE_SIZE
+#define GxEPD2_GHOSTING_TILE_SIZE 32
+#endif
+
+// weight added to a tile by a fast partial refresh that flipped every pixel of the tile,
+// also used if the number of flipped pixels is unknown
+#ifndef GxEPD2_GHOSTING_FULL_WEIGHT
+#define GxEPD2_GHOSTING_FULL_WEIGHT 4
+#endif
+
+// default limits, in units of GxEPD2_GHOSTING_FULL_WEIGHT, i.e. number of fast "all pixels flipped" refreshes
+#ifndef GxEPD2_GHOSTING_TILE_LIMIT
+#define GxEPD2_GHOSTING_TILE_LIMIT 10
+#endif
+#ifndef GxEPD2_GHOSTING_SCREEN_PERCENT
+#define GxEPD2_GHOSTING_SCREEN_PERCENT 50 // full cleanup if more than this percentage of tiles are over limit
+#endif
+
+class GxEPD2_Ghosting
+{
+  public:
+    enum Cleanup
+    {
+      NONE = 0,   // no cleanup needed
+      REGION = 1, // region needs a full waveform refresh
+      FULL = 2    // whole screen needs a full refresh
+    };
+    static const uint32_t UNKNOWN_FLIPS = 0xFFFFFFFF;
+    // policy hook: decides the cleanup needed from the budget, fills region (native coordinates)
+    typedef Cleanup (*Policy)(const GxEPD2_Ghosting& budget, uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h, const void* pv);
+    // attributes
+    const uint16_t tiles_x, tiles_y;
+    // tiles is storage for tiles_x * tiles_y counters, see GxEPD2_GhostingTiles
+    GxEPD2_Ghosting(uint8_t* tiles, uint16_t width, uint16_t height) :
+      tiles_x((width + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE),
+      tiles_y((height + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE),
+      _width(width), _height(height), _tiles(tiles), _policy(0), _policy_pv(0)
+    {
+      _tile_limit = GxEPD2_GHOSTING_TILE_LIMIT * GxEPD2_GHOSTING_FULL_WEIGHT;
+      _screen_percent = GxEPD2_GHOSTING_SCREEN_PERCENT;
+      clear();
+    }
+    // all counters to zero, e.g. after full refresh
+    void clear()
+    {
+      memset(_tiles, 0, uint32_t(tiles_x) * tiles_y);
+      _fraction = 0;
+    }
+    // counters of all tiles completely inside the area to zero, e.g. after a region limited full waveform refresh
+    void clear(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+    {
+      if ((w == 0) || (h == 0)) return;
+      uint16_t tx0 = (x + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE;
+      uint16_t ty0 = (y + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE;
+      uint16_t tx1 = (x + w) >= _width ? tiles_x : (x + w) / GxEPD2_GHOSTING_TILE_SIZE;
+      uint16_t ty1 = (y + h) >= _height ? tiles_y : (y + h) / GxEPD2_GHOSTING_TILE_SIZE;
+      for (uint16_t ty = ty0; ty < ty1; ty++)
+      {
+        for (uint16_t tx = tx0; tx < tx1; tx++) _tiles[ty * tiles_x + tx] = 0;
+      }
+    }
+    // account a fast partial refresh of area (native coordinates), with flipped pixels of the area if known
+    void addFastRefresh(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint32_t flipped = UNKNOWN_FLIPS)
+    {
+      if ((w == 0) || (h == 0) || (x >= _width) || (y >= _height)) return;
+      if (x + w > _width) w = _width - x;
+      if (y + h > _height) h = _height - y;
+      uint16_t tx1 = (x + w - 1) / GxEPD2_GHOSTING_TILE_SIZE;
+      uint16_t ty1 = (y + h - 1) / GxEPD2_GHOSTING_TILE_SIZE;
+      if (flipped == UNKNOWN_FLIPS)
+      {
+        for (uint16_t ty = y / GxEPD2_GHOSTING_TILE_SIZE; ty <= ty1; ty++)
+        {
+          for (uint16_t tx = x / GxEPD2_GHOSTING_TILE_SIZE; tx <= tx1; tx++) _add(tx, ty, GxEPD2_GHOSTING_FULL_WEIGHT);
+        }
+        return;
+      }
+      // only the total is known: flips spread evenly over the area, weight per tile in 1/65536 units,
+      // rounded down with the remainder carried to the next tile and the next refresh; few flips don't charge every tile
+      uint32_t area = uint32_t(w) * h;
+      if (flipped > area) flipped = area;
+      uint32_t share = uint32_t((uint64_t(flipped) * GxEPD2_GHOSTING_FULL_WEIGHT << 16) / area);
+      for (uint16_t ty = y / GxEPD2_GHOSTING_TILE_SIZE; ty <= ty1; ty++)
+      {
+        for (uint16_t tx = x / GxEPD2_GHOSTING_TILE_SIZE; tx <= tx1; tx++)
+        {
+          uint32_t weight = _fraction + share;
+          _fraction = weight & 0xFFFF;
+          if (weight >> 16) _add(tx, ty, weight >> 16);
+        }
+      }
+    }
+    // account flipped pixels of one tile, for callers that know per tile differences
+    void addTileFlips(uint16_t tx, uint16_t ty, uint16_t flipped)
+    {
+      if ((tx >= tiles_x) || (ty >= tiles_y) || (0 == flipped)) return;
+      uint16_t tile_pixels = GxEPD2_GHOSTING_TILE_SIZE * GxEPD2_GHOSTING_TILE_SIZE;
+      if (flipped > tile_pixels) flipped = tile_pixels;
+      _add(tx, ty, (uint32_t(flipped) * GxEPD2_GHOSTING_FULL_WEIGHT + tile_pixels - 1) / tile_pixels);
+    }
+    uint8_t tile(uint16_t tx, uint16_t ty) const
+    {
+      return ((tx < tiles_x) && (ty < tiles_y)) ? _tiles[ty * tiles_x + tx] : 0;
+    }
+    // tile_limit in counter units, screen_percent of tiles over limit that needs full cleanup
+    void setLimits(uint8_t tile_limit, uint8_t screen_percent)
+    {
+      _tile_limit = tile_limit;
+      _screen_percent = screen_percent;
+    }
+    uint8_t tileLimit() const
+    {
+      return _tile_limit;
+    }
+    uint8_t screenPercent() const
+    {
+      return _screen_percent;
+    }
+    // replace the default policy, 0 restores default
+    void setPolicy(Policy policy, const void* pv = 0)
+    {
+      _policy = policy;
+      _policy_pv = pv;
+    }
+    // cleanup needed? region is set to the area to clean (native coordinates)
+    Cleanup cleanupNeeded(uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h) const
+    {
+      x = y = w = h = 0;
+      if (_policy) return _policy(*this, x, y, w, h, _policy_pv);
+      return defaultPolicy(*this, x, y, w, h, 0);
+    }
+    // default policy: clean bounding box of tiles over limit, or full screen if too many tiles are over limit
+    static Cleanup defaultPolicy(const GxEPD2_Ghosting& budget, uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h, const void* pv)
+    {
+      uint16_t count = budget.overLimit(budget._tile_limit, x, y, w, h);
+      if (0 == count) return NONE;
+      if (uint32_t(count) * 100 > uint32_t(budget._screen_percent) * budget.tiles_x * budget.tiles_y)
+      {
+        x = y = 0;
+        w = budget._width;
+        h = budget._height;
+        return FULL;
+      }
+      return REGION;
+    }
+    // number of tiles with counter >= limit, and their bounding box (native coordinates)
+    uint16_t overLimit(uint8_t limit, uint16_t& x, uint16_t& y, uint16_t& w, uint16_t& h) const
+    {
+      uint16_t count = 0;
+      uint16_t tx0 = tiles_x, ty0 = tiles_y, tx1 = 0, ty1 = 0;
+      for (uint16_t ty = 0; ty < tiles_y; ty++)
+      {
+        for (uint16_t tx = 0; tx < tiles_x; tx++)
+        {
+          if (_tiles[ty * tiles_x + tx] < limit) continue;
+          count++;
+          if (tx < tx0) tx0 = tx;
+          if (ty < ty0) ty0 = ty;
+          if (tx > tx1) tx1 = tx;
+          if (ty > ty1) ty1 = ty;
+        }
+      }
+      if (count > 0)
+      {
+        x = tx0 * GxEPD2_GHOSTING_TILE_SIZE;
+        y = ty0 * GxEPD2_GHOSTING_TILE_SIZE;
+        w = (tx1 + 1) * GxEPD2_GHOSTING_TILE_SIZE - x;
+        h = (ty1 + 1) * GxEPD2_GHOSTING_TILE_SIZE - y;
+        if (x + w > _width) w = _width - x;
+        if (y + h > _height) h = _height - y;
+      }
+      return count;
+    }
+  protected:
+    void _add(uint16_t tx, uint16_t ty, uint8_t weight)
+    {
+      uint8_t& t = _tiles[ty * tiles_x + tx];
+      t = (t > 255 - weight) ? 255 : t + weight; // saturate
+    }
+  protected:
+    const uint16_t _width, _height;
+    uint8_t* _tiles;
+    uint16_t _fraction; // of weight, carried by addFastRefresh() with flips known as total only
+    uint8_t _tile_limit, _screen_percent;
+    Policy _policy;
+    const void* _policy_pv;
+};
+
+// budget with its own tile storage, for a panel of width x height
+template<uint16_t width, uint16_t height>
+class GxEPD2_GhostingTiles : public GxEPD2_Ghosting
+{
+  public:
+    GxEPD2_GhostingTiles() : GxEPD2_Ghosting(_storage, width, height) {}
+    GxEPD2_GhostingTiles(const GxEPD2_GhostingTiles& from) : GxEPD2_Ghosting(from)
+    {
+      _tiles = _storage; // don't share storage with copy source
+      memcpy(_storage, from._storage, sizeof(_storage));
+    }
+  private:
+    uint8_t _storage[((width + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE) * ((height + GxEPD2_GHOSTING_TILE_SIZE - 1) / GxEPD2_GHOSTING_TILE_SIZE)];
+};
+
+#endif
@@ -0,0 +1,380 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// HTTP source: image source for the body of an HTTP response, for GxEPD2_BmpDecoder or writeImage() with an image source.
+// The body is pulled from the client by bulk reads into a ring buffer, as much as is available and fits;
+// the network stack keeps receiving while rows are sent to the controller, the free space of the ring is the backpressure.
+// Handles Content-Length and chunked transfer encoding; progress callback and abort.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_HttpSource_H_
+#define _GxEPD2_HttpSource_H_
+
+#include <Arduino.h>
+#include "GxEPD2_ImageSource.h"
+
+// ClientT: a connected client with available(), read(), read(buffer, n) and connected(), e.g. WiFiClient, WiFiClientSecure, EthernetClient
+// the request is sent by the caller; ring is the ring buffer, e.g. 2k..8k on ESP8266 or ESP32
+template <class ClientT> class GxEPD2_HttpSource : public GxEPD2_ImageSource
+{
+  public:
+    // called after bytes have been received; received and total are body bytes, total is 0 if unknown; return false to abort
+    typedef bool (*Progress)(uint32_t received, uint32_t total, void* context);
+    GxEPD2_HttpSource(ClientT& client, uint8_t* ring, uint16_t size, uint32_t timeout_ms = 10000) :
+      _client(client), _ring(ring), _size(size), _head(0), _tail(0), _count(0), _timeout(timeout_ms),
+      _status(0), _length(0), _received(0), _consumed(0), _chunked(false), _complete(false), _aborted(false), _timed_out(false),
+      _chunk_state(CHUNK_SIZE), _chunk_remaining(0), _chunk_line(0), _progress(0), _context(0) {};
+    // reads the status line and the headers, the headers byte by byte; returns true for status 200
+    bool begin()
+    {
+      char line[80];
+      bool first = true;
+      while (true)
+      {
+        uint8_t n = 0;
+        bool truncated = false;
+        int c;
+        while ((c = _byte()) >= 0)
+        {
+          if (c == '\n') break;
+          if (c == '\r') continue;
+          if (n < sizeof(line) - 1) line[n++] = c;
+          else truncated = true;
+        }
+        if (c < 0) return false; // timeout or closed
+        line[n] = 0;
+        if (first)
+        {
+          if (!_starts(line, "http/")) return false;
+          const char* code = strchr(line, ' ');
+          _status = code ? atoi(code + 1) : 0;
+          first = false;
+        }
+        else if (n == 0) break; // end of headers
+        else if (truncated) continue;
+        else if (_starts(line, "content-length:")) _length = strtoul(line + 15, 0, 10);
+        else if (_starts(line, "transfer-encoding:") && _contains(line + 18, "chunked")) _chunked = true;
+      }
+      if (_chunked) _length = 0; // without Content-Length and not chunked the body ends at close
+      return _status == 200;
+    };
+    void onProgress(Progress progress, void* context = 0)
+    {
+      _progress = progress;
+      _context = context;
+    };
+    // stops the transfer, following reads return short; the caller should stop() the client
+    void abort()
+    {
+      _aborted = true;
+    };
+    // pulls the bytes available from the client into the ring buffer, without waiting; called by read() and skip()
+    // may be called while waiting on something else, e.g. the busy line, to keep the connection flowing; returns bytes added
+    uint16_t pump()
+    {
+      uint32_t before = _received;
+      while (!_aborted && !_complete && (_count < _size))
+      {
+        int available = _client.available();
+        if (available <= 0) break;
+        if ((_chunked ? _pumpChunked(available) : _pumpPlain(available)) <= 0) break;
+      }
+      uint16_t added = _received - before;
+      if ((added > 0) && _progress && !_progress(_received, _length, _context)) _aborted = true;
+      return added;
+    };
+    uint16_t read(uint8_t* buffer, uint16_t n)
+    {
+      return _pull(buffer, n);
+    };
+    void skip(uint32_t n)
+    {
+      while (n > 0)
+      {
+        uint16_t c = n < 0x8000 ? n : 0x8000;
+        if (_pull(0, c) < c) return;
+        n -= c;
+      }
+    };
+    // HTTP status code, 0 before begin() or if the status line is invalid
+    int status() const
+    {
+      return _status;
+    };
+    // Content-Length of the body, 0 if unknown, e.g. for chunked transfer encoding
+    uint32_t total() const
+    {
+      return _length;
+    };
+    // body bytes received into the ring buffer, and passed on by read() or skip()
+    uint32_t received() const
+    {
+      return _received;
+    };
+    uint32_t consumed() const
+    {
+      return _consumed;
+    };
+    uint16_t buffered() const
+    {
+      return _count;
+    };
+    bool chunked() const
+    {
+      return _chunked;
+    };
+    // the whole body has been received, by Content-Length or the last chunk
+    bool complete() const
+    {
+      return _complete;
+    };
+    bool aborted() const
+    {
+      return _aborted;
+    };
+    bool timedOut() const
+    {
+      return _timed_out;
+    };
+  private:
+    enum ChunkState {CHUNK_SIZE, CHUNK_EXTENSION, CHUNK_DATA, CHUNK_DATA_END, CHUNK_TRAILER, CHUNK_DONE};
+    // copies n bytes from the ring buffer to buffer, or drops them if buffer is 0; waits for data up to the timeout
+    uint16_t _pull(uint8_t* buffer, uint16_t n)
+    {
+      uint16_t done = 0;
+      uint32_t start = millis();
+      while ((done < n) && !_aborted)
+      {
+        pump();
+        if (_count == 0)
+        {
+          if (_complete || (!_client.connected() && (_client.available() <= 0))) break;
+          if (millis() - start > _timeout)
+          {
+            _timed_out = true;
+            break;
+          }
+          delay(1); // lets the network stack receive
+          continue;
+        }
+        uint16_t c = n - done;
+        if (c > _count) c = _count;
+        if (c > _size - _tail) c = _size - _tail; // contiguous
+        if (buffer) memcpy(buffer + done, _ring + _tail, c);
+        _tail = (_tail + c) % _size;
+        _count -= c;
+        done += c;
+        start = millis();
+      }
+      _consumed += done;
+      return done;
+    };
+    // reads body bytes directly into the free space of the ring; returns bytes read from the client
+    int _pumpPlain(int available)
+    {
+      uint16_t c = _size - _count;
+      if (c > _size - _head) c = _size - _head; // contiguous
+      if (uint32_t(available) < c) c = available;
+      if ((_length > 0) && (_length - _received < c)) c = _length - _received;
+      int got = _client.read(_ring + _head, c);
+      if (got <= 0) return 0;
+      _put(got);
+      if ((_length > 0) && (_received >= _length)) _complete = true;
+      return got;
+    };
+    // reads raw bytes into a small buffer and passes on the chunk data; raw bytes are at least as many as data bytes
+    int _pumpChunked(int available)
+    {
+      uint8_t raw[64];
+      uint16_t c = _size - _count;
+      if (c > sizeof(raw)) c = sizeof(raw);
+      if (uint32_t(available) < c) c = available;
+      int got = _client.read(raw, c);
+      if (got <= 0) return 0;
+      for (int i = 0; (i < got) && (_chunk_state != CHUNK_DONE); i++)
+      {
+        uint8_t b = raw[i];
+        switch (_chunk_state)
+        {
+          case CHUNK_SIZE:
+            if ((b >= '0') && (b <= '9')) _chunk_remaining = (_chunk_remaining << 4) | (b - '0');
+            else if (((b | 0x20) >= 'a') && ((b | 0x20) <= 'f')) _chunk_remaining = (_chunk_remaining << 4) | ((b | 0x20) - 'a' + 10);
+            else if (b == '\n') _chunk_state = _chunk_remaining > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+            else if (b != '\r') _chunk_state = CHUNK_EXTENSION;
+            break;
+          case CHUNK_EXTENSION:
+            if (b == '\n') _chunk_state = _chunk_remaining > 0 ? CHUNK_DATA : CHUNK_TRAILER;
+            break;
+          case CHUNK_DATA:
+            {
+              uint16_t n = got - i;
+              if (_chunk_remaining < n) n = _chunk_remaining;
+              for (uint16_t k = 0; k < n; k++)
+              {
+                _ring[_head] = raw[i + k];
+                _head = (_head + 1) % _size;
+              }
+              _count += n;
+              _received += n;
+              _chunk_remaining -= n;
+              i += n - 1;
+              if (_chunk_remaining == 0) _chunk_state = CHUNK_DATA_END;
+            }
+            break;
+          case CHUNK_DATA_END:
+            if (b == '\n') _chunk_state = CHUNK_SIZE;
+            break;
+          case CHUNK_TRAILER: // trailer lines up to the empty line
+            if (b == '\n')
+            {
+              if (_chunk_line == 0) _chunk_state = CHUNK_DONE;
+              _chunk_line = 0;
+            }
+            else if (b != '\r') _chunk_line++;
+            break;
+          case CHUNK_DONE:
+            break;
+        }
+      }
+      if (_chunk_state == CHUNK_DONE) _complete = true;
+      return got;
+    };
+    void _put(uint16_t n)
+    {
+      _head = (_head + n) % _size;
+      _count += n;
+      _received += n;
+    };
+    // next header byte, -1 on timeout or close
+    int _byte()
+    {
+      uint32_t start = millis();
+      while (_client.available() <= 0)
+      {
+        if (!_client.connected() || (millis() - start > _timeout)) return -1;
+        delay(1);
+      }
+      return _client.read();
+    };
+    // case insensitive
+    static bool _starts(const char* line, const char* lower)
+    {
+      for (; *lower; line++, lower++)
+      {
+        char c = *line;
+        if ((c >= 'A') && (c <= 'Z')) c += 'a' - 'A';
+        if (c != *lower) return false;
+      }
+      return true;
+    };
+    static bool _contains(const char* line, const char* lower)
+    {
+      for (; *line; line++)
+      {
+        if (_starts(line, lower)) return true;
+      }
+      return false;
+    };
+    ClientT& _client;
+    uint8_t* _ring;
+    uint16_t _size, _head, _tail, _count;
+    uint32_t _timeout;
+    int _status;
+    uint32_t _length, _received, _consumed;
+    bool _chunked, _complete, _aborted, _timed_out;
+    ChunkState _chunk_state;
+    uint32_t _chunk_remaining;
+    uint16_t _chunk_line;
+    Progress _progress;
+    void* _context;
+};
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+#include <netdb.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// host side: TCP client with the methods used by GxEPD2_HttpSource, e.g. for tests against a local HTTP server
+class GxEPD2_PosixClient
+{
+  public:
+    GxEPD2_PosixClient() : _fd(-1) {};
+    ~GxEPD2_PosixClient()
+    {
+      stop();
+    };
+    bool connect(const char* host, uint16_t port)
+    {
+      stop();
+      struct addrinfo hints, *list = 0;
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      char service[8];
+      snprintf(service, sizeof(service), "%u", port);
+      if (getaddrinfo(host, service, &hints, &list) != 0) return false;
+      for (struct addrinfo* a = list; a && (_fd < 0); a = a->ai_next)
+      {
+        _fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if ((_fd >= 0) && (::connect(_fd, a->ai_addr, a->ai_addrlen) != 0)) stop();
+      }
+      freeaddrinfo(list);
+      return _fd >= 0;
+    };
+    size_t write(const uint8_t* buffer, size_t n)
+    {
+      size_t done = 0;
+      while ((_fd >= 0) && (done < n))
+      {
+        ssize_t sent = send(_fd, buffer + done, n - done, 0);
+        if (sent <= 0) break;
+        done += sent;
+      }
+      return done;
+    };
+    size_t print(const char* s)
+    {
+      return write((const uint8_t*)s, strlen(s));
+    };
+    int available()
+    {
+      int n = 0;
+      if ((_fd < 0) || (ioctl(_fd, FIONREAD, &n) != 0)) return 0;
+      return n;
+    };
+    int read(uint8_t* buffer, size_t n)
+    {
+      if (_fd < 0) return -1;
+      ssize_t got = recv(_fd, buffer, n, MSG_DONTWAIT);
+      return got > 0 ? int(got) : -1;
+    };
+    int read()
+    {
+      uint8_t b;
+      return read(&b, 1) == 1 ? b : -1;
+    };
+    // open and not closed by the peer
+    uint8_t connected()
+    {
+      if (_fd < 0) return false;
+      uint8_t b;
+      return recv(_fd, &b, 1, MSG_PEEK | MSG_DONTWAIT) != 0;
+    };
+    void stop()
+    {
+      if (_fd >= 0) close(_fd);
+      _fd = -1;
+    };
+  private:
+    GxEPD2_PosixClient(const GxEPD2_PosixClient&);
+    int _fd;
+};
+#endif
+
+#endif
@@ -0,0 +1,247 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Image sources: pull based sources of bitmap rows for writeImage(), writeImagePart() and writeNative() of the template classes.
+// Rows are pulled by blocks into a buffer on the stack and written to controller memory block by block,
+// e.g. from SD, SPIFFS, SerialFlash or a network stream, without a full frame buffer in RAM.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_ImageSource_H_
+#define _GxEPD2_ImageSource_H_
+
+#include <Arduino.h>
+
+#if defined(ESP8266) || defined(ESP32)
+#include <pgmspace.h>
+#elif defined(__AVR)
+#include <avr/pgmspace.h>
+#endif
+
+// bytes of the block buffer on the stack, per plane; blocks of rows, or parts of one row, are pulled into it
+#ifndef GxEPD2_SOURCE_BLOCK_SIZE
+#if defined(__AVR)
+#define GxEPD2_SOURCE_BLOCK_SIZE 64
+#else
+#define GxEPD2_SOURCE_BLOCK_SIZE 512
+#endif
+#endif
+
+class GxEPD2_ImageSource
+{
+  public:
+    virtual ~GxEPD2_ImageSource() {};
+    // copies the next n bytes to buffer, returns the number of bytes copied, less than n at end of source
+    virtual uint16_t read(uint8_t* buffer, uint16_t n) = 0;
+    // skips the next n bytes, sources that can seek should override
+    virtual void skip(uint32_t n)
+    {
+      uint8_t buffer[16];
+      while (n > 0)
+      {
+        uint16_t c = n < sizeof(buffer) ? n : sizeof(buffer);
+        if (read(buffer, c) < c) return;
+        n -= c;
+      }
+    };
+    // pulls part x_part, y_part, w, h of a bitmap of w_bitmap x h_bitmap pixels of bpp bits from source1 and source2 (if not 0),
+    // and writes it to controller memory of epd2 at x, y, by blocks of rows, with writeNative() if native, else with writeImage()
+    // source1 and source2 are consumed from their current position; x_part should be multiple of 8 / bpp
+    // source2 may be source1, for rows of both planes interleaved, as in native image files; not for rows wider than the block
+    // used by the template classes and GxEPD2_NativeImage; returns false if a source ends early
+    template <class EPD> static bool write(EPD& epd2, GxEPD2_ImageSource* source1, GxEPD2_ImageSource* source2, uint8_t bpp, bool native,
+                                           int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y)
+    {
+      if ((x_part < 0) || (y_part < 0) || (x_part >= w_bitmap) || (y_part >= h_bitmap) || (bpp == 0) || (bpp > 8)) return true;
+      w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+      h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+      if ((w <= 0) || (h <= 0)) return true;
+      uint8_t data1[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint8_t data2[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint8_t* data[2] = {data1, data2};
+      GxEPD2_ImageSource* source[2] = {source1, source2};
+      uint8_t planes = source2 ? 2 : 1;
+      bool interleaved = source2 && (source2 == source1);
+      uint32_t wb_bitmap = (uint32_t(w_bitmap) * bpp + 7) / 8;
+      uint16_t xb = uint32_t(x_part) * bpp / 8;
+      uint16_t wb = (uint32_t(w) * bpp + 7) / 8;
+      uint16_t rows = GxEPD2_SOURCE_BLOCK_SIZE / wb;
+      // the stored rows of the part: y_part .. y_part + h - 1, or counted from the bottom if mirror_y, as for bitmaps in memory
+      uint32_t skip_rows = mirror_y ? h_bitmap - y_part - h : y_part;
+      if (interleaved) source1->skip(wb_bitmap * skip_rows * 2);
+      else for (uint8_t p = 0; p < planes; p++) source[p]->skip(wb_bitmap * skip_rows);
+      if (rows > 0)
+      {
+        for (int16_t y1 = 0; y1 < h; y1 += rows)
+        {
+          int16_t n = rows < h - y1 ? rows : h - y1;
+          for (int16_t i = 0; interleaved && (i < n); i++) // row of plane 0, then the same row of plane 1
+          {
+            for (uint8_t p = 0; p < 2; p++)
+            {
+              source1->skip(xb);
+              if (source1->read(data[p] + i * wb, wb) < wb) return false;
+              if ((p == 0) || (y1 + i < h - 1)) source1->skip(wb_bitmap - xb - wb);
+            }
+          }
+          for (uint8_t p = 0; !interleaved && (p < planes); p++)
+          {
+            if (wb == wb_bitmap) // whole rows, one read
+            {
+              if (source[p]->read(data[p], wb * n) < wb * n) return false;
+              continue;
+            }
+            for (int16_t i = 0; i < n; i++)
+            {
+              source[p]->skip(xb);
+              if (source[p]->read(data[p] + i * wb, wb) < wb) return false;
+              if (y1 + i < h - 1) source[p]->skip(wb_bitmap - xb - wb);
+            }
+          }
+          int16_t by = mirror_y ? y + h - y1 - n : y + y1;
+          _write(epd2, native, data1, source2 ? data2 : 0, x, by, w, n, invert, mirror_y);
+        }
+      }
+      else if (interleaved) return false;
+      else // parts of one row
+      {
+        uint16_t part = GxEPD2_SOURCE_BLOCK_SIZE * 8 / bpp; // pixels
+        for (int16_t y1 = 0; y1 < h; y1++)
+        {
+          for (uint8_t p = 0; p < planes; p++) source[p]->skip(xb);
+          for (int16_t x1 = 0; x1 < w; x1 += part)
+          {
+            int16_t w1 = part < w - x1 ? part : w - x1;
+            uint16_t wb1 = (uint32_t(w1) * bpp + 7) / 8;
+            for (uint8_t p = 0; p < planes; p++)
+            {
+              if (source[p]->read(data[p], wb1) < wb1) return false;
+            }
+            _write(epd2, native, data1, source2 ? data2 : 0, x + x1, mirror_y ? y + h - 1 - y1 : y + y1, w1, 1, invert, mirror_y);
+          }
+          if (y1 < h - 1) for (uint8_t p = 0; p < planes; p++) source[p]->skip(wb_bitmap - xb - wb);
+        }
+      }
+      return true;
+    };
+  private:
+    template <class EPD> static void _write(EPD& epd2, bool native, const uint8_t* data1, const uint8_t* data2,
+                                            int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y)
+    {
+      if (native) epd2.writeNative(data1, data2, x, y, w, h, invert, mirror_y, false);
+      else if (data2) epd2.writeImage(data1, data2, x, y, w, h, invert, mirror_y, false);
+      else epd2.writeImage(data1, x, y, w, h, invert, mirror_y, false);
+    };
+};
+
+// bitmap in RAM, or in PROGMEM with pgm = true
+class GxEPD2_MemorySource : public GxEPD2_ImageSource
+{
+  public:
+    GxEPD2_MemorySource(const uint8_t* data, uint32_t size, bool pgm = false) : _data(data), _size(size), _pos(0), _pgm(pgm) {};
+    uint16_t read(uint8_t* buffer, uint16_t n)
+    {
+      if (n > _size - _pos) n = _size - _pos;
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      if (_pgm) memcpy_P(buffer, _data + _pos, n);
+      else memcpy(buffer, _data + _pos, n);
+#else
+      memcpy(buffer, _data + _pos, n);
+#endif
+      _pos += n;
+      return n;
+    };
+    void skip(uint32_t n)
+    {
+      _pos = n < _size - _pos ? _pos + n : _size;
+    };
+    void rewind()
+    {
+      _pos = 0;
+    };
+  protected:
+    GxEPD2_MemorySource() : _data(0), _size(0), _pos(0), _pgm(false) {};
+    const uint8_t* _data;
+    uint32_t _size, _pos;
+    bool _pgm;
+};
+
+// Arduino Stream, e.g. a WiFiClient or a serial port; reads wait up to the timeout of the stream
+class GxEPD2_StreamSource : public GxEPD2_ImageSource
+{
+  public:
+    GxEPD2_StreamSource(Stream& stream) : _stream(stream) {};
+    uint16_t read(uint8_t* buffer, uint16_t n)
+    {
+      return _stream.readBytes(buffer, n);
+    };
+  private:
+    Stream& _stream;
+};
+
+// file with read(buffer, n), seek(pos) and position(), e.g. fs::File of SPIFFS or LittleFS, File of SD or SdFat
+template <class FileT> class GxEPD2_FileSource : public GxEPD2_ImageSource
+{
+  public:
+    GxEPD2_FileSource(FileT& file) : _file(file) {};
+    uint16_t read(uint8_t* buffer, uint16_t n)
+    {
+      int got = _file.read(buffer, n);
+      return got > 0 ? got : 0;
+    };
+    void skip(uint32_t n)
+    {
+      if (n > 0) _file.seek(_file.position() + n);
+    };
+  private:
+    FileT& _file;
+};
+
+#if !defined(ARDUINO) && (defined(__unix__) || defined(__APPLE__))
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// host side: file mapped to memory, e.g. for tests or simulation of sketches on the host; offset skips a file header
+class GxEPD2_MmapSource : public GxEPD2_MemorySource
+{
+  public:
+    GxEPD2_MmapSource(const char* path, uint32_t offset = 0) : _map(0), _length(0)
+    {
+      int fd = open(path, O_RDONLY);
+      struct stat st;
+      if ((fd >= 0) && (fstat(fd, &st) == 0) && (st.st_size > 0))
+      {
+        void* map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED)
+        {
+          _map = map;
+          _length = st.st_size;
+          _data = (const uint8_t*)map + (offset < _length ? offset : _length);
+          _size = offset < _length ? _length - offset : 0;
+        }
+      }
+      if (fd >= 0) close(fd);
+    };
+    ~GxEPD2_MmapSource()
+    {
+      if (_map) munmap(_map, _length);
+    };
+    bool valid() const
+    {
+      return _map != 0;
+    };
+  private:
+    GxEPD2_MmapSource(const GxEPD2_MmapSource&);
+    void* _map;
+    size_t _length;
+};
+#endif
+
+#endif
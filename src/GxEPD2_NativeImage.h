@@ -0,0 +1,116 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Native images: pre-converted images in the byte order and plane layout of the controller memory,
+// streamed from a file with bulk reads to writeImage() or writeNative(), without any per pixel work.
+// Native image files can be emitted e.g. by GxEPD2_Spiffs_Loader, see emit_native there.
+//
+// Format, values little endian:
+//   header: 'G', 'N', kind, planes (1 or 2), bits per pixel, 0, width (uint16_t), height (uint16_t)
+//   rows:   top to bottom, (width * bits per pixel + 7) / 8 bytes per row and plane;
+//           with two planes each row of plane 0 is followed by the same row of plane 1
+//   kind 0: for writeImage(black, color, ...) of b/w and 3-color panels, 1 bit per pixel, bit 1 is white, 0 is black or color
+//   kind 1: for writeNative(data1, data2, ...) of the target driver, e.g. 4 bits per pixel for GxEPD2_565c (use epd2.setPaged())
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_NativeImage_H_
+#define _GxEPD2_NativeImage_H_
+
+#include "GxEPD2_ImageSource.h"
+
+class GxEPD2_NativeImage
+{
+  public:
+    enum Kind {IMAGE = 0, NATIVE = 1};
+    static const uint8_t header_size = 10;
+    GxEPD2_NativeImage() : _valid(false), _kind(IMAGE), _planes(0), _bpp(0), _w(0), _h(0) {};
+    // describes an image to be emitted
+    GxEPD2_NativeImage(Kind kind, uint8_t planes, uint8_t bpp, uint16_t w, uint16_t h) :
+      _kind(kind), _planes(planes), _bpp(bpp), _w(w), _h(h)
+    {
+      _valid = (planes >= 1) && (planes <= 2) && (bpp >= 1) && (bpp <= 8) && (w > 0) && (h > 0) && ((kind == NATIVE) || (bpp == 1));
+    };
+    // reads the header, leaves file positioned at the first row; file needs read(uint8_t*, n), and seek() and position() for write(),
+    // as fs::File or SdFat File
+    template <class FileT> bool begin(FileT& file)
+    {
+      uint8_t h[header_size];
+      _valid = false;
+      if (!_read(file, h, header_size) || (h[0] != 'G') || (h[1] != 'N') || (h[2] > NATIVE)) return false;
+      *this = GxEPD2_NativeImage(Kind(h[2]), h[3], h[4], h[6] | uint16_t(h[7]) << 8, h[8] | uint16_t(h[9]) << 8);
+      return _valid;
+    };
+    // fills the header of the image, to be written before the rows
+    void header(uint8_t h[header_size]) const
+    {
+      h[0] = 'G';
+      h[1] = 'N';
+      h[2] = _kind;
+      h[3] = _planes;
+      h[4] = _bpp;
+      h[5] = 0;
+      h[6] = _w & 0xFF;
+      h[7] = _w >> 8;
+      h[8] = _h & 0xFF;
+      h[9] = _h >> 8;
+    };
+    bool valid() const
+    {
+      return _valid;
+    };
+    Kind kind() const
+    {
+      return _kind;
+    };
+    uint8_t planes() const
+    {
+      return _planes;
+    };
+    uint8_t bitsPerPixel() const
+    {
+      return _bpp;
+    };
+    uint16_t width() const
+    {
+      return _w;
+    };
+    uint16_t height() const
+    {
+      return _h;
+    };
+    uint16_t rowBytes() const
+    {
+      return (uint32_t(_w) * _bpp + 7) / 8;
+    };
+    // file size, with header
+    uint32_t size() const
+    {
+      return header_size + uint32_t(rowBytes()) * _planes * _h;
+    };
+    // streams the rows following the header from file to controller memory of target at x, y, without refresh
+    // target is the display instance or display.epd2; x should be multiple of 8 (of 2 for 4 bits per pixel)
+    // by blocks of GxEPD2_SOURCE_BLOCK_SIZE bytes per plane, see GxEPD2_ImageSource::write(); rows that don't fit a block
+    // are written in parts, for one plane only; returns false on short read
+    template <class Target, class FileT> bool write(Target& target, FileT& file, int16_t x, int16_t y) const
+    {
+      if (!_valid) return false;
+      GxEPD2_FileSource<FileT> source(file);
+      return GxEPD2_ImageSource::write(target, &source, _planes > 1 ? &source : 0, _bpp, _kind == NATIVE, 0, 0, _w, _h, x, y, _w, _h, false, false);
+    };
+  private:
+    template <class FileT> static bool _read(FileT& file, uint8_t* buffer, uint16_t n)
+    {
+      return size_t(file.read(buffer, n)) == n;
+    };
+    bool _valid;
+    Kind _kind;
+    uint8_t _planes, _bpp;
+    uint16_t _w, _h;
+};
+
+#endif
@@ -0,0 +1,282 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Packed bitmaps: run length compressed 1bpp bitmaps with one or two planes (black, color), decoded as a stream,
+// by blocks of rows to controller memory (writeImage), or by rows to a GFX target, e.g. the page buffer (drawBitmap).
+// The full bitmap is never unpacked. Pack bitmaps with extras/tools/GxEPD2_PackBitmap.
+//
+// Format, values little endian:
+//   header: 'G', 'P', flags (bit 0: two planes), 0, width (uint16_t), height (uint16_t), packed size of plane 0 (uint32_t)
+//   planes: rows of (width + 7) / 8 bytes, bit 1 is white, 0 is black or color, as the bundled bitmaps; runs may span rows
+//   codes:  0x00..0x7F : code + 1 literal bytes follow
+//           0x80..0xBF : the next byte, repeated (code & 0x3F) + 2 times
+//           0xC0..0xFF : the byte after the next, repeated ((code & 0x3F) << 8 | next) + 66 times
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_PackedBitmap_H_
+#define _GxEPD2_PackedBitmap_H_
+
+#include <Arduino.h>
+
+#if defined(ESP8266) || defined(ESP32)
+#include <pgmspace.h>
+#elif defined(__AVR)
+#include <avr/pgmspace.h>
+#endif
+
+// bytes of the decode buffer on the stack, per plane; blocks of rows or parts of rows are written from it
+#ifndef GxEPD2_PACKED_BLOCK_SIZE
+#if defined(__AVR)
+#define GxEPD2_PACKED_BLOCK_SIZE 64
+#else
+#define GxEPD2_PACKED_BLOCK_SIZE 512
+#endif
+#endif
+
+class GxEPD2_PackedBitmap
+{
+  public:
+    static const uint8_t header_size = 12;
+    // decoder of one plane, keeps its position; copies are independent
+    class Reader
+    {
+      public:
+        Reader(const uint8_t* data = 0, bool pgm = true) : _data(data), _pgm(pgm), _literal(0), _repeat(0), _value(0) {};
+        // decodes the next n bytes
+        void read(uint8_t* buffer, uint32_t n)
+        {
+          while (n > 0)
+          {
+            if (_literal > 0)
+            {
+              uint16_t c = n < _literal ? n : _literal;
+              _copy(buffer, c);
+              buffer += c;
+              _literal -= c;
+              n -= c;
+            }
+            else if (_repeat > 0)
+            {
+              uint16_t c = n < _repeat ? n : _repeat;
+              memset(buffer, _value, c);
+              buffer += c;
+              _repeat -= c;
+              n -= c;
+            }
+            else _code();
+          }
+        }
+        // skips the next n bytes, reads only the literal bytes' codes
+        void skip(uint32_t n)
+        {
+          while (n > 0)
+          {
+            if (_literal > 0)
+            {
+              uint16_t c = n < _literal ? n : _literal;
+              _data += c;
+              _literal -= c;
+              n -= c;
+            }
+            else if (_repeat > 0)
+            {
+              uint16_t c = n < _repeat ? n : _repeat;
+              _repeat -= c;
+              n -= c;
+            }
+            else _code();
+          }
+        }
+      private:
+        uint8_t _byte()
+        {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+          return _pgm ? pgm_read_byte(_data++) : *_data++;
+#else
+          return *_data++;
+#endif
+        }
+        void _copy(uint8_t* buffer, uint16_t n)
+        {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+          if (_pgm) memcpy_P(buffer, _data, n);
+          else memcpy(buffer, _data, n);
+#else
+          memcpy(buffer, _data, n);
+#endif
+          _data += n;
+        }
+        void _code()
+        {
+          uint8_t code = _byte();
+          if (code < 0x80) _literal = code + 1;
+          else if (code < 0xC0) _repeat = (code & 0x3F) + 2;
+          else
+          {
+            _repeat = (uint16_t(code & 0x3F) << 8 | _byte()) + 66;
+          }
+          if (_repeat > 0) _value = _byte();
+        }
+        const uint8_t* _data;
+        bool _pgm;
+        uint16_t _literal, _repeat;
+        uint8_t _value;
+    };
+    // packed: the packed bitmap with header, pgm: in PROGMEM
+    GxEPD2_PackedBitmap(const uint8_t* packed, bool pgm = true) : _packed(packed), _pgm(pgm)
+    {
+      uint8_t h[header_size];
+      for (uint8_t i = 0; i < header_size; i++)
+      {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+        h[i] = pgm ? pgm_read_byte(packed + i) : packed[i];
+#else
+        h[i] = packed[i];
+#endif
+      }
+      _valid = (h[0] == 'G') && (h[1] == 'P');
+      _color = _valid && (h[2] & 0x01);
+      _w = _valid ? h[4] | uint16_t(h[5]) << 8 : 0;
+      _h = _valid ? h[6] | uint16_t(h[7]) << 8 : 0;
+      _size0 = uint32_t(h[8]) | uint32_t(h[9]) << 8 | uint32_t(h[10]) << 16 | uint32_t(h[11]) << 24;
+    };
+    bool valid() const
+    {
+      return _valid;
+    };
+    uint16_t width() const
+    {
+      return _w;
+    };
+    uint16_t height() const
+    {
+      return _h;
+    };
+    bool hasColor() const
+    {
+      return _color;
+    };
+    uint16_t rowBytes() const
+    {
+      return (_w + 7) / 8;
+    };
+    // a reader positioned at the first byte of plane 0 (black) or 1 (color)
+    Reader plane(uint8_t i) const
+    {
+      return Reader(_packed + header_size + (i ? _size0 : 0), _pgm);
+    };
+    // writes plane 0 to controller memory of epd2, without refresh; x should be multiple of 8
+    template <class EPD> void writeImage(EPD& epd2, int16_t x, int16_t y, bool invert = false, bool mirror_y = false) const
+    {
+      if (!_valid) return;
+      uint8_t black[GxEPD2_PACKED_BLOCK_SIZE];
+      Reader b = plane(0);
+      _Block block;
+      while (_nextBlock(block))
+      {
+        b.read(black, uint32_t(block.wb) * block.rows);
+        int16_t by = mirror_y ? y + _h - block.y - block.rows : y + block.y;
+        epd2.writeImage(black, x + block.x, by, block.w, block.rows, invert, mirror_y, false);
+      }
+    };
+    // writes both planes to controller memory of epd2, for drivers with writeImage(black, color, ...); x should be multiple of 8
+    template <class EPD> void writeImageColor(EPD& epd2, int16_t x, int16_t y, bool invert = false, bool mirror_y = false) const
+    {
+      if (!_valid) return;
+      if (!_color) return writeImage(epd2, x, y, invert, mirror_y);
+      uint8_t black[GxEPD2_PACKED_BLOCK_SIZE];
+      uint8_t color[GxEPD2_PACKED_BLOCK_SIZE];
+      Reader b = plane(0);
+      Reader c = plane(1);
+      _Block block;
+      while (_nextBlock(block))
+      {
+        b.read(black, uint32_t(block.wb) * block.rows);
+        c.read(color, uint32_t(block.wb) * block.rows);
+        int16_t by = mirror_y ? y + _h - block.y - block.rows : y + block.y;
+        epd2.writeImage(black, color, x + block.x, by, block.w, block.rows, invert, mirror_y, false);
+      }
+    };
+    // draws to a GFX target, e.g. the page buffer of GxEPD2_BW or GxEPD2_3C; 0 bits of plane 0 in color, of plane 1 in color2
+    // rows outside the target height are skipped, not drawn
+    template <class GFX> void drawBitmap(GFX& gfx, int16_t x, int16_t y, uint16_t color, uint16_t color2) const
+    {
+      if (!_valid) return;
+      uint8_t buffer[GxEPD2_PACKED_BLOCK_SIZE];
+      Reader r[2] = {plane(0), plane(1)};
+      _Block block;
+      while (_nextBlock(block))
+      {
+        for (uint8_t p = 0; p < (_color ? 2 : 1); p++)
+        {
+          uint32_t n = uint32_t(block.wb) * block.rows;
+          if ((y + block.y + block.rows <= 0) || (y + block.y >= gfx.height()))
+          {
+            r[p].skip(n);
+            continue;
+          }
+          r[p].read(buffer, n);
+          for (uint32_t i = 0; i < n; i++) buffer[i] = ~buffer[i];
+          gfx.drawBitmap(x + block.x, y + block.y, buffer, block.w, block.rows, p ? color2 : color);
+        }
+      }
+    };
+    template <class GFX> void drawBitmap(GFX& gfx, int16_t x, int16_t y, uint16_t color) const
+    {
+      drawBitmap(gfx, x, y, color, color);
+    };
+  private:
+    // blocks of whole rows that fit the buffer, or parts of one row if a row doesn't fit
+    struct _Block
+    {
+      uint16_t x, y, w, wb, rows;
+      bool started;
+      _Block() : x(0), y(0), w(0), wb(0), rows(0), started(false) {};
+    };
+    bool _nextBlock(_Block& block) const
+    {
+      uint16_t wb = rowBytes();
+      uint16_t rows = wb > 0 ? GxEPD2_PACKED_BLOCK_SIZE / wb : 0;
+      if (!block.started)
+      {
+        block.started = true;
+        block.x = 0;
+        block.y = 0;
+      }
+      else if (rows > 0) block.y += block.rows;
+      else
+      {
+        block.x += block.w;
+        if (block.x >= _w)
+        {
+          block.x = 0;
+          block.y++;
+        }
+      }
+      if ((block.y >= _h) || (wb == 0)) return false;
+      if (rows > 0)
+      {
+        block.w = _w;
+        block.wb = wb;
+        block.rows = rows < _h - block.y ? rows : _h - block.y;
+      }
+      else
+      {
+        block.w = GxEPD2_PACKED_BLOCK_SIZE * 8 < _w - block.x ? GxEPD2_PACKED_BLOCK_SIZE * 8 : _w - block.x;
+        block.wb = (block.w + 7) / 8;
+        block.rows = 1;
+      }
+      return true;
+    };
+    const uint8_t* _packed;
+    bool _pgm, _valid, _color;
+    uint16_t _w, _h;
+    uint32_t _size0;
+};
+
+#endif
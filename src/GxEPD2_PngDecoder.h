@@ -0,0 +1,662 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// PNG decoder: streaming decoder of PNG images, pulled from a GxEPD2_ImageSource, with its own inflate.
+// Greyscale and palette images of 1, 2, 4 or 8 bits, greyscale of 16 bits, true color and alpha of 8 or 16 bits; not interlaced.
+// Rows are inflated and defiltered one by one, to controller memory (write), or to the buffer of the template classes (draw).
+// Pixel classification is the same as in GxEPD2_BmpDecoder; transparent pixels are white.
+//
+// Memory is bounded by the configuration below, the decoder holds the inflate window and two rows; make the decoder static or global.
+// Images deflated with a larger window than configured fail on the first longer distance; recompress them, e.g. optipng -zw 4k.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_PngDecoder_H_
+#define _GxEPD2_PngDecoder_H_
+
+#include "GxEPD2.h"
+#include "GxEPD2_ImageSource.h"
+
+// inflate window of 1 << bits bytes, 8..15; 15 (32k) decodes any PNG, e.g. 12 (4k) for nRF52832 or ESP8266
+#ifndef GxEPD2_PNG_WINDOW_BITS
+#if defined(__AVR)
+#define GxEPD2_PNG_WINDOW_BITS 8
+#else
+#define GxEPD2_PNG_WINDOW_BITS 15
+#endif
+#endif
+
+// maximum bytes of an image row, two rows are kept; e.g. 2400 for 800 pixels true color or 2400 pixels at 8 bits
+#ifndef GxEPD2_PNG_MAX_ROW_BYTES
+#if defined(__AVR)
+#define GxEPD2_PNG_MAX_ROW_BYTES 50
+#else
+#define GxEPD2_PNG_MAX_ROW_BYTES 2400
+#endif
+#endif
+
+// bytes of the input buffer in the decoder
+#ifndef GxEPD2_PNG_INPUT_SIZE
+#if defined(__AVR)
+#define GxEPD2_PNG_INPUT_SIZE 16
+#else
+#define GxEPD2_PNG_INPUT_SIZE 128
+#endif
+#endif
+
+// keep the palette as rgb565 for multicolor drawing, e.g. for GxEPD2_7C; 512 bytes
+#if !defined(GxEPD2_PNG_RGB565) && !defined(__AVR)
+#define GxEPD2_PNG_RGB565 1
+#endif
+
+class GxEPD2_PngDecoder
+{
+  public:
+    // source positioned at the start of the file; with_color: colored pixels to the color plane, else black
+    GxEPD2_PngDecoder(GxEPD2_ImageSource& source, bool with_color = true) :
+      _source(source), _valid(false), _error(false), _with_color(with_color), _color(false), _w(0), _h(0), _row(0),
+      _depth(0), _type(0), _channels(0), _bpp(0), _row_bytes(0), _trns(false), _trns_r(0), _trns_g(0), _trns_b(0),
+      _idat(0), _in_pos(0), _in_len(0), _bitbuf(0), _bitcnt(0), _last(false), _block(0), _stored(0), _copy_len(0), _copy_dist(0),
+      _wpos(0), _wfill(0), _prev(_rows[0]), _cur(_rows[1]) {};
+    // parses the chunks up to the image data, leaves the source at the image data; false if not supported or too large
+    bool begin()
+    {
+      static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+      uint8_t b[24];
+      _valid = false;
+      _error = false;
+      _trns = false;
+      if ((_source.read(b, 8) < 8) || memcmp(b, signature, 8)) return false;
+      memset(_white, 0xFF, sizeof(_white)); // indexes beyond the palette
+      memset(_colored, 0, sizeof(_colored));
+#if GxEPD2_PNG_RGB565
+      memset(_rgb, 0xFF, sizeof(_rgb)); // rgb565 white
+#endif
+      while (true)
+      {
+        if (_source.read(b, 8) < 8) return false;
+        uint32_t length = _get(b, 4);
+        char type[4];
+        memcpy(type, b + 4, 4);
+        if (!memcmp(type, "IHDR", 4))
+        {
+          if ((length != 13) || (_source.read(b, 13) < 13)) return false;
+          if (!_header(b)) return false;
+        }
+        else if (_depth == 0) return false; // IHDR must be first
+        else if (!memcmp(type, "PLTE", 4) && (_type == 3))
+        {
+          for (uint16_t i = 0; i < length / 3; i += 8)
+          {
+            uint16_t c = length / 3 - i < 8 ? length / 3 - i : 8;
+            if (_source.read(b, c * 3) < c * 3) return false;
+            for (uint16_t k = 0; (k < c) && (i + k < 256); k++) _palette(i + k, b[k * 3], b[k * 3 + 1], b[k * 3 + 2]);
+          }
+          _source.skip(length % 3);
+        }
+        else if (!memcmp(type, "tRNS", 4))
+        {
+          if (!_transparency(length)) return false;
+        }
+        else if (!memcmp(type, "IDAT", 4))
+        {
+          _idat = length;
+          break;
+        }
+        else if (!memcmp(type, "IEND", 4)) return false;
+        else _source.skip(length);
+        if (memcmp(type, "IDAT", 4)) _source.skip(4); // crc
+      }
+      _in_pos = _in_len = 0;
+      _bitbuf = 0;
+      _bitcnt = 0;
+      _last = false;
+      _block = 0;
+      _copy_len = 0;
+      _wpos = _wfill = 0;
+      _row = 0;
+      uint8_t cmf = _bits(8), flg = _bits(8);
+      if (_error || ((cmf & 0x0F) != 8) || (((uint16_t(cmf) << 8) | flg) % 31) || (flg & 0x20)) return false; // deflate, no dictionary
+      memset(_prev, 0, _row_bytes);
+      memset(_cur, 0, _row_bytes);
+      _valid = true;
+      return true;
+    };
+    bool valid() const
+    {
+      return _valid;
+    };
+    // the image data is invalid, truncated, or uses a larger window than GxEPD2_PNG_WINDOW_BITS
+    bool error() const
+    {
+      return _error;
+    };
+    int16_t width() const
+    {
+      return _w;
+    };
+    int16_t height() const
+    {
+      return _h;
+    };
+    // bits per sample
+    uint8_t depth() const
+    {
+      return _depth;
+    };
+    // PNG color type: 0 greyscale, 2 true color, 3 palette, 4 greyscale with alpha, 6 true color with alpha
+    uint8_t colorType() const
+    {
+      return _type;
+    };
+    // decodes the next row to rows of (width + 7) / 8 bytes, bit 1 is white, 0 black or color, as for writeImage
+    // color may be 0; returns the index of the row, or -1 at end or on error
+    int16_t readRow(uint8_t* black, uint8_t* color)
+    {
+      if (!_nextRow()) return -1;
+      uint16_t wb = (_w + 7) / 8;
+      memset(black, 0xFF, wb);
+      if (color) memset(color, 0xFF, wb);
+      _BitSink sink(*this, black, _color ? color : 0); // stays white without color
+      _decodeRow(sink);
+      return _row - 1;
+    };
+    // writes the image to controller memory of target, the display or display.epd2, at x, y, without refresh; x should be multiple of 8
+    // a decoded row needs to fit GxEPD2_SOURCE_BLOCK_SIZE bytes, else returns false
+    template <class Target> bool write(Target& target, int16_t x, int16_t y)
+    {
+      if (!_valid || (_row != 0)) return false;
+      uint8_t black[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint8_t color[GxEPD2_SOURCE_BLOCK_SIZE];
+      uint16_t wb = (_w + 7) / 8;
+      uint16_t rows = GxEPD2_SOURCE_BLOCK_SIZE / wb;
+      if (rows == 0) return false;
+      for (int16_t y1 = 0; y1 < _h; y1 += rows)
+      {
+        int16_t n = rows < _h - y1 ? rows : _h - y1;
+        for (int16_t i = 0; i < n; i++)
+        {
+          if (readRow(black + i * wb, _color ? color + i * wb : 0) < 0) return false;
+        }
+        if (_color) target.writeImage(black, color, x, y + y1, _w, n, false, false, false);
+        else target.writeImage(black, x, y + y1, _w, n, false, false, false);
+      }
+      return true;
+    };
+    // draws the image to the buffer of gfx, e.g. inside the picture loop; rows outside gfx.height() are decoded, not drawn
+    // multicolor draws rgb565 colors, e.g. for GxEPD2_7C, else black, white and colored (GxEPD_RED)
+    template <class GFX> bool draw(GFX& gfx, int16_t x, int16_t y, bool multicolor = false)
+    {
+      if (!_valid || (_row != 0)) return false;
+      _DrawSink<GFX> sink(*this, gfx, x, multicolor);
+      while (_row < _h)
+      {
+        int16_t yrow = y + _row;
+        if (!_nextRow()) return false;
+        if ((yrow < 0) || (yrow >= gfx.height())) continue;
+        sink.y = yrow;
+        _decodeRow(sink);
+      }
+      return true;
+    };
+  private:
+    static uint32_t _get(const uint8_t* b, uint8_t n) // big endian
+    {
+      uint32_t v = 0;
+      for (uint8_t i = 0; i < n; i++) v = (v << 8) | b[i];
+      return v;
+    };
+    bool _header(const uint8_t* b)
+    {
+      uint32_t width = _get(b, 4), height = _get(b + 4, 4);
+      _depth = b[8];
+      _type = b[9];
+      if ((width == 0) || (width > 0x7FFF) || (height == 0) || (height > 0x7FFF)) return false;
+      if ((b[10] != 0) || (b[11] != 0) || (b[12] != 0)) return false; // deflate, adaptive filters, not interlaced
+      bool depth_ok;
+      switch (_type)
+      {
+        case 0: _channels = 1; depth_ok = (_depth == 1) || (_depth == 2) || (_depth == 4) || (_depth == 8) || (_depth == 16); break;
+        case 3: _channels = 1; depth_ok = (_depth == 1) || (_depth == 2) || (_depth == 4) || (_depth == 8); break;
+        case 2: _channels = 3; depth_ok = (_depth == 8) || (_depth == 16); break;
+        case 4: _channels = 2; depth_ok = (_depth == 8) || (_depth == 16); break;
+        case 6: _channels = 4; depth_ok = (_depth == 8) || (_depth == 16); break;
+        default: return false;
+      }
+      if (!depth_ok) return false;
+      _w = width;
+      _h = height;
+      _row_bytes = (uint32_t(_w) * _channels * _depth + 7) / 8;
+      _bpp = _channels * _depth / 8 > 0 ? _channels * _depth / 8 : 1; // bytes per pixel for the filters
+      _color = _with_color && (_type != 0) && (_type != 4);
+      return (uint32_t(_w) * _channels * _depth + 7) / 8 <= GxEPD2_PNG_MAX_ROW_BYTES;
+    };
+    bool _transparency(uint32_t length)
+    {
+      uint8_t b[8];
+      if (_type == 3)
+      {
+        for (uint16_t i = 0; i < length; i += 8)
+        {
+          uint16_t c = length - i < 8 ? length - i : 8;
+          if (_source.read(b, c) < c) return false;
+          for (uint16_t k = 0; (k < c) && (i + k < 256); k++)
+          {
+            if (b[k] < 0x80) _palette(i + k, 0xFF, 0xFF, 0xFF); // transparent is white
+          }
+        }
+        return true;
+      }
+      if (((_type == 0) && (length == 2)) || ((_type == 2) && (length == 6)))
+      {
+        if (_source.read(b, length) < length) return false;
+        _trns = true;
+        _trns_r = _trns_g = _trns_b = _get(b, 2);
+        if (_type == 2)
+        {
+          _trns_g = _get(b + 2, 2);
+          _trns_b = _get(b + 4, 2);
+        }
+        return true;
+      }
+      _source.skip(length);
+      return true;
+    };
+    bool _whitish(uint8_t r, uint8_t g, uint8_t b) const
+    {
+      return _color ? (r > 0x80) && (g > 0x80) && (b > 0x80) : uint16_t(r) + g + b > 3 * 0x80;
+    };
+    static bool _reddish(uint8_t r, uint8_t g, uint8_t b)
+    {
+      return (r > 0xF0) || ((g > 0xF0) && (b > 0xF0)); // reddish or yellowish
+    };
+    static uint16_t _rgb565(uint8_t r, uint8_t g, uint8_t b)
+    {
+      return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    };
+    void _palette(uint8_t i, uint8_t r, uint8_t g, uint8_t b)
+    {
+      uint8_t mask = 1 << (i % 8);
+      _white[i / 8] = _whitish(r, g, b) ? _white[i / 8] | mask : _white[i / 8] & ~mask;
+      _colored[i / 8] = _reddish(r, g, b) ? _colored[i / 8] | mask : _colored[i / 8] & ~mask;
+#if GxEPD2_PNG_RGB565
+      _rgb[i] = _rgb565(r, g, b);
+#endif
+    };
+    // inflates and defilters the next row to _cur, the previous row is _prev
+    bool _nextRow()
+    {
+      if (!_valid || (_row >= _h)) return false;
+      uint8_t* swap = _prev;
+      _prev = _cur;
+      _cur = swap;
+      uint8_t filter;
+      if (!_inflate(&filter, 1) || !_inflate(_cur, _row_bytes) || (filter > 4))
+      {
+        _error = true;
+        _valid = false;
+        return false;
+      }
+      _unfilter(filter);
+      _row++;
+      return true;
+    };
+    void _unfilter(uint8_t filter)
+    {
+      uint8_t* c = _cur;
+      const uint8_t* p = _prev;
+      uint16_t n = _row_bytes, bpp = _bpp, i;
+      switch (filter)
+      {
+        case 1: // sub
+          for (i = bpp; i < n; i++) c[i] += c[i - bpp];
+          break;
+        case 2: // up
+          for (i = 0; i < n; i++) c[i] += p[i];
+          break;
+        case 3: // average
+          for (i = 0; i < bpp; i++) c[i] += p[i] >> 1;
+          for (; i < n; i++) c[i] += (uint16_t(c[i - bpp]) + p[i]) >> 1;
+          break;
+        case 4: // paeth
+          for (i = 0; i < bpp; i++) c[i] += p[i];
+          for (; i < n; i++)
+          {
+            int16_t a = c[i - bpp], b = p[i], cc = p[i - bpp];
+            int16_t pa = b - cc, pb = a - cc, pc = pa + pb;
+            if (pa < 0) pa = -pa;
+            if (pb < 0) pb = -pb;
+            if (pc < 0) pc = -pc;
+            c[i] += (pa <= pb) && (pa <= pc) ? a : pb <= pc ? b : cc;
+          }
+          break;
+      }
+    };
+    uint16_t _sample(uint16_t col) const
+    {
+      if (_depth == 16) return (uint16_t(_cur[2 * col]) << 8) | _cur[2 * col + 1];
+      uint32_t bit = uint32_t(col) * _depth;
+      return (_cur[bit / 8] >> (8 - _depth - bit % 8)) & ((1 << _depth) - 1);
+    };
+    // calls sink.index(col, index) for palette images, sink.rgb(col, r, g, b) for the others, white for transparent
+    template <class Sink> void _decodeRow(Sink& sink)
+    {
+      uint8_t s = _depth / 8; // bytes per sample of 8 or 16 bits
+      for (uint16_t col = 0; col < uint16_t(_w); col++)
+      {
+        if (_type == 3) sink.index(col, _sample(col));
+        else if (_type == 0)
+        {
+          uint16_t v = _sample(col);
+          if (_trns && (v == _trns_g)) sink.rgb(col, 0xFF, 0xFF, 0xFF);
+          else
+          {
+            uint8_t g = _depth == 16 ? v >> 8 : v * (0xFF / ((1 << _depth) - 1));
+            sink.rgb(col, g, g, g);
+          }
+        }
+        else
+        {
+          const uint8_t* p = _cur + uint32_t(col) * _channels * s;
+          bool gray = _type == 4;
+          uint8_t r = p[0], g = gray ? p[0] : p[s], b = gray ? p[0] : p[2 * s];
+          bool transparent = false;
+          if (_type >= 4) transparent = p[(_channels - 1) * s] < 0x80;
+          else if (_trns) transparent = (_get(p, s) == _trns_r) && (_get(p + s, s) == _trns_g) && (_get(p + 2 * s, s) == _trns_b);
+          if (transparent) sink.rgb(col, 0xFF, 0xFF, 0xFF);
+          else sink.rgb(col, r, g, b);
+        }
+      }
+    };
+    // next byte of the image data, over IDAT chunks; -1 at end
+    int _byte()
+    {
+      if (_in_pos >= _in_len)
+      {
+        while (_idat == 0)
+        {
+          uint8_t b[12]; // crc, length and type of the next chunk
+          if ((_source.read(b, 12) < 12) || memcmp(b + 8, "IDAT", 4)) return -1;
+          _idat = _get(b + 4, 4);
+        }
+        uint16_t n = _idat < sizeof(_in) ? _idat : sizeof(_in);
+        _in_len = _source.read(_in, n);
+        _in_pos = 0;
+        if (_in_len == 0) return -1;
+        _idat -= _in_len;
+      }
+      return _in[_in_pos++];
+    };
+    uint16_t _bits(uint8_t n)
+    {
+      while (_bitcnt < n)
+      {
+        int b = _byte();
+        if (b < 0)
+        {
+          _error = true;
+          b = 0;
+        }
+        _bitbuf |= uint32_t(b) << _bitcnt;
+        _bitcnt += 8;
+      }
+      uint16_t v = _bitbuf & ((1UL << n) - 1);
+      _bitbuf >>= n;
+      _bitcnt -= n;
+      return v;
+    };
+    void _put(uint8_t v)
+    {
+      _window[_wpos] = v;
+      _wpos = (_wpos + 1) & ((1UL << GxEPD2_PNG_WINDOW_BITS) - 1);
+      if (_wfill < (1UL << GxEPD2_PNG_WINDOW_BITS)) _wfill++;
+    };
+    // inflates the next n bytes to out, resumes where the previous call stopped
+    bool _inflate(uint8_t* out, uint16_t n)
+    {
+      while ((n > 0) && !_error)
+      {
+        if (_copy_len > 0)
+        {
+          uint8_t v = _window[(_wpos - _copy_dist) & ((1UL << GxEPD2_PNG_WINDOW_BITS) - 1)];
+          _put(v);
+          *out++ = v;
+          n--;
+          _copy_len--;
+        }
+        else if (_block == 0)
+        {
+          if (_last || !_blockHeader()) return false;
+        }
+        else if (_block == 1) // stored
+        {
+          uint8_t v = _bits(8);
+          _put(v);
+          *out++ = v;
+          n--;
+          if (--_stored == 0) _block = 0;
+        }
+        else
+        {
+          int16_t symbol = _decode(_lencnt, _lensym);
+          if (symbol < 0) return false;
+          if (symbol < 256)
+          {
+            _put(symbol);
+            *out++ = symbol;
+            n--;
+          }
+          else if (symbol == 256) _block = 0;
+          else if (!_match(symbol - 257)) return false;
+        }
+      }
+      return !_error;
+    };
+    bool _match(uint8_t symbol)
+    {
+      static const uint16_t length_base[29] PROGMEM =
+      {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+      static const uint8_t length_extra[29] PROGMEM =
+      {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+      static const uint16_t distance_base[30] PROGMEM =
+      {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+      static const uint8_t distance_extra[30] PROGMEM =
+      {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+      if (symbol >= 29) return false;
+      _copy_len = _pgmWord(&length_base[symbol]) + _bits(_pgmByte(&length_extra[symbol]));
+      int16_t d = _decode(_distcnt, _distsym);
+      if ((d < 0) || (d >= 30)) return false;
+      _copy_dist = _pgmWord(&distance_base[d]) + _bits(_pgmByte(&distance_extra[d]));
+      return _copy_dist <= _wfill; // beyond the window, or before the start
+    };
+    bool _blockHeader()
+    {
+      _last = _bits(1);
+      _block = _bits(2) + 1; // 1 stored, 2 fixed, 3 dynamic
+      if (_block == 1)
+      {
+        _bits(_bitcnt % 8); // to byte boundary
+        _stored = _bits(16);
+        if ((_bits(16) ^ 0xFFFF) != _stored) return false;
+        if (_stored == 0) _block = 0;
+        return !_error;
+      }
+      uint8_t lengths[320];
+      if (_block == 2)
+      {
+        uint16_t i = 0;
+        for (; i < 144; i++) lengths[i] = 8;
+        for (; i < 256; i++) lengths[i] = 9;
+        for (; i < 280; i++) lengths[i] = 7;
+        for (; i < 288; i++) lengths[i] = 8;
+        for (; i < 288 + 30; i++) lengths[i] = 5;
+        return _construct(_lencnt, _lensym, lengths, 288) && _construct(_distcnt, _distsym, lengths + 288, 30);
+      }
+      if (_block != 3) return false;
+      static const uint8_t order[19] PROGMEM = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+      uint16_t nlen = _bits(5) + 257, ndist = _bits(5) + 1, ncode = _bits(4) + 4;
+      if ((nlen > 286) || (ndist > 30)) return false;
+      memset(lengths, 0, 19);
+      for (uint8_t i = 0; i < ncode; i++) lengths[_pgmByte(&order[i])] = _bits(3);
+      if (!_construct(_lencnt, _lensym, lengths, 19)) return false; // code length code, temporarily
+      for (uint16_t i = 0; i < nlen + ndist;)
+      {
+        int16_t symbol = _decode(_lencnt, _lensym);
+        if (symbol < 0) return false;
+        if (symbol < 16) lengths[i++] = symbol;
+        else
+        {
+          uint8_t value = 0;
+          uint8_t repeat;
+          if (symbol == 16)
+          {
+            if (i == 0) return false;
+            value = lengths[i - 1];
+            repeat = 3 + _bits(2);
+          }
+          else if (symbol == 17) repeat = 3 + _bits(3);
+          else repeat = 11 + _bits(7);
+          if (i + repeat > nlen + ndist) return false;
+          while (repeat--) lengths[i++] = value;
+        }
+      }
+      if (lengths[256] == 0) return false; // no end of block code
+      return _construct(_lencnt, _lensym, lengths, nlen) && _construct(_distcnt, _distsym, lengths + nlen, ndist) && !_error;
+    };
+    // canonical Huffman code from code lengths: count of codes per length, symbols ordered by code
+    static bool _construct(uint16_t* count, uint16_t* symbol, const uint8_t* lengths, uint16_t n)
+    {
+      uint16_t offset[16];
+      memset(count, 0, 16 * sizeof(uint16_t));
+      for (uint16_t i = 0; i < n; i++) count[lengths[i]]++;
+      if (count[0] == n) return true; // no codes, e.g. no distances
+      int32_t left = 1;
+      for (uint8_t len = 1; len < 16; len++)
+      {
+        left <<= 1;
+        left -= count[len];
+        if (left < 0) return false; // over-subscribed
+      }
+      offset[1] = 0;
+      for (uint8_t len = 1; len < 15; len++) offset[len + 1] = offset[len] + count[len];
+      for (uint16_t i = 0; i < n; i++)
+      {
+        if (lengths[i]) symbol[offset[lengths[i]]++] = i;
+      }
+      return true;
+    };
+    int16_t _decode(const uint16_t* count, const uint16_t* symbol)
+    {
+      int16_t code = 0, first = 0, index = 0;
+      for (uint8_t len = 1; len < 16; len++)
+      {
+        code |= _bits(1);
+        int16_t c = count[len];
+        if (code - c < first) return symbol[index + (code - first)];
+        index += c;
+        first += c;
+        first <<= 1;
+        code <<= 1;
+      }
+      return -1;
+    };
+    static uint16_t _pgmWord(const uint16_t* p)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      return pgm_read_word(p);
+#else
+      return *p;
+#endif
+    };
+    static uint8_t _pgmByte(const uint8_t* p)
+    {
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+      return pgm_read_byte(p);
+#else
+      return *p;
+#endif
+    };
+    // to rows of bits, as for writeImage
+    struct _BitSink
+    {
+      _BitSink(GxEPD2_PngDecoder& d, uint8_t* b, uint8_t* c) : decoder(d), black(b), color(c) {};
+      void index(uint16_t col, uint8_t i)
+      {
+        uint8_t mask = 1 << (i % 8);
+        if (decoder._white[i / 8] & mask) return;
+        if (color && (decoder._colored[i / 8] & mask)) color[col / 8] &= ~(0x80 >> (col % 8));
+        else black[col / 8] &= ~(0x80 >> (col % 8));
+      };
+      void rgb(uint16_t col, uint8_t r, uint8_t g, uint8_t b)
+      {
+        if (decoder._whitish(r, g, b)) return;
+        if (color && _reddish(r, g, b)) color[col / 8] &= ~(0x80 >> (col % 8));
+        else black[col / 8] &= ~(0x80 >> (col % 8));
+      };
+      GxEPD2_PngDecoder& decoder;
+      uint8_t* black;
+      uint8_t* color;
+    };
+    // to pixels of the buffer
+    template <class GFX> struct _DrawSink
+    {
+      _DrawSink(GxEPD2_PngDecoder& d, GFX& g, int16_t x0, bool m) : decoder(d), gfx(g), x(x0), y(0), multicolor(m) {};
+      void index(uint16_t col, uint8_t i)
+      {
+#if GxEPD2_PNG_RGB565
+        if (multicolor && decoder._color)
+        {
+          gfx.drawPixel(x + col, y, decoder._rgb[i]);
+          return;
+        }
+#endif
+        uint8_t mask = 1 << (i % 8);
+        bool colored = decoder._color && (decoder._colored[i / 8] & mask);
+        gfx.drawPixel(x + col, y, decoder._white[i / 8] & mask ? GxEPD_WHITE : colored ? GxEPD_RED : GxEPD_BLACK);
+      };
+      void rgb(uint16_t col, uint8_t r, uint8_t g, uint8_t b)
+      {
+        if (multicolor && decoder._color) gfx.drawPixel(x + col, y, _rgb565(r, g, b));
+        else gfx.drawPixel(x + col, y, decoder._whitish(r, g, b) ? GxEPD_WHITE : decoder._color && _reddish(r, g, b) ? GxEPD_RED : GxEPD_BLACK);
+      };
+      GxEPD2_PngDecoder& decoder;
+      GFX& gfx;
+      int16_t x, y;
+      bool multicolor;
+    };
+    GxEPD2_ImageSource& _source;
+    bool _valid, _error, _with_color, _color;
+    int16_t _w, _h, _row;
+    uint8_t _depth, _type, _channels, _bpp;
+    uint16_t _row_bytes;
+    bool _trns;
+    uint16_t _trns_r, _trns_g, _trns_b;
+    uint8_t _white[32]; // bit per palette index: whitish
+    uint8_t _colored[32]; // bit per palette index: reddish or yellowish
+#if GxEPD2_PNG_RGB565
+    uint16_t _rgb[256];
+#endif
+    // image data and inflate state
+    uint32_t _idat;
+    uint8_t _in[GxEPD2_PNG_INPUT_SIZE];
+    uint16_t _in_pos, _in_len;
+    uint32_t _bitbuf;
+    uint8_t _bitcnt;
+    bool _last;
+    uint8_t _block;
+    uint16_t _stored, _copy_len, _copy_dist;
+    uint16_t _wpos;
+    uint32_t _wfill;
+    uint16_t _lencnt[16], _lensym[288];
+    uint16_t _distcnt[16], _distsym[30];
+    uint8_t _window[1UL << GxEPD2_PNG_WINDOW_BITS];
+    uint8_t _rows[2][GxEPD2_PNG_MAX_ROW_BYTES];
+    uint8_t* _prev;
+    uint8_t* _cur;
+};
+
+#endif
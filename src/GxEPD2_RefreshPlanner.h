@@ -0,0 +1,168 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Refresh planner: estimates the cost of the possible refresh sequences for a set of changed rectangles,
+// from the driver timing attributes, the measured SPI cost per byte and the measured busy times (GxEPD2_TimingProfile).
+// Cost is time in microseconds; busy time is also the dominant part of the energy used by an update.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_RefreshPlanner_H_
+#define _GxEPD2_RefreshPlanner_H_
+
+#include <Arduino.h>
+#include "GxEPD2_FrameDiff.h"
+
+// initial SPI cost per byte written, in ns; replaced by measurement (timing profile of the driver)
+#ifndef GxEPD2_PLANNER_SPI_BYTE_NS
+#define GxEPD2_PLANNER_SPI_BYTE_NS 4000
+#endif
+
+// commands and parameters sent per partial window, in bytes
+#ifndef GxEPD2_PLANNER_WINDOW_BYTES
+#define GxEPD2_PLANNER_WINDOW_BYTES 24
+#endif
+
+// refresh times assumed if the driver has none (0, "Undetermined"), in ms
+#ifndef GxEPD2_PLANNER_DEFAULT_FULL_MS
+#define GxEPD2_PLANNER_DEFAULT_FULL_MS 2000
+#endif
+#ifndef GxEPD2_PLANNER_DEFAULT_PARTIAL_MS
+#define GxEPD2_PLANNER_DEFAULT_PARTIAL_MS 500
+#endif
+
+class GxEPD2_RefreshPlanner
+{
+  public:
+    enum Mode
+    {
+      SKIP = 0,         // nothing changed
+      FULL = 1,         // full refresh, display(false)
+      BOUNDING_BOX = 2, // one partial refresh of the bounding box of all changes
+      WINDOWS = 3       // one partial refresh per changed rectangle
+    };
+    struct Plan
+    {
+      Mode mode;
+      uint32_t cost_us;     // estimated cost of the chosen mode
+      uint32_t full_us;     // estimated cost of full refresh
+      uint32_t box_us;      // estimated cost of bounding box partial refresh
+      uint32_t windows_us;  // estimated cost of partial refresh of each rectangle
+    };
+    // timing attributes of the driver, in ms; 0 means undetermined
+    GxEPD2_RefreshPlanner(uint16_t width, uint16_t height, bool partial_update, bool fast_partial_update,
+                          uint16_t power_on_time, uint16_t power_off_time, uint16_t full_refresh_time, uint16_t partial_refresh_time) :
+      _width(width), _height(height), _partial_update(partial_update), _fast_partial_update(fast_partial_update),
+      _power_on_us(uint32_t(power_on_time) * 1000), _power_off_us(uint32_t(power_off_time) * 1000)
+    {
+      _full_us = uint32_t(full_refresh_time ? full_refresh_time : GxEPD2_PLANNER_DEFAULT_FULL_MS) * 1000;
+      _partial_us = uint32_t(partial_refresh_time ? partial_refresh_time : GxEPD2_PLANNER_DEFAULT_PARTIAL_MS) * 1000;
+      _spi_byte_ns = GxEPD2_PLANNER_SPI_BYTE_NS;
+    }
+    // choose the cheapest refresh for the changes; force_full e.g. if the ghosting budget asks for a full refresh
+    Plan plan(const GxEPD2_FrameDiff& diff, bool force_full = false) const
+    {
+      return plan(diff.rects, diff.count, force_full || (diff.flipped == GxEPD2_FrameDiff::UNKNOWN));
+    }
+    // rects: changed rectangles, native coordinates, x and w multiple of 8
+    Plan plan(const GxEPD2_FrameDiff::Rect* rects, uint8_t count, bool force_full = false) const
+    {
+      Plan p;
+      p.full_us = fullCost();
+      p.box_us = p.windows_us = 0xFFFFFFFF;
+      if ((0 == count) && !force_full)
+      {
+        p.mode = SKIP;
+        p.cost_us = 0;
+        return p;
+      }
+      p.mode = FULL;
+      p.cost_us = p.full_us;
+      if (force_full || !_partial_update) return p;
+      uint16_t x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+      p.windows_us = 0;
+      for (uint8_t i = 0; i < count; i++)
+      {
+        p.windows_us += windowCost(rects[i].w, rects[i].h);
+        if (rects[i].x < x0) x0 = rects[i].x;
+        if (rects[i].y < y0) y0 = rects[i].y;
+        if (rects[i].x + rects[i].w > x1) x1 = rects[i].x + rects[i].w;
+        if (rects[i].y + rects[i].h > y1) y1 = rects[i].y + rects[i].h;
+      }
+      p.box_us = windowCost(x1 - x0, y1 - y0);
+      if (p.box_us < p.cost_us)
+      {
+        p.mode = BOUNDING_BOX;
+        p.cost_us = p.box_us;
+      }
+      if ((count > 1) && (p.windows_us < p.cost_us))
+      {
+        p.mode = WINDOWS;
+        p.cost_us = p.windows_us;
+      }
+      return p;
+    }
+    // estimated cost of full refresh: frame written (twice with fast partial update, for the differential buffer),
+    // power on, refresh and power off
+    uint32_t fullCost() const
+    {
+      uint32_t bytes = uint32_t(_width / 8) * _height * (_fast_partial_update ? 2 : 1);
+      return _writeCost(bytes) + _power_on_us + _full_us + _power_off_us;
+    }
+    // estimated cost of partial refresh of one window
+    uint32_t windowCost(uint16_t w, uint16_t h) const
+    {
+      uint32_t bytes = uint32_t((w + 7) / 8) * h + GxEPD2_PLANNER_WINDOW_BYTES;
+      if (_fast_partial_update) bytes *= 2; // written again after refresh
+      return _writeCost(bytes) + _partial_us;
+    }
+    // measurement, averaged: elapsed us of the data transfer of bytes, without controller init, power on or busy waits
+    // GxEPD2_BW takes the SPI cost per byte from the timing profile of the driver instead
+    void measuredWrite(uint32_t bytes, uint32_t elapsed_us)
+    {
+      if (bytes < 64) return; // too short to be meaningful
+      _spi_byte_ns = _average(_spi_byte_ns, uint32_t((uint64_t(elapsed_us) * 1000) / bytes));
+    }
+    // measured or explicit values, e.g. from the timing profile of the driver; 0 keeps the actual value
+    void setTiming(uint32_t full_refresh_us, uint32_t partial_refresh_us, uint32_t spi_byte_ns = 0,
+                   uint32_t power_on_us = 0, uint32_t power_off_us = 0)
+    {
+      if (full_refresh_us) _full_us = full_refresh_us;
+      if (partial_refresh_us) _partial_us = partial_refresh_us;
+      if (spi_byte_ns) _spi_byte_ns = spi_byte_ns;
+      if (power_on_us) _power_on_us = power_on_us;
+      if (power_off_us) _power_off_us = power_off_us;
+    }
+    uint32_t fullRefreshTime() const
+    {
+      return _full_us;
+    }
+    uint32_t partialRefreshTime() const
+    {
+      return _partial_us;
+    }
+    uint32_t spiByteCost() const
+    {
+      return _spi_byte_ns;
+    }
+  private:
+    uint32_t _writeCost(uint32_t bytes) const
+    {
+      return uint32_t((uint64_t(bytes) * _spi_byte_ns) / 1000);
+    }
+    static uint32_t _average(uint32_t average, uint32_t value)
+    {
+      return average - average / 4 + value / 4; // exponentially weighted, alpha 1/4
+    }
+  private:
+    const uint16_t _width, _height;
+    const bool _partial_update, _fast_partial_update;
+    uint32_t _power_on_us, _power_off_us;
+    uint32_t _full_us, _partial_us, _spi_byte_ns;
+};
+
+#endif
@@ -0,0 +1,66 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI statistics: counts commands, data bytes, transactions and busy waits through the SPI monitor hook of GxEPD2_EPD.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_SpiStatistics_H_
+#define _GxEPD2_SpiStatistics_H_
+
+#include "GxEPD2_EPD.h"
+
+#if ENABLE_GxEPD2_SPI_MONITOR
+
+class GxEPD2_SpiStatistics
+{
+  public:
+    uint32_t commands;
+    uint32_t data_bytes;
+    uint32_t transactions; // CS active periods
+    uint32_t busy_waits;
+    uint32_t busy_us;
+    uint32_t resets;
+    GxEPD2_SpiStatistics()
+    {
+      clear();
+    }
+    void clear()
+    {
+      commands = data_bytes = transactions = busy_waits = busy_us = resets = 0;
+    }
+    uint32_t bytes() const
+    {
+      return commands + data_bytes;
+    }
+    // start counting the events of epd, e.g. attach(display.epd2)
+    void attach(GxEPD2_EPD& epd)
+    {
+      epd.setSpiMonitor(monitor, this);
+    }
+    void detach(GxEPD2_EPD& epd)
+    {
+      epd.setSpiMonitor(0);
+    }
+    static void monitor(GxEPD2_EPD::SpiEvent event, uint32_t value, void* pv)
+    {
+      GxEPD2_SpiStatistics* s = static_cast<GxEPD2_SpiStatistics*>(pv);
+      switch (event)
+      {
+        case GxEPD2_EPD::SPI_BEGIN: s->transactions++; break;
+        case GxEPD2_EPD::SPI_COMMAND: s->commands++; break;
+        case GxEPD2_EPD::SPI_DATA: s->data_bytes++; break;
+        case GxEPD2_EPD::SPI_BUSY: s->busy_waits++; s->busy_us += value; break;
+        case GxEPD2_EPD::SPI_RESET: s->resets++; break;
+        default: break;
+      }
+    }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,479 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// SPI trace: records the command and data stream of a GxEPD2_EPD through its SPI monitor hook into a compact binary trace,
+// reads traces back, summarizes and compares them, and replays them to a controller.
+//
+// trace format: header "G2ST", version, flags (bit 0: all data bytes recorded), then events:
+//   0x01 CS active, 0x02 CS inactive, 0x03 <command>, 0x04 <varint n> <n data bytes>,
+//   0x05 <varint n> <fletcher16 lsb msb> (data not recorded), 0x06 <varint us> busy, 0x07 reset,
+//   0x08 <varint n> <n data bytes>: n transactions of one data byte each, 0x09 <varint n> <fletcher16 lsb msb> (data not recorded)
+// consecutive 0x04 (0x08) chunks are one run; runs longer than GxEPD2_SPI_TRACE_CHUNK are 0x05 (0x09) unless all data is recorded
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_SpiTrace_H_
+#define _GxEPD2_SpiTrace_H_
+
+#include "GxEPD2_EPD.h"
+
+#if ENABLE_GxEPD2_SPI_MONITOR
+
+// data bytes per chunk, also the longest data run recorded with its bytes in compact traces
+#ifndef GxEPD2_SPI_TRACE_CHUNK
+#define GxEPD2_SPI_TRACE_CHUNK 16
+#endif
+
+class GxEPD2_SpiTrace
+{
+  public:
+    enum Tag
+    {
+      TAG_BEGIN = 0x01,
+      TAG_END = 0x02,
+      TAG_COMMAND = 0x03,
+      TAG_DATA = 0x04,
+      TAG_DATA_SUMMARY = 0x05,
+      TAG_BUSY = 0x06,
+      TAG_RESET = 0x07,
+      TAG_SINGLES = 0x08,        // drivers that write data byte by byte, each in its own transaction
+      TAG_SINGLES_SUMMARY = 0x09
+    };
+    static const uint8_t version = 1;
+    static const uint8_t FLAG_ALL_DATA = 0x01;
+    // out receives the trace, e.g. a File or a GxEPD2_SpiTraceBuffer; all_data is needed for replay
+    GxEPD2_SpiTrace(Print& out, bool all_data = false) : _out(out), _all_data(all_data), _open(false), _run_n(0), _run_total(0) {}
+    // writes the header and starts recording events of epd
+    void attach(GxEPD2_EPD& epd)
+    {
+      _out.write((const uint8_t*)"G2ST", 4);
+      _out.write(version);
+      _out.write(_all_data ? FLAG_ALL_DATA : 0);
+      _open = false;
+      _run_n = 0;
+      _run_total = 0;
+      epd.setSpiMonitor(monitor, this);
+    }
+    void detach(GxEPD2_EPD& epd)
+    {
+      _flushOpen();
+      _flushRun();
+      epd.setSpiMonitor(0);
+    }
+    static void monitor(GxEPD2_EPD::SpiEvent event, uint32_t value, void* pv)
+    {
+      GxEPD2_SpiTrace* t = static_cast<GxEPD2_SpiTrace*>(pv);
+      // a transaction is held open until it is known to be a single data byte transaction, or not
+      if (t->_open)
+      {
+        if ((event == GxEPD2_EPD::SPI_DATA) && (0 == t->_open_n))
+        {
+          t->_open_n = 1;
+          t->_open_byte = value;
+          return;
+        }
+        if ((event == GxEPD2_EPD::SPI_END) && (1 == t->_open_n))
+        {
+          t->_open = false;
+          t->_data(TAG_SINGLES, t->_open_byte);
+          return;
+        }
+        t->_flushOpen();
+      }
+      if (event == GxEPD2_EPD::SPI_DATA)
+      {
+        t->_data(TAG_DATA, value);
+        return;
+      }
+      if (event == GxEPD2_EPD::SPI_BEGIN)
+      {
+        t->_open = true;
+        t->_open_n = 0;
+        return;
+      }
+      t->_flushRun();
+      switch (event)
+      {
+        case GxEPD2_EPD::SPI_END: t->_out.write(TAG_END); break;
+        case GxEPD2_EPD::SPI_COMMAND: t->_out.write(TAG_COMMAND); t->_out.write(uint8_t(value)); break;
+        case GxEPD2_EPD::SPI_BUSY: t->_out.write(TAG_BUSY); t->_varint(value); break;
+        case GxEPD2_EPD::SPI_RESET: t->_out.write(TAG_RESET); break;
+        default: break;
+      }
+    }
+    static uint16_t fletcher16(uint16_t sum, uint8_t b)
+    {
+      uint8_t s1 = (sum & 0xFF) + b;
+      if (s1 < b) s1++; // end-around carry, modulo 255
+      uint8_t s2 = (sum >> 8) + s1;
+      if (s2 < s1) s2++;
+      return (uint16_t(s2) << 8) | s1;
+    }
+  private:
+    // held open transaction is not a single data byte transaction: write it as such
+    void _flushOpen()
+    {
+      if (!_open) return;
+      _open = false;
+      _flushRun();
+      _out.write(TAG_BEGIN);
+      if (_open_n) _data(TAG_DATA, _open_byte);
+    }
+    void _data(uint8_t tag, uint8_t b)
+    {
+      if (_run_total && (tag != _run_tag)) _flushRun();
+      _run_tag = tag;
+      _sum = _run_total ? fletcher16(_sum, b) : fletcher16(0, b);
+      _run_total++;
+      if (_run_n < GxEPD2_SPI_TRACE_CHUNK) _run[_run_n++] = b;
+      if (_all_data && (_run_n == GxEPD2_SPI_TRACE_CHUNK)) _writeChunk();
+    }
+    void _writeChunk()
+    {
+      _out.write(_run_tag);
+      _varint(_run_n);
+      _out.write(_run, _run_n);
+      _run_n = 0;
+    }
+    void _flushRun()
+    {
+      if (0 == _run_total) return;
+      if (_all_data || (_run_total <= GxEPD2_SPI_TRACE_CHUNK))
+      {
+        if (_run_n > 0) _writeChunk();
+      }
+      else
+      {
+        _out.write(_run_tag == TAG_DATA ? TAG_DATA_SUMMARY : TAG_SINGLES_SUMMARY);
+        _varint(_run_total);
+        _out.write(uint8_t(_sum & 0xFF));
+        _out.write(uint8_t(_sum >> 8));
+      }
+      _run_n = 0;
+      _run_total = 0;
+    }
+    void _varint(uint32_t v)
+    {
+      while (v >= 0x80)
+      {
+        _out.write(uint8_t(v | 0x80));
+        v >>= 7;
+      }
+      _out.write(uint8_t(v));
+    }
+  private:
+    Print& _out;
+    const bool _all_data;
+    bool _open;
+    uint8_t _open_n, _open_byte;
+    uint8_t _run_tag;
+    uint8_t _run[GxEPD2_SPI_TRACE_CHUNK];
+    uint8_t _run_n;
+    uint32_t _run_total;
+    uint16_t _sum;
+};
+
+// trace sink in RAM
+class GxEPD2_SpiTraceBuffer : public Print
+{
+  public:
+    GxEPD2_SpiTraceBuffer(uint8_t* buffer, uint32_t size) : _buffer(buffer), _size(size), _length(0), _overflow(false) {}
+    size_t write(uint8_t b)
+    {
+      if (_length >= _size)
+      {
+        _overflow = true;
+        return 0;
+      }
+      _buffer[_length++] = b;
+      return 1;
+    }
+    using Print::write;
+    const uint8_t* data() const
+    {
+      return _buffer;
+    }
+    uint32_t length() const
+    {
+      return _length;
+    }
+    bool overflow() const
+    {
+      return _overflow;
+    }
+    void clear()
+    {
+      _length = 0;
+      _overflow = false;
+    }
+  private:
+    uint8_t* _buffer;
+    uint32_t _size, _length;
+    bool _overflow;
+};
+
+// reads the events of a trace, from RAM or from a Stream, e.g. a File
+class GxEPD2_SpiTraceReader
+{
+  public:
+    struct Event
+    {
+      uint8_t tag;       // GxEPD2_SpiTrace::Tag
+      uint8_t command;   // TAG_COMMAND
+      uint32_t value;    // TAG_DATA, TAG_SINGLES and summaries: number of bytes; TAG_BUSY: us
+      uint16_t checksum; // summaries
+      uint8_t data[GxEPD2_SPI_TRACE_CHUNK]; // TAG_DATA, TAG_SINGLES
+    };
+    GxEPD2_SpiTraceReader(const uint8_t* trace, uint32_t size) : _trace(trace), _stream(0), _size(size), _pos(0), _flags(0), _valid(false)
+    {
+      _valid = _header();
+    }
+    GxEPD2_SpiTraceReader(Stream& stream) : _trace(0), _stream(&stream), _size(0), _pos(0), _flags(0), _valid(false)
+    {
+      _valid = _header();
+    }
+    bool valid() const
+    {
+      return _valid;
+    }
+    bool allData() const
+    {
+      return _flags & GxEPD2_SpiTrace::FLAG_ALL_DATA;
+    }
+    // false at end of trace or on format error
+    bool next(Event& e)
+    {
+      if (!_valid) return false;
+      int tag = _read();
+      if (tag < 0) return false;
+      e.tag = tag;
+      e.value = 0;
+      switch (tag)
+      {
+        case GxEPD2_SpiTrace::TAG_BEGIN:
+        case GxEPD2_SpiTrace::TAG_END:
+        case GxEPD2_SpiTrace::TAG_RESET:
+          return true;
+        case GxEPD2_SpiTrace::TAG_COMMAND:
+          {
+            int c = _read();
+            e.command = c;
+            return _check(c >= 0);
+          }
+        case GxEPD2_SpiTrace::TAG_DATA:
+        case GxEPD2_SpiTrace::TAG_SINGLES:
+          if (!_check(_varint(e.value) && (e.value <= GxEPD2_SPI_TRACE_CHUNK))) return false;
+          for (uint8_t i = 0; i < e.value; i++)
+          {
+            int b = _read();
+            if (!_check(b >= 0)) return false;
+            e.data[i] = b;
+          }
+          return true;
+        case GxEPD2_SpiTrace::TAG_DATA_SUMMARY:
+        case GxEPD2_SpiTrace::TAG_SINGLES_SUMMARY:
+          {
+            if (!_check(_varint(e.value))) return false;
+            int lsb = _read(), msb = _read();
+            e.checksum = (uint16_t(msb) << 8) | uint8_t(lsb);
+            return _check(msb >= 0);
+          }
+        case GxEPD2_SpiTrace::TAG_BUSY:
+          return _check(_varint(e.value));
+      }
+      return _check(false);
+    }
+  private:
+    int _read()
+    {
+      if (_stream) return _stream->available() > 0 ? _stream->read() : -1;
+      return _pos < _size ? _trace[_pos++] : -1;
+    }
+    bool _header()
+    {
+      const char* magic = "G2ST";
+      for (uint8_t i = 0; i < 4; i++) if (_read() != magic[i]) return false;
+      if (_read() != GxEPD2_SpiTrace::version) return false;
+      int flags = _read();
+      _flags = flags;
+      return flags >= 0;
+    }
+    bool _varint(uint32_t& v)
+    {
+      v = 0;
+      for (uint8_t shift = 0; shift < 35; shift += 7)
+      {
+        int b = _read();
+        if (b < 0) return false;
+        v |= uint32_t(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+      }
+      return false;
+    }
+    bool _check(bool ok)
+    {
+      if (!ok) _valid = false;
+      return ok;
+    }
+  private:
+    const uint8_t* _trace;
+    Stream* _stream;
+    uint32_t _size, _pos;
+    uint8_t _flags;
+    bool _valid;
+};
+
+// counts of a trace; redundant commands: commands with parameters sent again with the same parameters, without reset in between
+// uses about 1.3k bytes of RAM for the parameter signatures of all command codes
+class GxEPD2_SpiTraceSummary
+{
+  public:
+    uint32_t events, commands, data_bytes, transactions, busy_waits, busy_us, resets, redundant_commands;
+    GxEPD2_SpiTraceSummary()
+    {
+      clear();
+    }
+    void clear()
+    {
+      events = commands = data_bytes = transactions = busy_waits = busy_us = resets = redundant_commands = 0;
+      _forget();
+      _command = -1;
+    }
+    uint32_t bytes() const
+    {
+      return commands + data_bytes;
+    }
+    // adds the events of the trace; false if the trace is not valid
+    bool add(GxEPD2_SpiTraceReader& reader)
+    {
+      GxEPD2_SpiTraceReader::Event e;
+      while (reader.next(e))
+      {
+        events++;
+        if ((e.tag == GxEPD2_SpiTrace::TAG_COMMAND) || (e.tag == GxEPD2_SpiTrace::TAG_BUSY) || (e.tag == GxEPD2_SpiTrace::TAG_RESET)) _endParameters();
+        switch (e.tag)
+        {
+          case GxEPD2_SpiTrace::TAG_BEGIN: transactions++; break;
+          case GxEPD2_SpiTrace::TAG_COMMAND:
+            commands++;
+            _command = e.command;
+            _params = 0;
+            _params_sum = 0;
+            _params_long = false;
+            break;
+          case GxEPD2_SpiTrace::TAG_SINGLES:
+            transactions += e.value;
+          // fall through
+          case GxEPD2_SpiTrace::TAG_DATA:
+            data_bytes += e.value;
+            for (uint8_t i = 0; i < e.value; i++) _params_sum = GxEPD2_SpiTrace::fletcher16(_params_sum, e.data[i]);
+            _params += e.value;
+            break;
+          case GxEPD2_SpiTrace::TAG_SINGLES_SUMMARY:
+            transactions += e.value;
+          // fall through
+          case GxEPD2_SpiTrace::TAG_DATA_SUMMARY:
+            data_bytes += e.value;
+            _params_long = true; // e.g. RAM data, not a parameter set
+            break;
+          case GxEPD2_SpiTrace::TAG_BUSY: busy_waits++; busy_us += e.value; break;
+          case GxEPD2_SpiTrace::TAG_RESET: resets++; _forget(); break;
+        }
+      }
+      _endParameters();
+      return reader.valid();
+    }
+    // CSV line: name,events,commands,data_bytes,transactions,busy_waits,busy_us,resets,redundant_commands
+    void print(Print& out, const char* name) const
+    {
+      uint32_t v[] = {events, commands, data_bytes, transactions, busy_waits, busy_us, resets, redundant_commands};
+      out.print(name);
+      for (uint8_t i = 0; i < sizeof(v) / sizeof(v[0]); i++)
+      {
+        out.print(",");
+        out.print(v[i]);
+      }
+      out.println();
+    }
+    // CSV lines of a, b and the difference b - a
+    static void compare(Print& out, const GxEPD2_SpiTraceSummary& a, const GxEPD2_SpiTraceSummary& b)
+    {
+      out.println("trace,events,commands,data_bytes,transactions,busy_waits,busy_us,resets,redundant_commands");
+      a.print(out, "a");
+      b.print(out, "b");
+      uint32_t va[] = {a.events, a.commands, a.data_bytes, a.transactions, a.busy_waits, a.busy_us, a.resets, a.redundant_commands};
+      uint32_t vb[] = {b.events, b.commands, b.data_bytes, b.transactions, b.busy_waits, b.busy_us, b.resets, b.redundant_commands};
+      out.print("b-a");
+      for (uint8_t i = 0; i < sizeof(va) / sizeof(va[0]); i++)
+      {
+        out.print(",");
+        out.print(long(vb[i]) - long(va[i]));
+      }
+      out.println();
+    }
+  private:
+    void _endParameters()
+    {
+      if (_command < 0) return;
+      if ((_params > 0) && !_params_long && (_params <= 0xFF))
+      {
+        uint32_t signature = (uint32_t(_params) << 16) | _params_sum;
+        uint8_t c = _command;
+        bool known = _known[c / 8] & (1 << (c % 8));
+        if (known && (_signature[c] == signature)) redundant_commands++;
+        _signature[c] = signature;
+        _known[c / 8] |= (1 << (c % 8));
+      }
+      _command = -1;
+    }
+    void _forget()
+    {
+      memset(_known, 0, sizeof(_known));
+    }
+  private:
+    uint32_t _signature[256];
+    uint8_t _known[32];
+    int16_t _command;
+    uint32_t _params;
+    uint16_t _params_sum;
+    bool _params_long;
+};
+
+// sends the events of a trace recorded with all data to the controller of epd; false if the trace is not replayable
+static inline bool GxEPD2_replaySpiTrace(GxEPD2_SpiTraceReader& reader, GxEPD2_EPD& epd)
+{
+  if (!reader.valid() || !reader.allData()) return false;
+  GxEPD2_SpiTraceReader::Event e;
+  while (reader.next(e))
+  {
+    switch (e.tag)
+    {
+      case GxEPD2_SpiTrace::TAG_BEGIN: epd.replaySpiEvent(GxEPD2_EPD::SPI_BEGIN, 0); break;
+      case GxEPD2_SpiTrace::TAG_END: epd.replaySpiEvent(GxEPD2_EPD::SPI_END, 0); break;
+      case GxEPD2_SpiTrace::TAG_COMMAND: epd.replaySpiEvent(GxEPD2_EPD::SPI_COMMAND, e.command); break;
+      case GxEPD2_SpiTrace::TAG_DATA:
+        for (uint8_t i = 0; i < e.value; i++) epd.replaySpiEvent(GxEPD2_EPD::SPI_DATA, e.data[i]);
+        break;
+      case GxEPD2_SpiTrace::TAG_SINGLES:
+        for (uint8_t i = 0; i < e.value; i++)
+        {
+          epd.replaySpiEvent(GxEPD2_EPD::SPI_BEGIN, 0);
+          epd.replaySpiEvent(GxEPD2_EPD::SPI_DATA, e.data[i]);
+          epd.replaySpiEvent(GxEPD2_EPD::SPI_END, 0);
+        }
+        break;
+      case GxEPD2_SpiTrace::TAG_BUSY: epd.replaySpiEvent(GxEPD2_EPD::SPI_BUSY, e.value); break;
+      case GxEPD2_SpiTrace::TAG_RESET: epd.replaySpiEvent(GxEPD2_EPD::SPI_RESET, 0); break;
+      default: return false;
+    }
+  }
+  return reader.valid();
+}
+
+#endif
+
+#endif
@@ -0,0 +1,140 @@
+// Display Library for SPI e-paper panels from Dalian Good Display and boards from Waveshare.
+// Requires HW SPI and Adafruit_GFX. Caution: these e-papers require 3.3V supply AND data lines!
+//
+// Timing profile: busy durations measured per operation type, averaged, with minimum and maximum.
+// Replaces the bench sample timing attributes of the drivers once measured; can be saved and restored.
+// Also the time of the data bursts (image and screen buffer data), for the SPI cost per byte.
+//
+// Author: Jean-Marc Zingg
+//
+// Version: see library.properties
+//
+// Library: https://github.com/ZinggJM/GxEPD2
+
+#ifndef _GxEPD2_TimingProfile_H_
+#define _GxEPD2_TimingProfile_H_
+
+#include <Arduino.h>
+
+// compiled into GxEPD2_EPD.cpp, override by build flag only; costs about 100 bytes of RAM per display
+#ifndef ENABLE_GxEPD2_TIMING_PROFILE
+#if defined(__AVR)
+#define ENABLE_GxEPD2_TIMING_PROFILE 0
+#else
+#define ENABLE_GxEPD2_TIMING_PROFILE 1
+#endif
+#endif
+
+class GxEPD2_TimingProfile
+{
+  public:
+    enum Operation
+    {
+      POWER_ON = 0,
+      POWER_OFF = 1,
+      UPDATE_FULL = 2,  // full refresh of the screen
+      UPDATE_PART = 3,  // partial refresh
+      RESET = 4,        // reset and controller init
+      UPDATE_WINDOW = 5, // full waveform refresh of a window
+      OTHER = 6,
+      OPERATIONS = 7
+    };
+    struct Stats
+    {
+      uint32_t average_us; // exponentially weighted, alpha 1/4
+      uint32_t min_us;
+      uint32_t max_us;
+      uint32_t count;
+    };
+    // size of the data written by save()
+    static const uint16_t storage_size = 4 + OPERATIONS * sizeof(Stats);
+    GxEPD2_TimingProfile()
+    {
+      clear();
+    }
+    void clear()
+    {
+      for (uint8_t i = 0; i < OPERATIONS; i++)
+      {
+        _stats[i].average_us = _stats[i].max_us = _stats[i].count = 0;
+        _stats[i].min_us = 0xFFFFFFFF;
+      }
+      _transfer_bytes = _transfer_us = 0;
+    }
+    // operation type from the comment of _waitWhileBusy()
+    static Operation operation(const char* comment)
+    {
+      if (!comment) return OTHER;
+      if (strcmp(comment, "_Update_Full") == 0) return UPDATE_FULL;
+      if (strcmp(comment, "_Update_Full_Window") == 0) return UPDATE_WINDOW;
+      if (strcmp(comment, "_Update_Part") == 0) return UPDATE_PART;
+      if (strcmp(comment, "refresh") == 0) return UPDATE_PART; // partial refresh of GxEPD2_270 and GxEPD2_270c
+      if ((strcmp(comment, "_PowerOn") == 0) || (strcmp(comment, "PowerOn") == 0) || (strcmp(comment, "_wakeUp Power On") == 0)) return POWER_ON;
+      if (strcmp(comment, "_PowerOff") == 0) return POWER_OFF;
+      if ((strcmp(comment, "_reset") == 0) || (strcmp(comment, "soft reset") == 0) || (strcmp(comment, "init reset_to_ready") == 0)) return RESET;
+      return OTHER;
+    }
+    void record(Operation op, uint32_t elapsed_us)
+    {
+      if (op >= OPERATIONS) return;
+      Stats& s = _stats[op];
+      s.average_us = s.count ? s.average_us - s.average_us / 4 + elapsed_us / 4 : elapsed_us;
+      if (elapsed_us < s.min_us) s.min_us = elapsed_us;
+      if (elapsed_us > s.max_us) s.max_us = elapsed_us;
+      if (s.count < 0xFFFFFFFF) s.count++;
+    }
+    const Stats& stats(Operation op) const
+    {
+      return _stats[op < OPERATIONS ? op : OTHER];
+    }
+    // average busy time in us, 0 if not yet measured
+    uint32_t average(Operation op) const
+    {
+      return stats(op).count ? stats(op).average_us : 0;
+    }
+    // expected busy time in us, e.g. for a scheduler to sleep instead of polling; fallback_us if not yet measured
+    uint32_t expected(Operation op, uint32_t fallback_us) const
+    {
+      return stats(op).count ? stats(op).average_us : fallback_us;
+    }
+    // data burst of bytes, from _startTransfer() to _endTransfer() of the driver; no delays or busy waits are in between
+    void transferred(uint32_t bytes, uint32_t elapsed_us)
+    {
+      _transfer_bytes += bytes;
+      _transfer_us += elapsed_us;
+      if (_transfer_bytes & 0x80000000) // keeps the ratio, weights recent bursts more
+      {
+        _transfer_bytes /= 2;
+        _transfer_us /= 2;
+      }
+    }
+    // average time of a data byte in ns, including the per byte overhead of the driver; 0 if not yet measured
+    uint32_t transferByteNs() const
+    {
+      if (_transfer_bytes < 64) return 0; // too few to be meaningful
+      uint32_t ns = uint32_t((uint64_t(_transfer_us) * 1000) / _transfer_bytes);
+      return ns > 0 ? ns : 1;
+    }
+    // persistence, e.g. to EEPROM or Preferences; data tagged with panel, load() rejects data of another panel
+    uint16_t save(uint8_t* data, uint16_t size, uint8_t panel) const
+    {
+      if (size < storage_size) return 0;
+      data[0] = 'G';
+      data[1] = 'T';
+      data[2] = OPERATIONS;
+      data[3] = panel;
+      memcpy(data + 4, _stats, sizeof(_stats));
+      return storage_size;
+    }
+    bool load(const uint8_t* data, uint16_t size, uint8_t panel)
+    {
+      if ((size < storage_size) || (data[0] != 'G') || (data[1] != 'T') || (data[2] != OPERATIONS) || (data[3] != panel)) return false;
+      memcpy(_stats, data + 4, sizeof(_stats));
+      return true;
+    }
+  private:
+    Stats _stats[OPERATIONS];
+    uint32_t _transfer_bytes, _transfer_us; // not saved
+};
+
+#endif
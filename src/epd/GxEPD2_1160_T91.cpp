@@ -42,10 +42,7 @@ void GxEPD2_1160_T91::writeScreenBufferAgain(uint8_t value)
 void GxEPD2_1160_T91::_writeScreenBuffer(uint8_t command, uint8_t value)
 {
   _writeCommand(command);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(value);
-  }
+  _writeDataFill(value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
 }
 
 void GxEPD2_1160_T91::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -84,29 +81,7 @@ void GxEPD2_1160_T91::_writeImage(uint8_t command, const uint8_t bitmap[], int16
   if (!_using_partial_mode) _Init_Part();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data;
-      // use wb, h of bitmap for index!
-      int32_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _writeData(data);
-    }
-  }
+  _writeImageData(bitmap, w1 / 8, h1, wb, h, dx / 8, dy, invert, mirror_y, pgm);
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
@@ -148,29 +123,7 @@ void GxEPD2_1160_T91::_writeImagePart(uint8_t command, const uint8_t bitmap[], i
   if (!_using_partial_mode) _Init_Part();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data;
-      // use wb_bitmap, h_bitmap of bitmap for index!
-      int32_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _writeData(data);
-    }
-  }
+  _writeImageData(bitmap, w1 / 8, h1, wb_bitmap, h_bitmap, x_part / 8 + dx / 8, y_part + dy, invert, mirror_y, pgm);
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
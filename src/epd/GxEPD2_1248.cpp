@@ -18,46 +18,46 @@
 GxEPD2_1248::GxEPD2_1248(int8_t sck, int8_t miso, int8_t mosi,
                          int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2,
                          int8_t dc1, int8_t dc2, int8_t rst1, int8_t rst2,
-                         int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2) :
-  GxEPD2_EPD(cs_m1, dc1, rst1, busy_m1, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
+                         int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2, SPIClass& spi) :
+  GxEPD2_EPD(cs_m1, dc1, rst1, busy_m1, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, spi),
   _sck(sck), _miso(miso), _mosi(mosi), _dc1(dc1), _dc2(dc2), _rst1(rst1), _rst2(rst2),
   _cs_m1(cs_m1), _cs_s1(cs_s1), _cs_m2(cs_m2), _cs_s2(cs_s2),
   _busy_m1(busy_m1), _busy_s1(busy_s1), _busy_m2(busy_m2), _busy_s2(busy_s2),
-  _temperature(20),
-  M1(648, 492, false, cs_m1, dc1),
-  S1(656, 492, false, cs_s1, dc1),
-  M2(656, 492, true, cs_m2, dc2),
-  S2(648, 492, true, cs_s2, dc2)
+  _temperature(20), _powered_masters(0),
+  M1(648, 492, false, cs_m1, dc1, spi),
+  S1(656, 492, false, cs_s1, dc1, spi),
+  M2(656, 492, true, cs_m2, dc2, spi),
+  S2(648, 492, true, cs_s2, dc2, spi)
 {
 }
 #else
 // general constructor for use with standard SPI pins, default SCK, MISO and MOSI
 GxEPD2_1248::GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2,
                          int8_t dc1, int8_t dc2, int8_t rst1, int8_t rst2,
-                         int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2) :
-  GxEPD2_EPD(cs_m1, dc1, rst1, busy_m1, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
+                         int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2, SPIClass& spi) :
+  GxEPD2_EPD(cs_m1, dc1, rst1, busy_m1, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, spi),
   _sck(SCK), _miso(MISO), _mosi(MOSI), _dc1(dc1), _dc2(dc2), _rst1(rst1), _rst2(rst2),
   _cs_m1(cs_m1), _cs_s1(cs_s1), _cs_m2(cs_m2), _cs_s2(cs_s2),
   _busy_m1(busy_m1), _busy_s1(busy_s1), _busy_m2(busy_m2), _busy_s2(busy_s2),
-  _temperature(20),
-  M1(648, 492, false, cs_m1, dc1),
-  S1(656, 492, false, cs_s1, dc1),
-  M2(656, 492, true, cs_m2, dc2),
-  S2(648, 492, true, cs_s2, dc2)
+  _temperature(20), _powered_masters(0),
+  M1(648, 492, false, cs_m1, dc1, spi),
+  S1(656, 492, false, cs_s1, dc1, spi),
+  M2(656, 492, true, cs_m2, dc2, spi),
+  S2(648, 492, true, cs_s2, dc2, spi)
 {
 }
 
 // constructor with minimal parameter set, standard SPI, dc1 and dc2, rst1 and rst2 to one pin, one busy used (can be -1)
-GxEPD2_1248::GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2, int8_t dc, int8_t rst, int8_t busy) :
-  GxEPD2_EPD(23, 25, 33, 32, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
+GxEPD2_1248::GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2, int8_t dc, int8_t rst, int8_t busy, SPIClass& spi) :
+  GxEPD2_EPD(23, 25, 33, 32, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, spi),
   _sck(SCK), _miso(MISO), _mosi(MOSI), _dc1(dc), _dc2(dc), _rst1(rst), _rst2(rst),
   _cs_m1(cs_m1), _cs_s1(cs_s1), _cs_m2(cs_m2), _cs_s2(cs_s2),
   _busy_m1(busy), _busy_s1(busy), _busy_m2(busy), _busy_s2(busy),
-  _temperature(20),
-  M1(648, 492, false, cs_m1, dc),
-  S1(656, 492, false, cs_s1, dc),
-  M2(656, 492, true, cs_m2, dc),
-  S2(648, 492, true, cs_s2, dc)
+  _temperature(20), _powered_masters(0),
+  M1(648, 492, false, cs_m1, dc, spi),
+  S1(656, 492, false, cs_s1, dc, spi),
+  M2(656, 492, true, cs_m2, dc, spi),
+  S2(648, 492, true, cs_s2, dc, spi)
 {
 }
 #endif
@@ -110,37 +110,22 @@ void GxEPD2_1248::clearScreen(uint8_t value)
 void GxEPD2_1248::writeScreenBuffer(uint8_t value)
 {
   if (!_using_partial_mode) _Init_Part();
-  if (_initial_write)
-  {
-    M1.writeScreenBuffer(0x10, value);
-    S1.writeScreenBuffer(0x10, value);
-    M2.writeScreenBuffer(0x10, value);
-    S2.writeScreenBuffer(0x10, value);
-  }
-  M1.writeScreenBuffer(0x13, value);
-  S1.writeScreenBuffer(0x13, value);
-  M2.writeScreenBuffer(0x13, value);
-  S2.writeScreenBuffer(0x13, value);
+  if (_initial_write) _writeScreenBufferTo(ALL_TARGETS, 0x10, value);
+  _writeScreenBufferTo(ALL_TARGETS, 0x13, value);
   _initial_write = false; // initial full screen buffer clean done
 }
 
 void GxEPD2_1248::writeScreenBufferAgain(uint8_t value)
 {
   if (!_using_partial_mode) _Init_Part();
-  M1.writeScreenBuffer(0x10, value);
-  S1.writeScreenBuffer(0x10, value);
-  M2.writeScreenBuffer(0x10, value);
-  S2.writeScreenBuffer(0x10, value);
+  _writeScreenBufferTo(ALL_TARGETS, 0x10, value);
 }
 
 void GxEPD2_1248::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   if (!_using_partial_mode) _Init_Part();
-  S2.writeImagePart(0x13, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
-  M2.writeImagePart(0x13, bitmap, 0, 0, w, h, x - S2.WIDTH, y, w, h, invert, mirror_y, pgm);
-  M1.writeImagePart(0x13, bitmap, 0, 0, w, h, x, y - S2.HEIGHT, w, h, invert, mirror_y, pgm);
-  S1.writeImagePart(0x13, bitmap, 0, 0, w, h, x - M1.WIDTH, y - M2.HEIGHT, w, h, invert, mirror_y, pgm);
+  _writeImagePart(0x13, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void GxEPD2_1248::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
@@ -148,20 +133,14 @@ void GxEPD2_1248::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t
 {
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   if (!_using_partial_mode) _Init_Part();
-  S2.writeImagePart(0x13, bitmap, x_part, y_part, w, h, x, y, w, h, invert, mirror_y, pgm);
-  M2.writeImagePart(0x13, bitmap, x_part, y_part, w, h, x - S2.WIDTH, y, w, h, invert, mirror_y, pgm);
-  M1.writeImagePart(0x13, bitmap, x_part, y_part, w, h, x, y - S2.HEIGHT, w, h, invert, mirror_y, pgm);
-  S1.writeImagePart(0x13, bitmap, x_part, y_part, w, h, x - M1.WIDTH, y - M2.HEIGHT, w, h, invert, mirror_y, pgm);
+  _writeImagePart(0x13, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void GxEPD2_1248::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   if (!_using_partial_mode) _Init_Part();
-  S2.writeImagePart(0x10, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
-  M2.writeImagePart(0x10, bitmap, 0, 0, w, h, x - S2.WIDTH, y, w, h, invert, mirror_y, pgm);
-  M1.writeImagePart(0x10, bitmap, 0, 0, w, h, x, y - S2.HEIGHT, w, h, invert, mirror_y, pgm);
-  S1.writeImagePart(0x10, bitmap, 0, 0, w, h, x - M1.WIDTH, y - M2.HEIGHT, w, h, invert, mirror_y, pgm);
+  _writeImagePart(0x10, bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void GxEPD2_1248::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
@@ -169,10 +148,7 @@ void GxEPD2_1248::writeImagePartAgain(const uint8_t bitmap[], int16_t x_part, in
 {
   if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
   if (!_using_partial_mode) _Init_Part();
-  S2.writeImagePart(0x10, bitmap, x_part, y_part, w, h, x, y, w, h, invert, mirror_y, pgm);
-  M2.writeImagePart(0x10, bitmap, x_part, y_part, w, h, x - S2.WIDTH, y, w, h, invert, mirror_y, pgm);
-  M1.writeImagePart(0x10, bitmap, x_part, y_part, w, h, x, y - S2.HEIGHT, w, h, invert, mirror_y, pgm);
-  S1.writeImagePart(0x10, bitmap, x_part, y_part, w, h, x - M1.WIDTH, y - M2.HEIGHT, w, h, invert, mirror_y, pgm);
+  _writeImagePart(0x10, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
 }
 
 void GxEPD2_1248::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -254,8 +230,11 @@ void GxEPD2_1248::refresh(bool partial_update_mode)
 void GxEPD2_1248::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
 {
   if (_initial_refresh) return refresh(false); // initial update needs be full update
+  uint8_t targets = _targets(x, y, w, h);
+  if (!targets) return;
   if (!_using_partial_mode) _Init_Part();
-  _Update_Part();
+  _PowerOn(targets);
+  _Update_Part(targets);
 }
 
 void GxEPD2_1248::powerOff(void)
@@ -268,8 +247,8 @@ void GxEPD2_1248::hibernate()
   _PowerOff();
   if (_rst >= 0)
   {
-    _writeCommandAll(0x07); // deep sleep
-    _writeDataAll(0xA5);    // check code
+    _writeCommandTo(ALL_TARGETS, 0x07); // deep sleep
+    _writeDataTo(ALL_TARGETS, 0xA5);    // check code
     _hibernating = true;
   }
 }
@@ -283,19 +262,21 @@ void GxEPD2_1248::_reset(void)
   digitalWrite(_rst2, HIGH);
   delay(200);
   _hibernating = false;
+  _powered_masters = 0;
+  _power_is_on = false;
 }
 
 void GxEPD2_1248::_initSPI()
 {
 #if defined(ESP32)
-  if ((SCK != _sck) || (MISO != _miso) || (MOSI != _mosi))
+  if ((SCK != _sck) || (MISO != _miso) || (MOSI != _mosi) || (&SPI != &_spi))
   {
-    SPI.end();
-    SPI.begin(_sck, _miso, _mosi, _cs_m1);
+    _spi.end();
+    _spi.begin(_sck, _miso, _mosi, _cs_m1);
   }
-  else SPI.begin();
+  else _spi.begin();
 #else
-  SPI.begin();
+  _spi.begin();
 #endif
 }
 
@@ -316,23 +297,28 @@ void GxEPD2_1248::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_
   _writeData(0x01);
 }
 
-void GxEPD2_1248::_PowerOn()
+// powers the masters of the targets, a slave is driven by its master
+void GxEPD2_1248::_PowerOn(uint8_t targets)
 {
-  if (!_power_is_on)
+  uint8_t masters = (targets & (M1_TARGET | S1_TARGET) ? M1_TARGET : 0) | (targets & (M2_TARGET | S2_TARGET) ? M2_TARGET : 0);
+  masters &= ~_powered_masters;
+  if (masters)
   {
-    _writeCommandMaster(0x04);
-    _waitWhileAnyBusy("_PowerOn", power_on_time);
+    _writeCommandTo(masters, 0x04);
+    _waitWhileAnyBusy("_PowerOn", power_on_time, masters);
+    _powered_masters |= masters;
   }
   _power_is_on = true;
 }
 
 void GxEPD2_1248::_PowerOff()
 {
-  if (_power_is_on)
+  if (_powered_masters)
   {
-    _writeCommandMaster(0x02); // power off
-    _waitWhileAnyBusy("_PowerOff", power_on_time);
+    _writeCommandTo(_powered_masters, 0x02); // power off
+    _waitWhileAnyBusy("_PowerOff", power_on_time, _powered_masters);
   }
+  _powered_masters = 0;
   _power_is_on = false;
   _using_partial_mode = false;
 }
@@ -341,64 +327,45 @@ void GxEPD2_1248::_InitDisplay()
 {
   if (_hibernating) _reset();
   //panel setting
-  M1.writeCommand(0x00);
-  M1.writeData(0x1f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
-  S1.writeCommand(0x00);
-  S1.writeData(0x1f);
-  M2.writeCommand(0x00);
-  M2.writeData(0x13); // reverse scan
-  S2.writeCommand(0x00);
-  S2.writeData(0x13); // reverse scan
+  _writeCommandTo(M1_TARGET | S1_TARGET, 0x00);
+  _writeDataTo(M1_TARGET | S1_TARGET, 0x1f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
+  _writeCommandTo(M2_TARGET | S2_TARGET, 0x00);
+  _writeDataTo(M2_TARGET | S2_TARGET, 0x13); // reverse scan
   // booster soft start
-  M1.writeCommand(0x06);
-  M1.writeData(0x17);  //A
-  M1.writeData(0x17);  //B
-  M1.writeData(0x39);  //C
-  M1.writeData(0x17);
-  M2.writeCommand(0x06);
-  M2.writeData(0x17);
-  M2.writeData(0x17);
-  M2.writeData(0x39);
-  M2.writeData(0x17);
+  _writeCommandTo(MASTER_TARGETS, 0x06);
+  _writeDataTo(MASTER_TARGETS, 0x17);  //A
+  _writeDataTo(MASTER_TARGETS, 0x17);  //B
+  _writeDataTo(MASTER_TARGETS, 0x39);  //C
+  _writeDataTo(MASTER_TARGETS, 0x17);
   //resolution setting
-  M1.writeCommand(0x61);
-  M1.writeData(0x02);
-  M1.writeData(0x88);  //source 648
-  M1.writeData(0x01);  //gate 492
-  M1.writeData(0xEC);
-  S1.writeCommand(0x61);
-  S1.writeData(0x02);
-  S1.writeData(0x90);  //source 656
-  S1.writeData(0x01);  //gate 492
-  S1.writeData(0xEC);
-  M2.writeCommand(0x61);
-  M2.writeData(0x02);
-  M2.writeData(0x90);  //source 656
-  M2.writeData(0x01);  //gate 492
-  M2.writeData(0xEC);
-  S2.writeCommand(0x61);
-  S2.writeData(0x02);
-  S2.writeData(0x88);  //source 648
-  S2.writeData(0x01);  //gate 492
-  S2.writeData(0xEC);
-  _writeCommandAll(0x15); //DUSPI
-  _writeDataAll(0x20); // normal (single DIN) SPI
-  _writeCommandAll(0x50); //Vcom and data interval setting
-  _writeDataAll(0x21);  //Border KW
-  //_writeDataAll(0x29); // LUTKW, N2OCP: copy new to old DOES NOT WORK
-  _writeDataAll(0x07);
-
-  _writeCommandAll(0x60); //TCON
-  _writeDataAll(0x22);
-
-  _writeCommandAll(0xE3);
-  _writeDataAll(0x00);
-
-  _writeCommandAll(0xe0); //Cascade setting
-  _writeDataAll(0x03);
-
-  _writeCommandAll(0xe5); //Force temperature
-  _writeDataAll(_temperature);
+  _writeCommandTo(M1_TARGET | S2_TARGET, 0x61);
+  _writeDataTo(M1_TARGET | S2_TARGET, 0x02);
+  _writeDataTo(M1_TARGET | S2_TARGET, 0x88);  //source 648
+  _writeDataTo(M1_TARGET | S2_TARGET, 0x01);  //gate 492
+  _writeDataTo(M1_TARGET | S2_TARGET, 0xEC);
+  _writeCommandTo(S1_TARGET | M2_TARGET, 0x61);
+  _writeDataTo(S1_TARGET | M2_TARGET, 0x02);
+  _writeDataTo(S1_TARGET | M2_TARGET, 0x90);  //source 656
+  _writeDataTo(S1_TARGET | M2_TARGET, 0x01);  //gate 492
+  _writeDataTo(S1_TARGET | M2_TARGET, 0xEC);
+  _writeCommandTo(ALL_TARGETS, 0x15); //DUSPI
+  _writeDataTo(ALL_TARGETS, 0x20); // normal (single DIN) SPI
+  _writeCommandTo(ALL_TARGETS, 0x50); //Vcom and data interval setting
+  _writeDataTo(ALL_TARGETS, 0x21);  //Border KW
+  //_writeDataTo(ALL_TARGETS, 0x29); // LUTKW, N2OCP: copy new to old DOES NOT WORK
+  _writeDataTo(ALL_TARGETS, 0x07);
+
+  _writeCommandTo(ALL_TARGETS, 0x60); //TCON
+  _writeDataTo(ALL_TARGETS, 0x22);
+
+  _writeCommandTo(ALL_TARGETS, 0xE3);
+  _writeDataTo(ALL_TARGETS, 0x00);
+
+  _writeCommandTo(ALL_TARGETS, 0xe0); //Cascade setting
+  _writeDataTo(ALL_TARGETS, 0x03);
+
+  _writeCommandTo(ALL_TARGETS, 0xe5); //Force temperature
+  _writeDataTo(ALL_TARGETS, _temperature);
 }
 
 // experimental partial screen update LUTs with balanced charge
@@ -455,14 +422,10 @@ void GxEPD2_1248::_Init_Full()
 {
   _InitDisplay();
   // LUT from OTP
-  M1.writeCommand(0x00);
-  M1.writeData(0x1f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
-  S1.writeCommand(0x00);
-  S1.writeData(0x1f);
-  M2.writeCommand(0x00);
-  M2.writeData(0x13); // reverse scan
-  S2.writeCommand(0x00);
-  S2.writeData(0x13); // reverse scan
+  _writeCommandTo(M1_TARGET | S1_TARGET, 0x00);
+  _writeDataTo(M1_TARGET | S1_TARGET, 0x1f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
+  _writeCommandTo(M2_TARGET | S2_TARGET, 0x00);
+  _writeDataTo(M2_TARGET | S2_TARGET, 0x13); // reverse scan
   _PowerOn();
   _using_partial_mode = false;
 }
@@ -471,144 +434,153 @@ void GxEPD2_1248::_Init_Part()
 {
   _InitDisplay();
   // LUT from registers
-  M1.writeCommand(0x00);
-  M1.writeData(0x3f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
-  S1.writeCommand(0x00);
-  S1.writeData(0x3f);
-  M2.writeCommand(0x00);
-  M2.writeData(0x33);
-  S2.writeCommand(0x00);
-  S2.writeData(0x33);
-  _writeCommandAll(0x82); // vcom_DC setting
-  _writeDataAll (0x1C);
-  _writeCommandAll(0x50); // VCOM AND DATA INTERVAL SETTING
-  _writeDataAll(0x31);  //Border KW
-  _writeDataAll(0x07);
-  _writeCommandAll(0x20);
-  _writeDataPGM_All(lut_20_LUTC_partial, sizeof(lut_20_LUTC_partial), 60 - sizeof(lut_20_LUTC_partial));
-  _writeCommandAll(0x21);
-  _writeDataPGM_All(lut_21_LUTWW_partial, sizeof(lut_21_LUTWW_partial), 60 - sizeof(lut_21_LUTWW_partial));
-  _writeCommandAll(0x22);
-  _writeDataPGM_All(lut_22_LUTKW_partial, sizeof(lut_22_LUTKW_partial), 60 - sizeof(lut_22_LUTKW_partial));
-  _writeCommandAll(0x23);
-  _writeDataPGM_All(lut_23_LUTWK_partial, sizeof(lut_23_LUTWK_partial), 60 - sizeof(lut_23_LUTWK_partial));
-  _writeCommandAll(0x24);
-  _writeDataPGM_All(lut_24_LUTKK_partial, sizeof(lut_24_LUTKK_partial), 60 - sizeof(lut_24_LUTKK_partial));
-  _writeCommandAll(0x25);
-  _writeDataPGM_All(lut_25_LUTBD_partial, sizeof(lut_25_LUTBD_partial), 60 - sizeof(lut_25_LUTBD_partial));
-  _PowerOn();
+  _writeCommandTo(M1_TARGET | S1_TARGET, 0x00);
+  _writeDataTo(M1_TARGET | S1_TARGET, 0x3f);  //KW-3f   KWR-2F  BWROTP 0f BWOTP 1f
+  _writeCommandTo(M2_TARGET | S2_TARGET, 0x00);
+  _writeDataTo(M2_TARGET | S2_TARGET, 0x33);
+  _writeCommandTo(ALL_TARGETS, 0x82); // vcom_DC setting
+  _writeDataTo(ALL_TARGETS, 0x1C);
+  _writeCommandTo(ALL_TARGETS, 0x50); // VCOM AND DATA INTERVAL SETTING
+  _writeDataTo(ALL_TARGETS, 0x31);  //Border KW
+  _writeDataTo(ALL_TARGETS, 0x07);
+  _writeCommandTo(ALL_TARGETS, 0x20);
+  _writeDataPGM_To(ALL_TARGETS, lut_20_LUTC_partial, sizeof(lut_20_LUTC_partial), 60 - sizeof(lut_20_LUTC_partial));
+  _writeCommandTo(ALL_TARGETS, 0x21);
+  _writeDataPGM_To(ALL_TARGETS, lut_21_LUTWW_partial, sizeof(lut_21_LUTWW_partial), 60 - sizeof(lut_21_LUTWW_partial));
+  _writeCommandTo(ALL_TARGETS, 0x22);
+  _writeDataPGM_To(ALL_TARGETS, lut_22_LUTKW_partial, sizeof(lut_22_LUTKW_partial), 60 - sizeof(lut_22_LUTKW_partial));
+  _writeCommandTo(ALL_TARGETS, 0x23);
+  _writeDataPGM_To(ALL_TARGETS, lut_23_LUTWK_partial, sizeof(lut_23_LUTWK_partial), 60 - sizeof(lut_23_LUTWK_partial));
+  _writeCommandTo(ALL_TARGETS, 0x24);
+  _writeDataPGM_To(ALL_TARGETS, lut_24_LUTKK_partial, sizeof(lut_24_LUTKK_partial), 60 - sizeof(lut_24_LUTKK_partial));
+  _writeCommandTo(ALL_TARGETS, 0x25);
+  _writeDataPGM_To(ALL_TARGETS, lut_25_LUTBD_partial, sizeof(lut_25_LUTBD_partial), 60 - sizeof(lut_25_LUTBD_partial));
+  // powered on refresh, only the masters of the refreshed parts
   _using_partial_mode = true;
 }
 
 void GxEPD2_1248::_Update_Full()
 {
-  _writeCommandAll(0x12); //display refresh
+  _writeCommandTo(ALL_TARGETS, 0x12); //display refresh
   _waitWhileAnyBusy("_Update_Full", full_refresh_time);
 }
 
-void GxEPD2_1248::_Update_Part()
+void GxEPD2_1248::_Update_Part(uint8_t targets)
 {
-  _writeCommandAll(0x12); //display refresh
-  _waitWhileAnyBusy("_Update_Part", partial_refresh_time);
+  _writeCommandTo(targets, 0x12); //display refresh
+  _waitWhileAnyBusy("_Update_Part", partial_refresh_time, targets);
 }
 
-void GxEPD2_1248::_writeCommandMaster(uint8_t c)
+uint8_t GxEPD2_1248::_targets(int16_t x, int16_t y, int16_t w, int16_t h)
 {
-  SPI.beginTransaction(_spi_settings);
-  digitalWrite(_dc1, LOW);
-  digitalWrite(_dc2, LOW);
-  digitalWrite(_cs_m1, LOW);
-  digitalWrite(_cs_m2, LOW);
-  SPI.transfer(c);
-  digitalWrite(_cs_m1, HIGH);
-  digitalWrite(_cs_m2, HIGH);
-  digitalWrite(_dc1, HIGH);
-  digitalWrite(_dc2, HIGH);
-  SPI.endTransaction();
+  if ((w <= 0) || (h <= 0) || (x + w <= 0) || (y + h <= 0) || (x >= int16_t(WIDTH)) || (y >= int16_t(HEIGHT))) return 0;
+  bool left = x < int16_t(S2.WIDTH);
+  bool right = x + w > int16_t(S2.WIDTH);
+  bool top = y < int16_t(S2.HEIGHT);
+  bool bottom = y + h > int16_t(S2.HEIGHT);
+  return (top && left ? S2_TARGET : 0) | (top && right ? M2_TARGET : 0) | (bottom && left ? M1_TARGET : 0) | (bottom && right ? S1_TARGET : 0);
 }
 
-void GxEPD2_1248::_writeDataMaster(uint8_t d)
+void GxEPD2_1248::_writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                  int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
-  SPI.beginTransaction(_spi_settings);
-  digitalWrite(_cs_m1, LOW);
-  digitalWrite(_cs_m2, LOW);
-  SPI.transfer(d);
-  digitalWrite(_cs_m1, HIGH);
-  digitalWrite(_cs_m2, HIGH);
-  SPI.endTransaction();
+  uint8_t targets = _targets(x, y, w, h);
+  if (targets & S2_TARGET) S2.writeImagePart(command, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
+  if (targets & M2_TARGET) M2.writeImagePart(command, bitmap, x_part, y_part, w_bitmap, h_bitmap, x - S2.WIDTH, y, w, h, invert, mirror_y, pgm);
+  if (targets & M1_TARGET) M1.writeImagePart(command, bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y - S2.HEIGHT, w, h, invert, mirror_y, pgm);
+  if (targets & S1_TARGET) S1.writeImagePart(command, bitmap, x_part, y_part, w_bitmap, h_bitmap, x - M1.WIDTH, y - M2.HEIGHT, w, h, invert, mirror_y, pgm);
 }
 
-void GxEPD2_1248::_writeCommandAll(uint8_t c)
+void GxEPD2_1248::_select(uint8_t targets, uint8_t level)
 {
-  SPI.beginTransaction(_spi_settings);
+  if (targets & M1_TARGET) digitalWrite(_cs_m1, level);
+  if (targets & S1_TARGET) digitalWrite(_cs_s1, level);
+  if (targets & M2_TARGET) digitalWrite(_cs_m2, level);
+  if (targets & S2_TARGET) digitalWrite(_cs_s2, level);
+}
+
+void GxEPD2_1248::_writeCommandTo(uint8_t targets, uint8_t c)
+{
+  _spi.beginTransaction(_spi_settings);
   digitalWrite(_dc1, LOW);
   digitalWrite(_dc2, LOW);
-  digitalWrite(_cs_m1, LOW);
-  digitalWrite(_cs_s1, LOW);
-  digitalWrite(_cs_m2, LOW);
-  digitalWrite(_cs_s2, LOW);
-  SPI.transfer(c);
-  digitalWrite(_cs_m1, HIGH);
-  digitalWrite(_cs_s1, HIGH);
-  digitalWrite(_cs_m2, HIGH);
-  digitalWrite(_cs_s2, HIGH);
+  _select(targets, LOW);
+  _spi.transfer(c);
+  _select(targets, HIGH);
   digitalWrite(_dc1, HIGH);
   digitalWrite(_dc2, HIGH);
-  SPI.endTransaction();
+  _spi.endTransaction();
 }
 
-void GxEPD2_1248::_writeDataAll(uint8_t d)
+void GxEPD2_1248::_writeDataTo(uint8_t targets, uint8_t d)
 {
-  SPI.beginTransaction(_spi_settings);
-  digitalWrite(_cs_m1, LOW);
-  digitalWrite(_cs_s1, LOW);
-  digitalWrite(_cs_m2, LOW);
-  digitalWrite(_cs_s2, LOW);
-  SPI.transfer(d);
-  digitalWrite(_cs_m1, HIGH);
-  digitalWrite(_cs_s1, HIGH);
-  digitalWrite(_cs_m2, HIGH);
-  digitalWrite(_cs_s2, HIGH);
-  SPI.endTransaction();
+  _spi.beginTransaction(_spi_settings);
+  _select(targets, LOW);
+  _spi.transfer(d);
+  _select(targets, HIGH);
+  _spi.endTransaction();
 }
 
-void GxEPD2_1248::_writeDataPGM_All(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
+void GxEPD2_1248::_writeDataPGM_To(uint8_t targets, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes)
 {
-  SPI.beginTransaction(_spi_settings);
-  digitalWrite(_cs_m1, LOW);
-  digitalWrite(_cs_s1, LOW);
-  digitalWrite(_cs_m2, LOW);
-  digitalWrite(_cs_s2, LOW);
+  _spi.beginTransaction(_spi_settings);
+  _select(targets, LOW);
   for (uint16_t i = 0; i < n; i++)
   {
-    SPI.transfer(pgm_read_byte(&*data++));
+    _spi.transfer(pgm_read_byte(&*data++));
   }
   while (fill_with_zeroes > 0)
   {
-    SPI.transfer(0x00);
+    _spi.transfer(0x00);
     fill_with_zeroes--;
   }
-  digitalWrite(_cs_m1, HIGH);
-  digitalWrite(_cs_s1, HIGH);
-  digitalWrite(_cs_m2, HIGH);
-  digitalWrite(_cs_s2, HIGH);
-  SPI.endTransaction();
+  _select(targets, HIGH);
+  _spi.endTransaction();
+}
+
+// one transaction of the size of the larger parts; the excess bytes for the smaller parts have the same value
+void GxEPD2_1248::_writeScreenBufferTo(uint8_t targets, uint8_t command, uint8_t value)
+{
+  uint32_t n = uint32_t(gx_uint16_max(M1.WIDTH, S1.WIDTH)) * uint32_t(M1.HEIGHT) / 8;
+  _writeCommandTo(targets, command); // set current or previous
+  _spi.beginTransaction(_spi_settings);
+  _select(targets, LOW);
+  for (uint32_t i = 0; i < n; i++)
+  {
+    _spi.transfer(value);
+#if defined(ESP8266) || defined(ESP32)
+    if (0 == i % 10000) yield();
+#endif
+  }
+  _select(targets, HIGH);
+  _spi.endTransaction();
 }
 
-void GxEPD2_1248::_waitWhileAnyBusy(const char* comment, uint16_t busy_time)
+void GxEPD2_1248::_waitWhileAnyBusy(const char* comment, uint16_t busy_time, uint8_t targets)
 {
-  if (_busy_m1 >= 0)
+  // poll the busy pins of the targets that have one, wait busy_time only if none has
+  bool poll_m1 = (targets & M1_TARGET) && (_busy_m1 >= 0);
+  bool poll_s1 = (targets & S1_TARGET) && (_busy_s1 >= 0);
+  bool poll_m2 = (targets & M2_TARGET) && (_busy_m2 >= 0);
+  bool poll_s2 = (targets & S2_TARGET) && (_busy_s2 >= 0);
+  if (poll_m1 || poll_s1 || poll_m2 || poll_s2)
   {
     delay(1); // add some margin to become active
     unsigned long start = micros();
     while (1)
     {
       delay(1); // add some margin to become active
-      bool nb_m1 = _busy_m1 >= 0 ? _busy_level != digitalRead(_busy_m1) : true;
-      bool nb_s1 = _busy_m1 >= 0 ? _busy_level != digitalRead(_busy_s1) : true;
-      bool nb_m2 = _busy_m1 >= 0 ? _busy_level != digitalRead(_busy_m2) : true;
-      bool nb_s2 = _busy_m1 >= 0 ? _busy_level != digitalRead(_busy_s2) : true;
-      if (nb_m1 && nb_s1 && nb_m2 && nb_s2) break;
+      bool nb_m1 = poll_m1 ? _busy_level != digitalRead(_busy_m1) : true;
+      bool nb_s1 = poll_s1 ? _busy_level != digitalRead(_busy_s1) : true;
+      bool nb_m2 = poll_m2 ? _busy_level != digitalRead(_busy_m2) : true;
+      bool nb_s2 = poll_s2 ? _busy_level != digitalRead(_busy_s2) : true;
+      if (nb_m1 && nb_s1 && nb_m2 && nb_s2)
+      {
+#if ENABLE_GxEPD2_TIMING_PROFILE
+        _timing_profile.record(GxEPD2_TimingProfile::operation(comment), micros() - start);
+#endif
+        break;
+      }
       delay(1);
       if (micros() - start > _busy_timeout)
       {
@@ -626,7 +598,6 @@ void GxEPD2_1248::_waitWhileAnyBusy(const char* comment, uint16_t busy_time)
         Serial.println(elapsed);
       }
     }
-    (void) start;
   }
   else delay(busy_time);
 }
@@ -636,7 +607,7 @@ void GxEPD2_1248::_getMasterTemperature()
   uint8_t value = 0;
   M1.writeCommand(0x40);
   _waitWhileAnyBusy("getMasterTemperature", 300);
-  SPI.end();
+  _spi.end();
   pinMode(_mosi, INPUT);
   delay(100);
   digitalWrite(_sck, HIGH);
@@ -667,15 +638,15 @@ void GxEPD2_1248::_readController(uint8_t cmd, uint8_t* data, uint16_t n, int8_t
 {
   if (cs < 0) cs = _cs_m1;
   if (dc < 0) dc = _dc1;
-  SPI.beginTransaction(_spi_settings);
+  _spi.beginTransaction(_spi_settings);
   digitalWrite(cs, LOW);
   digitalWrite(dc, LOW);
-  SPI.transfer(cmd);
+  _spi.transfer(cmd);
   digitalWrite(dc, HIGH);
   digitalWrite(cs, HIGH);
-  SPI.endTransaction();
+  _spi.endTransaction();
   _waitWhileAnyBusy("_readController", 300);
-  SPI.end();
+  _spi.end();
   pinMode(_mosi, INPUT);
   delay(100);
   digitalWrite(_sck, HIGH);
@@ -702,21 +673,12 @@ void GxEPD2_1248::_readController(uint8_t cmd, uint8_t* data, uint16_t n, int8_t
   _initSPI();
 }
 
-GxEPD2_1248::ScreenPart::ScreenPart(uint16_t width, uint16_t height, bool rev_scan, int8_t cs, int8_t dc) :
+GxEPD2_1248::ScreenPart::ScreenPart(uint16_t width, uint16_t height, bool rev_scan, int8_t cs, int8_t dc, SPIClass& spi) :
   WIDTH(width), HEIGHT(height), _rev_scan(rev_scan),
-  _cs(cs), _dc(dc), _spi_settings(4000000, MSBFIRST, SPI_MODE0)
+  _cs(cs), _dc(dc), _spi_settings(4000000, MSBFIRST, SPI_MODE0), _spi(spi)
 {
 }
 
-void GxEPD2_1248::ScreenPart::writeScreenBuffer(uint8_t command, uint8_t value)
-{
-  writeCommand(command); // set current or previous
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    writeData(value);
-  }
-}
-
 void GxEPD2_1248::ScreenPart::writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
     int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
@@ -776,22 +738,22 @@ void GxEPD2_1248::ScreenPart::writeImagePart(uint8_t command, const uint8_t bitm
 
 void GxEPD2_1248::ScreenPart::writeCommand(uint8_t c)
 {
-  SPI.beginTransaction(_spi_settings);
+  _spi.beginTransaction(_spi_settings);
   if (_dc >= 0) digitalWrite(_dc, LOW);
   if (_cs >= 0) digitalWrite(_cs, LOW);
-  SPI.transfer(c);
+  _spi.transfer(c);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
   if (_dc >= 0) digitalWrite(_dc, HIGH);
-  SPI.endTransaction();
+  _spi.endTransaction();
 }
 
 void GxEPD2_1248::ScreenPart::writeData(uint8_t d)
 {
-  SPI.beginTransaction(_spi_settings);
+  _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
-  SPI.transfer(d);
+  _spi.transfer(d);
   if (_cs >= 0) digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
+  _spi.endTransaction();
 }
 
 void GxEPD2_1248::ScreenPart::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
@@ -814,17 +776,17 @@ void GxEPD2_1248::ScreenPart::_setPartialRamArea(uint16_t x, uint16_t y, uint16_
 
 void GxEPD2_1248::ScreenPart::_startTransfer()
 {
-  SPI.beginTransaction(_spi_settings);
+  _spi.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
 }
 
 void GxEPD2_1248::ScreenPart::_transfer(uint8_t value)
 {
-  SPI.transfer(value);
+  _spi.transfer(value);
 }
 
 void GxEPD2_1248::ScreenPart::_endTransfer()
 {
   if (_cs >= 0) digitalWrite(_cs, HIGH);
-  SPI.endTransaction();
+  _spi.endTransaction();
 }
@@ -33,17 +33,18 @@ class GxEPD2_1248 : public GxEPD2_EPD
     // constructors
 #ifndef SCK
     // general constructor for use with all parameters on ESP32, e.g. for Waveshare ESP32 driver board mounted on connection board
+    // spi: SPI host for sck, miso and mosi, e.g. an SPIClass instance for HSPI, to keep SPI free for other devices
     GxEPD2_1248(int8_t sck, int8_t miso, int8_t mosi,
                 int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2,
                 int8_t dc1, int8_t dc2, int8_t rst1, int8_t rst2,
-                int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2);
+                int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2, SPIClass& spi = SPI);
 #else
     // general constructor for use with standard SPI pins, default SCK, MISO and MOSI
     GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2,
                 int8_t dc1, int8_t dc2, int8_t rst1, int8_t rst2,
-                int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2);
+                int8_t busy_m1, int8_t busy_s1, int8_t busy_m2, int8_t busy_s2, SPIClass& spi = SPI);
     // constructor with minimal parameter set, standard SPI, dc1 and dc2, rst1 and rst2 to one pin, one busy used (can be -1)
-    GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2, int8_t dc, int8_t rst, int8_t busy);
+    GxEPD2_1248(int8_t cs_m1, int8_t cs_s1, int8_t cs_m2, int8_t cs_s2, int8_t dc, int8_t rst, int8_t busy, SPIClass& spi = SPI);
 #endif
     // methods (virtual)
     void init(uint32_t serial_diag_bitrate = 0); // serial_diag_bitrate = 0 : disabled
@@ -79,22 +80,28 @@ class GxEPD2_1248 : public GxEPD2_EPD
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
   private:
+    // parts: S2 top left, M2 top right, M1 bottom left, S1 bottom right; masters M1 and M2 generate the driving voltages
+    enum {M1_TARGET = 0x01, S1_TARGET = 0x02, M2_TARGET = 0x04, S2_TARGET = 0x08, MASTER_TARGETS = 0x05, ALL_TARGETS = 0x0F};
     void _reset();
     void _initSPI();
     void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
-    void _PowerOn();
+    void _PowerOn(uint8_t targets = ALL_TARGETS);
     void _PowerOff();
     void _InitDisplay();
     void _Init_Full();
     void _Init_Part();
     void _Update_Full();
-    void _Update_Part();
-    void _writeCommandMaster(uint8_t c);
-    void _writeDataMaster(uint8_t d);
-    void _writeCommandAll(uint8_t c);
-    void _writeDataAll(uint8_t d);
-    void _writeDataPGM_All(const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
-    void _waitWhileAnyBusy(const char* comment = 0, uint16_t busy_time = 5000);
+    void _Update_Part(uint8_t targets = ALL_TARGETS);
+    // broadcast to the controllers selected by targets, all CS lines asserted together
+    void _select(uint8_t targets, uint8_t level);
+    void _writeCommandTo(uint8_t targets, uint8_t c);
+    void _writeDataTo(uint8_t targets, uint8_t d);
+    void _writeDataPGM_To(uint8_t targets, const uint8_t* data, uint16_t n, int16_t fill_with_zeroes = 0);
+    void _writeScreenBufferTo(uint8_t targets, uint8_t command, uint8_t value);
+    void _waitWhileAnyBusy(const char* comment = 0, uint16_t busy_time = 5000, uint8_t targets = ALL_TARGETS);
+    uint8_t _targets(int16_t x, int16_t y, int16_t w, int16_t h); // controllers of the parts that intersect the window
+    void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                         int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm);
     void _getMasterTemperature();
   private:
     friend class GDEW1248T3_OTP;
@@ -104,6 +111,7 @@ class GxEPD2_1248 : public GxEPD2_EPD
     int8_t _cs_m1, _cs_s1, _cs_m2, _cs_s2;
     int8_t _busy_m1, _busy_s1, _busy_m2, _busy_s2;
     int8_t _temperature;
+    uint8_t _powered_masters;
     static const unsigned char lut_20_LUTC_partial[];
     static const unsigned char lut_21_LUTWW_partial[];
     static const unsigned char lut_22_LUTKW_partial[];
@@ -114,8 +122,7 @@ class GxEPD2_1248 : public GxEPD2_EPD
     class ScreenPart
     {
       public:
-        ScreenPart(uint16_t width, uint16_t height, bool rev_scan, int8_t cs, int8_t dc);
-        void writeScreenBuffer(uint8_t command, uint8_t value = 0xFF); // init controller memory current (default white)
+        ScreenPart(uint16_t width, uint16_t height, bool rev_scan, int8_t cs, int8_t dc, SPIClass& spi);
         void writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                             int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
         void writeCommand(uint8_t c);
@@ -131,6 +138,7 @@ class GxEPD2_1248 : public GxEPD2_EPD
         bool _rev_scan;
         int8_t _cs, _dc;
         const SPISettings _spi_settings;
+        SPIClass& _spi;
     };
     ScreenPart M1, S1, M2, S2;
 };
@@ -16,6 +16,7 @@
 GxEPD2_213_B74::GxEPD2_213_B74(int16_t cs, int16_t dc, int16_t rst, int16_t busy, SPIClass &spi) :
   GxEPD2_EPD(cs, dc, rst, busy, HIGH, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate, spi)
 {
+  _grey_mode = false;
 }
 
 void GxEPD2_213_B74::clearScreen(uint8_t value)
@@ -42,10 +43,7 @@ void GxEPD2_213_B74::writeScreenBufferAgain(uint8_t value)
 void GxEPD2_213_B74::_writeScreenBuffer(uint8_t command, uint8_t value)
 {
   _writeCommand(command);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(value);
-  }
+  _writeDataFill(value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
 }
 
 void GxEPD2_213_B74::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -84,29 +82,7 @@ void GxEPD2_213_B74::_writeImage(uint8_t command, const uint8_t bitmap[], int16_
   if (!_using_partial_mode) _Init_Part();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data;
-      // use wb, h of bitmap for index!
-      int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _writeData(data);
-    }
-  }
+  _writeImageData(bitmap, w1 / 8, h1, wb, h, dx / 8, dy, invert, mirror_y, pgm);
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
@@ -148,29 +124,7 @@ void GxEPD2_213_B74::_writeImagePart(uint8_t command, const uint8_t bitmap[], in
   if (!_using_partial_mode) _Init_Part();
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data;
-      // use wb_bitmap, h_bitmap of bitmap for index!
-      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _writeData(data);
-    }
-  }
+  _writeImageData(bitmap, w1 / 8, h1, wb_bitmap, h_bitmap, x_part / 8 + dx / 8, y_part + dy, invert, mirror_y, pgm);
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
@@ -270,6 +224,48 @@ void GxEPD2_213_B74::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
   _Update_Part();
 }
 
+void GxEPD2_213_B74::writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  // the grey waveform selects by the bit pairs of both RAM planes, 1 is dark
+  _writeImage4G(0x24, true, bitmap, x, y, w, h, invert, mirror_y, pgm); // least significant bits
+  _writeImage4G(0x26, false, bitmap, x, y, w, h, invert, mirror_y, pgm); // most significant bits
+}
+
+void GxEPD2_213_B74::_writeImage4G(uint8_t command, bool lsb, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  int16_t wb = (w + 3) / 4; // width bytes, 2 bits per pixel, bitmaps are padded
+  x -= x % 8; // byte boundary
+  w = ((w + 7) / 8) * 8; // byte boundary
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  int16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  int16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_grey_mode) _Init_4G();
+  _setPartialRamArea(x1, y1, w1, h1);
+  _writeCommand(command);
+  _writeGreyPlaneData(bitmap, w1 / 8, h1, wb, h, dx / 8, dy, lsb, invert, mirror_y, pgm);
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
+void GxEPD2_213_B74::refresh4G()
+{
+  if (!_grey_mode) _Init_4G();
+  _writeCommand(0x22);
+  _writeData(0xc7); // no LUT load from OTP, power on and off included
+  _writeCommand(0x20);
+  _waitWhileBusy("_Update_Full", full_refresh_time);
+  _power_is_on = false;
+  // the previous buffer holds a grey plane, next black and white refresh needs be full
+  _initial_write = true;
+  _initial_refresh = true;
+}
+
 void GxEPD2_213_B74::powerOff()
 {
   _PowerOff();
@@ -283,6 +279,7 @@ void GxEPD2_213_B74::hibernate()
     _writeCommand(0x10); // deep sleep mode
     _writeData(0x1);     // enter deep sleep
     _hibernating = true;
+    _grey_mode = false;
   }
 }
 
@@ -335,6 +332,7 @@ void GxEPD2_213_B74::_InitDisplay()
   if (_hibernating) _reset();
   delay(10); // 10ms according to specs
   _writeCommand(0x12);  //SWRESET
+  _grey_mode = false;
   delay(10); // 10ms according to specs
   _writeCommand(0x01); //Driver output control
   _writeData(0xF9);
@@ -364,6 +362,24 @@ void GxEPD2_213_B74::_Init_Part()
   _using_partial_mode = true;
 }
 
+void GxEPD2_213_B74::_Init_4G()
+{
+  _InitDisplay();
+  _writeCommand(0x32);
+  _writeDataPGM(lut_4G, 153);
+  _writeCommand(0x3f);
+  _writeDataPGM(lut_4G + 153, 1);
+  _writeCommand(0x03); // gate voltage
+  _writeDataPGM(lut_4G + 154, 1);
+  _writeCommand(0x04); // source voltages
+  _writeDataPGM(lut_4G + 155, 3);
+  _writeCommand(0x2c); // VCOM
+  _writeDataPGM(lut_4G + 158, 1);
+  _power_is_on = false;
+  _using_partial_mode = false;
+  _grey_mode = true;
+}
+
 void GxEPD2_213_B74::_Update_Full()
 {
   _writeCommand(0x22);
@@ -379,3 +395,30 @@ void GxEPD2_213_B74::_Update_Part()
   _writeCommand(0x20);
   _waitWhileBusy("_Update_Part", partial_refresh_time);
 }
+
+// four grey levels waveform, from the Good Display / Waveshare SSD1680 2.9" 4 grey demo
+const unsigned char GxEPD2_213_B74::lut_4G[] PROGMEM =
+{
+  0x00, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L0
+  0x20, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L1
+  0x28, 0x60, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L2
+  0x2A, 0x60, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L3
+  0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L4
+  0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00, // TP, SR, RP of Group0
+  0x1E, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x01, // TP, SR, RP of Group1
+  0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00, // TP, SR, RP of Group2
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group3
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group4
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group5
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group6
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group7
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group8
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group9
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group10
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // TP, SR, RP of Group11
+  0x24, 0x22, 0x22, 0x22, 0x23, 0x32, 0x00, 0x00, 0x00, // FR, XON
+  0x22, // EOPT
+  0x17, // VGH
+  0x41, 0xAE, 0x32, // VSH1, VSH2, VSL
+  0x28 // VCOM
+};
@@ -26,6 +26,7 @@ class GxEPD2_213_B74 : public GxEPD2_EPD
     static const bool hasColor = false;
     static const bool hasPartialUpdate = true;
     static const bool hasFastPartialUpdate = true;
+    static const bool hasGreyLevels = true; // custom waveform, see writeImage4G()
     static const uint16_t power_on_time = 100; // ms, e.g. 95109us
     static const uint16_t power_off_time = 150; // ms, e.g. 140344us
     static const uint16_t full_refresh_time = 3600; // ms, e.g. 3501806us
@@ -62,6 +63,9 @@ class GxEPD2_213_B74 : public GxEPD2_EPD
     void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void refresh(bool partial_update_mode = false); // screen refresh from controller memory to full screen
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
+    // four grey levels: 2 bits per pixel bitmap, see GxEPD2_EPD; x and w should be multiple of 8
+    void writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    void refresh4G(); // screen refresh from controller memory to full screen with the grey waveform; next black and white refresh is full
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
   private:
@@ -69,14 +73,19 @@ class GxEPD2_213_B74 : public GxEPD2_EPD
     void _writeImage(uint8_t command, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                          int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    void _writeImage4G(uint8_t command, bool lsb, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm);
     void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
     void _PowerOn();
     void _PowerOff();
     void _InitDisplay();
     void _Init_Full();
     void _Init_Part();
+    void _Init_4G();
     void _Update_Full();
     void _Update_Part();
+  private:
+    bool _grey_mode; // grey waveform loaded
+    static const unsigned char lut_4G[];
 };
 
 #endif
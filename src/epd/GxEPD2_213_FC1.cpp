@@ -23,10 +23,7 @@ GxEPD2_213_FC1::GxEPD2_213_FC1(int16_t cs, int16_t dc, int16_t rst, int16_t busy
 // Generic: clear display memory (one buffer only), using specified command
 void GxEPD2_213_FC1::_writeScreenBuffer(uint8_t command, uint8_t value) {
   _writeCommand(command); // set current
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(value);
-  }
+  _writeDataFill(value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   yield();  // Allegedly: keeps ESP32 and ESP8266 WDT happy
 }
 
@@ -140,6 +140,88 @@ void GxEPD2_290_BN8::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
     _Update_Part();
 }
 
+// Write a four grey level image (2 bits per pixel) to both memories: the bit planes select the grey waveform
+// Any window may be written, e.g. the pages of a paged GxEPD2_4G, or a partial window
+void GxEPD2_290_BN8::writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y,
+                                  bool pgm)
+{
+    if (!_configured_for_4G) {
+        _Init_Common();
+        _Init_4G();
+    }
+    _writeImage4G(0x24, true, bitmap, x, y, w, h, invert, mirror_y, pgm);  // "NEW": least significant bits
+    _writeImage4G(0x26, false, bitmap, x, y, w, h, invert, mirror_y, pgm); // "OLD": most significant bits
+}
+
+// Generic: write one bit plane of a four grey level image to memory, using specified command
+void GxEPD2_290_BN8::_writeImage4G(uint8_t command, bool lsb, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h,
+                                   bool invert, bool mirror_y, bool pgm)
+{
+    int16_t wb = (w + 3) / 4;                                       // width bytes, 2 bits per pixel, bitmaps are padded
+    x -= x % 8;                                                     // byte boundary
+    w = ((w + 7) / 8) * 8;                                          // byte boundary
+    int16_t x1 = x < 0 ? 0 : x;                                     // limit
+    int16_t y1 = y < 0 ? 0 : y;                                     // limit
+    int16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x;   // limit
+    int16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+    int16_t dx = x1 - x;
+    int16_t dy = y1 - y;
+    w1 -= dx;
+    h1 -= dy;
+    if ((w1 <= 0) || (h1 <= 0))
+        return;
+
+    _setRamArea(x1, y1, w1, h1);
+    _writeCommand(command);
+    _writeGreyPlaneData(bitmap, w1 / 8, h1, wb, h, dx / 8, dy, lsb, invert, mirror_y, pgm); // set bits select the darker waveforms
+    yield(); // Allegedly: keeps ESP32 and ESP8266 WDT happy
+}
+
+// Set the memory window and cursor, with the same x offset as _Init_Common()
+void GxEPD2_290_BN8::_setRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+{
+    constexpr uint8_t xByteOffset = 1;
+
+    _writeCommand(0x44); // Memory X start - end
+    _writeData((x / 8) + xByteOffset);
+    _writeData(((x + w - 1) / 8) + xByteOffset);
+
+    _writeCommand(0x45); // Memory Y start - end
+    _writeData(y & 0xFF);
+    _writeData((y >> 8) & 0xFF);
+    _writeData((y + h - 1) & 0xFF);
+    _writeData(((y + h - 1) >> 8) & 0xFF);
+
+    _writeCommand(0x4E); // Memory cursor X
+    _writeData((x / 8) + xByteOffset);
+    _writeCommand(0x4F); // Memory cursor y
+    _writeData(y & 0xFF);
+    _writeData((y >> 8) & 0xFF);
+}
+
+// Update the display image using the grey waveform
+void GxEPD2_290_BN8::refresh4G()
+{
+    if (!_configured_for_4G) {
+        _Init_Common();
+        _Init_4G();
+    }
+
+    // Specify refresh operation:
+    // * Enable clock signal
+    // * Enable Analog
+    // * DISPLAY with DISPLAY Mode 1, LUT from register (not OTP)
+    // * Disable Analog
+    // * Disable OSC
+    _writeCommand(0x22);
+    _writeData(0xC7);
+    _writeCommand(0x20);
+    _waitWhileBusy("_Update_Full", full_refresh_time);
+
+    // "OLD" memory now holds a grey plane: next update needs to start over with a full refresh
+    _initial_refresh = true;
+}
+
 // Custom reset function - less delay()
 void GxEPD2_290_BN8::_reset()
 {
@@ -158,6 +240,7 @@ void GxEPD2_290_BN8::_reset()
     _hibernating = false;
     _configured_for_full = false;
     _configured_for_fast = false;
+    _configured_for_4G = false;
 }
 
 // Common setup for both full refresh and fast refresh
@@ -238,6 +321,28 @@ void GxEPD2_290_BN8::_Init_Part()
     _configured_for_full = false;
 }
 
+// Load config for four grey levels: waveform LUT and the voltages that go with it
+void GxEPD2_290_BN8::_Init_4G()
+{
+    _writeCommand(0x32);
+    for (uint8_t i = 0; i < 153; i++)
+        _writeData(pgm_read_byte_near(lut_4G + i));
+
+    _writeCommand(0x3F); // End option
+    _writeData(pgm_read_byte_near(lut_4G + 153));
+    _writeCommand(0x03); // Gate voltage
+    _writeData(pgm_read_byte_near(lut_4G + 154));
+    _writeCommand(0x04); // Source voltages
+    for (uint8_t i = 155; i < 158; i++)
+        _writeData(pgm_read_byte_near(lut_4G + i));
+    _writeCommand(0x2C); // VCOM
+    _writeData(pgm_read_byte_near(lut_4G + 158));
+
+    _configured_for_4G = true;
+    _configured_for_full = false;
+    _configured_for_fast = false;
+}
+
 void GxEPD2_290_BN8::_Update_Full()
 {
     _Init_Full();
@@ -307,4 +412,34 @@ const unsigned char GxEPD2_290_BN8::lut_partial[153] PROGMEM = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
     0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x00, 0x00, 0x00 //
 
-};
\ No newline at end of file
+};
+
+// Four grey level waveform, from the Good Display / Waveshare SSD1680 2.9" 4 grey demo (untested with this panel)
+const unsigned char GxEPD2_290_BN8::lut_4G[159] PROGMEM = {
+
+    0x00, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L0
+    0x20, 0x60, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L1
+    0x28, 0x60, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L2
+    0x2A, 0x60, 0x15, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VS L3
+    0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // VCOM
+
+    0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00,            // Group 0
+    0x1E, 0x1E, 0x00, 0x00, 0x00, 0x00, 0x01,            // Group 1
+    0x00, 0x02, 0x00, 0x05, 0x14, 0x00, 0x00,            // Group 2
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,            //
+    0x24, 0x22, 0x22, 0x22, 0x23, 0x32, 0x00, 0x00, 0x00, // Frame rate, XON
+
+    0x22,             // End option
+    0x17,             // Gate voltage
+    0x41, 0xAE, 0x32, // Source voltages
+    0x28              // VCOM
+
+};
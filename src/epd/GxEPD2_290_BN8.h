@@ -27,6 +27,7 @@ class GxEPD2_290_BN8 : public GxEPD2_EPD
     static const bool hasColor = false;
     static const bool hasPartialUpdate = true; // Not implemented by this class though. (Not used by Meshtastic)
     static const bool hasFastPartialUpdate = true;
+    static const bool hasGreyLevels = true; // Custom waveform, see writeImage4G()
     static const uint16_t power_on_time = 0; // Undetermined, unused
     static const uint16_t power_off_time = 0;
     static const uint16_t full_refresh_time = 0;
@@ -43,6 +44,9 @@ class GxEPD2_290_BN8 : public GxEPD2_EPD
                          bool mirror_y = false, bool pgm = false);
     void refresh(bool partial_update_mode = false);           // screen refresh from controller memory to full screen
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, fast-refresh
+    void writeImage4G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false,
+                      bool mirror_y = false, bool pgm = false); // Four grey levels, 2 bits per pixel, any window
+    void refresh4G(); // Screen refresh with the grey waveform. Next refresh is full
     void powerOff() {}                                        // No-op. Panel is powered off as part of one-step update operation
     void hibernate() {}                                       // Not yet implemented with Meshtastic Async refresh
 
@@ -70,17 +74,23 @@ class GxEPD2_290_BN8 : public GxEPD2_EPD
     void _writeImagePart(uint8_t command, const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap,
                          int16_t h_bitmap, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false,
                          bool pgm = false);
+    void _writeImage4G(uint8_t command, bool lsb, const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert,
+                       bool mirror_y, bool pgm);
+    void _setRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h); // Memory window for writeImage4G()
     void _reset();       // Custom, uses _waitWhileBusy() instead of delay()
     void _Init_Common(); // Config used by both full _Init_Full and _Init_Part
     void _Init_Full();   // Prepare for a full refresh
     void _Init_Part();   // Prepare for a partial refresh
     void _Update_Full(); // Begin the full refresh operation
+    void _Init_4G();     // Load config for four grey levels
     void _Update_Part(); // Begin the fast refresh operation
 
   private:
     bool _configured_for_fast = false;
     bool _configured_for_full = false;
+    bool _configured_for_4G = false;
     static const unsigned char lut_partial[153];
+    static const unsigned char lut_4G[159];
 };
 
 #endif
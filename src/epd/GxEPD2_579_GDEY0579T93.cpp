@@ -42,38 +42,13 @@ void GxEPD2_579_GDEY0579T93::writeScreenBufferAgain(uint8_t value)
 void GxEPD2_579_GDEY0579T93::_writeScreenBuffer(uint8_t command, uint8_t value)
 {
   if (!_init_display_done) _InitDisplay();
+  // one pass for each controller, its ram area is its half of the screen, (WIDTH / 2 + 7) / 8 bytes per row
   _setPartialRamAreaMaster(0, 0, WIDTH / 2, HEIGHT);
   _writeCommand(command);
-  _startTransfer();
-  for (uint32_t i = 0; i < uint32_t(WIDTH / 2) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _transfer(value);
-  }
-  _endTransfer();
-  _setPartialRamAreaMaster(0, HEIGHT / 2, WIDTH / 2, HEIGHT);
-  _writeCommand(command);
-  _startTransfer();
-  for (uint32_t i = 0; i < uint32_t(WIDTH / 2) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _transfer(value);
-  }
-  _endTransfer();
-  _setPartialRamAreaSlave(0, 0, WIDTH / 2, HEIGHT / 2);
-  _writeCommand(command | 0x80);
-  _startTransfer();
-  for (uint32_t i = 0; i < uint32_t(WIDTH / 2) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _transfer(value);
-  }
-  _endTransfer();
-  _setPartialRamAreaSlave(0, HEIGHT / 2, WIDTH / 2, HEIGHT);
+  _writeDataFill(value, uint32_t((WIDTH / 2 + 7) / 8) * uint32_t(HEIGHT));
+  _setPartialRamAreaSlave(0, 0, WIDTH / 2, HEIGHT);
   _writeCommand(command | 0x80);
-  _startTransfer();
-  for (uint32_t i = 0; i < uint32_t(WIDTH / 2) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _transfer(value);
-  }
-  _endTransfer();
+  _writeDataFill(value, uint32_t((WIDTH / 2 + 7) / 8) * uint32_t(HEIGHT));
 }
 
 void GxEPD2_579_GDEY0579T93::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -117,83 +92,46 @@ void GxEPD2_579_GDEY0579T93::_writeImage(uint8_t command, const uint8_t bitmap[]
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+// one pass over the bitmap rows, each row is split to the slave (left half, near connector) and the master (right half)
+// the controllers have their own ram address counters, a row continues where the previous row of the same controller ended
 void GxEPD2_579_GDEY0579T93::_writeFromImage(uint8_t command, const uint8_t bitmap[], int16_t x1, int16_t y1, int16_t w1, int16_t h1,
     int16_t wbb, int16_t hb, int16_t dx, int16_t dy, bool invert, bool mirror_y, bool pgm)
 {
-  if ((x1 < WIDTH / 2) && (y1 < HEIGHT / 2) && true) // upper left, near connector
-  { // memory is on slave controller
-    int16_t ws = x1 + w1 <= WIDTH / 2 ? w1 : WIDTH / 2 - x1;
-    int16_t hs = y1 + h1 <= HEIGHT / 2 ? h1 : HEIGHT / 2 - y1;
-    //Serial.print("upper left ws="); Serial.print(ws); Serial.print(" hs="); Serial.print(hs); Serial.print(" dx="); Serial.print(dx); Serial.print(" dy="); Serial.println(dy);
-    _setPartialRamAreaSlave(x1, y1, ws, hs, 0x03);
-    _writeCommand(command | 0x80);
-    _writeDataFromImage(bitmap, ws, hs, wbb, hb, dx, dy, invert, mirror_y, pgm);
-  }
-
-  if (((x1 + w1) > WIDTH / 2) && (y1 < HEIGHT / 2) && true) // upper right, opposite to connector
-  { // memory is on master controller
-    int16_t wm = x1 >= WIDTH / 2 ? w1 : (x1 + w1) - WIDTH / 2;
-    int16_t hm = y1 + h1 <= HEIGHT / 2 ? h1 : HEIGHT / 2 - y1;
+  int16_t ws = x1 >= WIDTH / 2 ? 0 : x1 + w1 <= WIDTH / 2 ? w1 : WIDTH / 2 - x1; // width on slave
+  int16_t wm = w1 - ws; // width on master
+  if (ws > 0) _setPartialRamAreaSlave(x1, y1, ws, h1, 0x03);
+  if (wm > 0)
+  { // master is mirrored in x
     int16_t xm = x1 < WIDTH / 2 ? WIDTH / 2 - wm : WIDTH - x1 - wm;
-    int16_t ym = y1 < HEIGHT / 2 ? HEIGHT / 2 - hm : HEIGHT - y1 - hm;
-    //Serial.print("upper right wm="); Serial.print(wm); Serial.print(" hm="); Serial.print(hm); Serial.print(" dx="); Serial.print(dx); Serial.print(" dy="); Serial.println(dy);
-    _setPartialRamAreaMaster(xm, y1, wm, hm, 0x02);
-    _writeCommand(command);
-    _writeDataFromImage(bitmap, wm, hm, wbb, hb, dx + w1 - wm, dy, invert, mirror_y, pgm);
+    _setPartialRamAreaMaster(xm, y1, wm, h1, 0x02);
   }
-
-  if ((x1 < WIDTH / 2) && ((y1 + h1) > HEIGHT / 2) && true) // lower left, near connector
-  { // memory is on slave controller
-    int16_t ws = x1 + w1 <= WIDTH / 2 ? w1 : WIDTH / 2 - x1;
-    int16_t hs = y1 >= HEIGHT / 2 ? h1 : (y1 + h1) - HEIGHT / 2;
-    int16_t ys = y1 >= HEIGHT / 2 ? y1 : HEIGHT / 2;
-    //Serial.print("lower left ws="); Serial.print(ws); Serial.print(" hs="); Serial.print(hs); Serial.print(" dx="); Serial.print(dx); Serial.print(" dy="); Serial.println(dy);
-    _setPartialRamAreaSlave(x1, ys, ws, hs, 0x03);
+  if ((ws > 0) && (wm > 0))
+  {
+    for (int16_t i = 0; i < h1; i++)
+    {
+      _writeCommand(command | 0x80);
+      _writeDataFromImage(bitmap, ws, 1, wbb, hb, dx, dy + i, invert, mirror_y, pgm);
+      _writeCommand(command);
+      _writeDataFromImage(bitmap, wm, 1, wbb, hb, dx + ws, dy + i, invert, mirror_y, pgm);
+    }
+  }
+  else if (ws > 0)
+  {
     _writeCommand(command | 0x80);
-    _writeDataFromImage(bitmap, ws, hs, wbb, hb, dx, dy + h1 - hs, invert, mirror_y, pgm);
+    _writeDataFromImage(bitmap, ws, h1, wbb, hb, dx, dy, invert, mirror_y, pgm);
   }
-
-  if (((x1 + w1) > WIDTH / 2) && ((y1 + h1) > HEIGHT / 2) && true) // lower right, opposite to connector
-  { // memory is on master controller
-    int16_t wm = x1 >= WIDTH / 2 ? w1 : (x1 + w1) - WIDTH / 2;
-    int16_t hm = y1 >= HEIGHT / 2 ? h1 : (y1 + h1) - HEIGHT / 2;
-    int16_t xm = x1 < WIDTH / 2 ? WIDTH / 2 - wm : WIDTH - x1 - wm;
-    int16_t ym = y1 >= HEIGHT / 2 ? y1 : HEIGHT / 2;
-    //Serial.print("lower right wm="); Serial.print(wm); Serial.print(" hm="); Serial.print(hm); Serial.print(" dx="); Serial.print(dx); Serial.print(" dy="); Serial.println(dy);
-    _setPartialRamAreaMaster(xm, ym, wm, hm, 0x02);
+  else
+  {
     _writeCommand(command);
-    _writeDataFromImage(bitmap, wm, hm, wbb, hb, dx + w1 - wm, dy + h1 - hm, invert, mirror_y, pgm);
+    _writeDataFromImage(bitmap, wm, h1, wbb, hb, dx, dy, invert, mirror_y, pgm);
   }
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
 void GxEPD2_579_GDEY0579T93::_writeDataFromImage(const uint8_t bitmap[], int16_t w, int16_t h, int16_t wbb, int16_t hb, int16_t dx, int16_t dy, bool invert, bool mirror_y, bool pgm)
 {
-  _startTransfer();
-  for (int16_t i = 0; i < h; i++)
-  {
-    for (int16_t j = 0; j < w; j += 8)
-    {
-      uint8_t data;
-      // use wbb, h of bitmap for index!
-      int16_t idx = mirror_y ? ((j + dx) / 8 + ((hb - 1 - (i + dy))) * wbb) : ((j + dx) / 8 + (i + dy) * wbb);
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _transfer(data);
-    }
-  }
-  _endTransfer();
+  // dx may be off byte boundary for the master part, (j + dx) / 8 of the byte loop is dx / 8 + j / 8
+  _writeImageData(bitmap, (w + 7) / 8, h, wbb, hb, dx / 8, dy, invert, mirror_y, pgm);
 }
 
 void GxEPD2_579_GDEY0579T93::writeImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
@@ -27,6 +27,7 @@ class GxEPD2_583_T8 : public GxEPD2_EPD
     static const bool hasPartialUpdate = true;
     static const bool usePartialUpdateWindow = false; // set false for better image
     static const bool hasFastPartialUpdate = true; // set this false to force full refresh always
+    static const bool hasWindowedFullRefresh = true; // OTP full waveform in partial window
     static const uint16_t power_on_time = 140; // ms, e.g. 134460us
     static const uint16_t power_off_time = 42; // ms, e.g. 40033us
     static const uint16_t full_refresh_time = 4200; // ms, e.g. 4108238us
@@ -62,6 +63,7 @@ class GxEPD2_583_T8 : public GxEPD2_EPD
     void drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
     void refresh(bool partial_update_mode = false); // screen refresh from controller memory to full screen
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
+    void refreshFull(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh with full waveform, partial screen
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
   private:
@@ -29,12 +29,7 @@ void GxEPD2_750::writeScreenBuffer(uint8_t value)
   if (!_using_partial_mode) _Init_Part();
   if (value == 0xFF) value = 0x33; // white value for this controller
   _writeCommand(0x10);
-  _startTransfer();
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 2; i++)
-  {
-    _transfer(value);
-  }
-  _endTransfer();
+  _writeDataFill(value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 2);
 }
 
 void GxEPD2_750::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -56,10 +56,7 @@ void GxEPD2_154c::clearScreen(uint8_t black_value, uint8_t color_value)
     _writeData(bw2grey[black_value & 0x0F]);
   }
   _writeCommand(0x13);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(color_value);
-  }
+  _writeDataFill(color_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   _Update_Full();
 }
 
@@ -78,10 +75,7 @@ void GxEPD2_154c::writeScreenBuffer(uint8_t black_value, uint8_t color_value)
     _writeData(bw2grey[black_value & 0x0F]);
   }
   _writeCommand(0x13);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(color_value);
-  }
+  _writeDataFill(color_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
 }
 
 void GxEPD2_154c::writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
@@ -29,15 +29,9 @@ void GxEPD2_213_Z19c::clearScreen(uint8_t black_value, uint8_t color_value)
   _writeCommand(0x91); // partial in
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
   _writeCommand(0x10);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(black_value);
-  }
+  _writeDataFill(black_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   _writeCommand(0x13);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(color_value);
-  }
+  _writeDataFill(color_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   _Update_Part();
   _writeCommand(0x92); // partial out
 }
@@ -54,15 +48,9 @@ void GxEPD2_213_Z19c::writeScreenBuffer(uint8_t black_value, uint8_t color_value
   _writeCommand(0x91); // partial in
   _setPartialRamArea(0, 0, WIDTH, HEIGHT);
   _writeCommand(0x10);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(black_value);
-  }
+  _writeDataFill(black_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   _writeCommand(0x13);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 8; i++)
-  {
-    _writeData(color_value);
-  }
+  _writeDataFill(color_value, uint32_t(WIDTH) * uint32_t(HEIGHT) / 8);
   _writeCommand(0x92); // partial out
 }
 
@@ -97,32 +85,8 @@ void GxEPD2_213_Z19c::_writeImage(uint8_t command, const uint8_t* bitmap, int16_
   _writeCommand(0x91); // partial in
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data = 0xFF;
-      if (bitmap)
-      {
-        // use wb, h of bitmap for index!
-        int16_t idx = mirror_y ? j + dx / 8 + ((h - 1 - (i + dy))) * wb : j + dx / 8 + (i + dy) * wb;
-        if (pgm)
-        {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-          data = pgm_read_byte(&bitmap[idx]);
-#else
-          data = bitmap[idx];
-#endif
-        }
-        else
-        {
-          data = bitmap[idx];
-        }
-        if (invert) data = ~data;
-      }
-      _writeData(data);
-    }
-  }
+  if (bitmap) _writeImageData(bitmap, w1 / 8, h1, wb, h, dx / 8, dy, invert, mirror_y, pgm);
+  else _writeDataFill(0xFF, uint32_t(w1 / 8) * h1);
   _writeCommand(0x92); // partial out
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
@@ -177,29 +141,8 @@ void GxEPD2_213_Z19c::_writeImagePart(uint8_t command, const uint8_t* bitmap, in
   _writeCommand(0x91); // partial in
   _setPartialRamArea(x1, y1, w1, h1);
   _writeCommand(command);
-  for (int16_t i = 0; i < h1; i++)
-  {
-    for (int16_t j = 0; j < w1 / 8; j++)
-    {
-      uint8_t data;
-      // use wb_bitmap, h_bitmap of bitmap for index!
-      int16_t idx = mirror_y ? x_part / 8 + j + dx / 8 + ((h_bitmap - 1 - (y_part + i + dy))) * wb_bitmap : x_part / 8 + j + dx / 8 + (y_part + i + dy) * wb_bitmap;
-      if (pgm)
-      {
-#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
-        data = pgm_read_byte(&bitmap[idx]);
-#else
-        data = bitmap[idx];
-#endif
-      }
-      else
-      {
-        data = bitmap[idx];
-      }
-      if (invert) data = ~data;
-      _writeData(data);
-    }
-  }
+  if (bitmap) _writeImageData(bitmap, w1 / 8, h1, wb_bitmap, h_bitmap, x_part / 8 + dx / 8, y_part + dy, invert, mirror_y, pgm);
+  else _writeDataFill(0xFF, uint32_t(w1 / 8) * h1);
   _writeCommand(0x92); // partial out
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
@@ -58,7 +58,9 @@
 GxEPD2_it60_1448x1072::GxEPD2_it60_1448x1072(int8_t cs, int8_t dc, int8_t rst, int8_t busy) :
   GxEPD2_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT, panel, hasColor, hasPartialUpdate, hasFastPartialUpdate),
   _spi_settings(24000000, MSBFIRST, SPI_MODE0),
-  _spi_settings_for_read(1000000, MSBFIRST, SPI_MODE0)
+  _spi_settings_for_read(1000000, MSBFIRST, SPI_MODE0),
+  _bitmap_load_bpp(4), _frame_slot(0), _load_slot(0xFF),
+  _partial_waveform(WAVEFORM_DU), _a2_mode(6), _grey_loaded(0xFF), _grey_displayed(true), _a2_cleanup(16), _a2_count(0)
 {
 }
 
@@ -95,8 +97,11 @@ void GxEPD2_it60_1448x1072::init(uint32_t serial_diag_bitrate, bool initial, uin
     printf("FW Version = %s\r\n", (uint8_t*)IT8951DevInfo.usFWVersion);
     printf("LUT Version = %s\r\n", (uint8_t*)IT8951DevInfo.usLUTVersion);
   }
+  // mode number of the A2 waveform depends on the waveform file
+  _a2_mode = strncmp((const char*)IT8951DevInfo.usLUTVersion, "M641", 4) == 0 ? 4 : 6;
   //Set to Enable I80 Packed mode
   _IT8951WriteReg(I80CPCR, 0x0001);
+  _load_slot = 0xFF; // LISAR not yet set
   if (VCOM != _IT8951GetVCOM())
   {
     _IT8951SetVCOM(VCOM);
@@ -111,14 +116,18 @@ void GxEPD2_it60_1448x1072::clearScreen(uint8_t value)
   if (_initial_refresh) _Init_Full();
   else _Init_Part();
   _initial_refresh = false;
-  _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  uint8_t slot = _frame_slot;
+  _frame_slot = 0; // the screen is refreshed from the image buffer
+  _setPartialRamArea(0, 0, WIDTH, HEIGHT, IT8951_4BPP, (value >> 4) % 15); // waveforms use the high nibble only
+  _frame_slot = slot;
   SPI.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   _transfer16(0x0000); // preamble for write data
   _waitWhileBusy2("clearScreen preamble", default_wait_time);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT); i++)
+  uint16_t data = (value >> 4) * 0x1111; // 4 pixels per word
+  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 4; i++)
   {
-    SPI.transfer(value);
+    _transfer16(data);
 #if defined(ESP8266) || defined(ESP32)
     if (0 == i % 10000) yield();
 #endif
@@ -127,7 +136,7 @@ void GxEPD2_it60_1448x1072::clearScreen(uint8_t value)
   SPI.endTransaction();
   _writeCommand16(IT8951_TCON_LD_IMG_END);
   _waitWhileBusy2("clearScreen load end", default_wait_time);
-  _refresh(0, 0, WIDTH, HEIGHT, false);
+  _refresh(0, 0, WIDTH, HEIGHT, WAVEFORM_GC16);
 }
 
 void GxEPD2_it60_1448x1072::writeScreenBuffer(uint8_t value)
@@ -140,14 +149,15 @@ void GxEPD2_it60_1448x1072::_writeScreenBuffer(uint8_t value)
 {
   _initial_write = false; // initial full screen buffer clean done
   if (!_using_partial_mode) _Init_Part();
-  _setPartialRamArea(0, 0, WIDTH, HEIGHT);
+  _setPartialRamArea(0, 0, WIDTH, HEIGHT, IT8951_4BPP, (value >> 4) % 15); // waveforms use the high nibble only
   SPI.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   _transfer16(0x0000); // preamble for write data
   _waitWhileBusy2("clearScreen preamble", default_wait_time);
-  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT); i++)
+  uint16_t data = (value >> 4) * 0x1111; // 4 pixels per word
+  for (uint32_t i = 0; i < uint32_t(WIDTH) * uint32_t(HEIGHT) / 4; i++)
   {
-    SPI.transfer(value);
+    _transfer16(data);
 #if defined(ESP8266) || defined(ESP32)
     if (0 == i % 10000) yield();
 #endif
@@ -175,7 +185,8 @@ void GxEPD2_it60_1448x1072::writeImage(const uint8_t bitmap[], int16_t x, int16_
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
   if (!_using_partial_mode) _Init_Part();
-  _setPartialRamArea(x1, y1, w1, h1);
+  // white loads as grey level 12 with 2bpp
+  _setPartialRamArea(x1, y1, w1, h1, _bitmap_load_bpp == 2 ? IT8951_2BPP : _bitmap_load_bpp == 4 ? IT8951_4BPP : IT8951_8BPP, _bitmap_load_bpp == 2);
   SPI.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   _transfer16(0x0000); // preamble for write data
@@ -200,7 +211,7 @@ void GxEPD2_it60_1448x1072::writeImage(const uint8_t bitmap[], int16_t x, int16_
         data = bitmap[idx];
       }
       if (invert) data = ~data;
-      _send8pixel(~data);
+      _sendBitmapByte(data);
     }
 #if defined(ESP8266) || defined(ESP32)
     yield();
@@ -237,7 +248,8 @@ void GxEPD2_it60_1448x1072::writeImagePart(const uint8_t bitmap[], int16_t x_par
   h1 -= dy;
   if ((w1 <= 0) || (h1 <= 0)) return;
   if (!_using_partial_mode) _Init_Part();
-  _setPartialRamArea(x1, y1, w1, h1);
+  // white loads as grey level 12 with 2bpp
+  _setPartialRamArea(x1, y1, w1, h1, _bitmap_load_bpp == 2 ? IT8951_2BPP : _bitmap_load_bpp == 4 ? IT8951_4BPP : IT8951_8BPP, _bitmap_load_bpp == 2);
   SPI.beginTransaction(_spi_settings);
   if (_cs >= 0) digitalWrite(_cs, LOW);
   _transfer16(0x0000); // preamble for write data
@@ -262,7 +274,7 @@ void GxEPD2_it60_1448x1072::writeImagePart(const uint8_t bitmap[], int16_t x_par
         data = bitmap[idx];
       }
       if (invert) data = ~data;
-      _send8pixel(~data);
+      _sendBitmapByte(data);
     }
   }
   if (_cs >= 0) digitalWrite(_cs, HIGH);
@@ -272,6 +284,70 @@ void GxEPD2_it60_1448x1072::writeImagePart(const uint8_t bitmap[], int16_t x_par
   delay(1); // yield() to avoid WDT on ESP8266 and ESP32
 }
 
+void GxEPD2_it60_1448x1072::writeImage16G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  writeImagePart16G(bitmap, 0, 0, w, h, x, y, w, h, invert, mirror_y, pgm);
+}
+
+void GxEPD2_it60_1448x1072::writeImagePart16G(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                                    int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
+{
+  if (_initial_write) writeScreenBuffer(); // initial full screen buffer clean
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+  if ((w_bitmap < 0) || (h_bitmap < 0) || (w < 0) || (h < 0)) return;
+  if ((x_part < 0) || (x_part >= w_bitmap)) return;
+  if ((y_part < 0) || (y_part >= h_bitmap)) return;
+  int16_t wb_bitmap = (w_bitmap + 1) / 2; // width bytes, 2 pixels per byte, bitmaps are padded
+  x_part -= x_part % 4; // word boundary
+  w = w_bitmap - x_part < w ? w_bitmap - x_part : w; // limit
+  h = h_bitmap - y_part < h ? h_bitmap - y_part : h; // limit
+  x -= x % 4; // word boundary
+  w = 4 * ((w + 3) / 4); // word boundary, padded with white
+  int16_t x1 = x < 0 ? 0 : x; // limit
+  int16_t y1 = y < 0 ? 0 : y; // limit
+  int16_t w1 = x + w < int16_t(WIDTH) ? w : int16_t(WIDTH) - x; // limit
+  int16_t h1 = y + h < int16_t(HEIGHT) ? h : int16_t(HEIGHT) - y; // limit
+  int16_t dx = x1 - x;
+  int16_t dy = y1 - y;
+  w1 -= dx;
+  h1 -= dy;
+  if ((w1 <= 0) || (h1 <= 0)) return;
+  if (!_using_partial_mode) _Init_Part();
+  _setPartialRamArea(x1, y1, w1, h1, IT8951_4BPP, true);
+  SPI.beginTransaction(_spi_settings);
+  if (_cs >= 0) digitalWrite(_cs, LOW);
+  _transfer16(0x0000); // preamble for write data
+  _waitWhileBusy2("writeImage16G preamble", default_wait_time);
+  for (int16_t i = 0; i < h1; i++)
+  {
+    // use wb_bitmap, h_bitmap of bitmap for index!
+    uint32_t row = mirror_y ? uint32_t(h_bitmap - 1 - (y_part + i + dy)) * uint32_t(wb_bitmap) : uint32_t(y_part + i + dy) * uint32_t(wb_bitmap);
+    for (int16_t j = (x_part + dx) / 2; j < (x_part + dx + w1) / 2; j += 2)
+    {
+      uint8_t data[2] = {0xFF, 0xFF}; // white beyond the bitmap width
+      for (uint8_t k = 0; k < 2; k++)
+      {
+        if (j + k >= wb_bitmap) break;
+#if defined(__AVR) || defined(ESP8266) || defined(ESP32)
+        data[k] = pgm ? pgm_read_byte(&bitmap[row + j + k]) : bitmap[row + j + k];
+#else
+        data[k] = bitmap[row + j + k];
+#endif
+        if (invert) data[k] = ~data[k];
+      }
+      _transfer16((uint16_t(data[0]) << 8) | data[1]); // 4 pixels, big endian
+    }
+#if defined(ESP8266) || defined(ESP32)
+    yield();
+#endif
+  }
+  if (_cs >= 0) digitalWrite(_cs, HIGH);
+  SPI.endTransaction();
+  _writeCommand16(IT8951_TCON_LD_IMG_END);
+  _waitWhileBusy2("writeImage16G load end", default_wait_time);
+  delay(1); // yield() to avoid WDT on ESP8266 and ESP32
+}
+
 void GxEPD2_it60_1448x1072::writeImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   if (black)
@@ -305,7 +381,7 @@ void GxEPD2_it60_1448x1072::writeNative(const uint8_t* data1, const uint8_t* dat
     h1 -= dy;
     if ((w1 <= 0) || (h1 <= 0)) return;
     if (!_using_partial_mode) _Init_Part();
-    _setPartialRamArea(x1, y1, w1, h1);
+    _setPartialRamArea(x1, y1, w1, h1, IT8951_8BPP, true);
     SPI.beginTransaction(_spi_settings);
     if (_cs >= 0) digitalWrite(_cs, LOW);
     _transfer16(0x0000); // preamble for write data
@@ -347,47 +423,97 @@ void GxEPD2_it60_1448x1072::writeNative(const uint8_t* data1, const uint8_t* dat
 void GxEPD2_it60_1448x1072::drawImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   writeImage(bitmap, x, y, w, h, invert, mirror_y, pgm);
-  _refresh(x, y, w, h, true);
+  _refresh(x, y, w, h, _partial_waveform);
 }
 
 void GxEPD2_it60_1448x1072::drawImagePart(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   writeImagePart(bitmap, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
-  _refresh(x, y, w, h, true);
+  _refresh(x, y, w, h, _partial_waveform);
 }
 
 void GxEPD2_it60_1448x1072::drawImage(const uint8_t* black, const uint8_t* color, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   writeImage(black, color, x, y, w, h, invert, mirror_y, pgm);
-  _refresh(x, y, w, h, true);
+  _refresh(x, y, w, h, _partial_waveform);
 }
 
 void GxEPD2_it60_1448x1072::drawImagePart(const uint8_t* black, const uint8_t* color, int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
                                 int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   writeImagePart(black, color, x_part, y_part, w_bitmap, h_bitmap, x, y, w, h, invert, mirror_y, pgm);
-  _refresh(x, y, w, h, true);
+  _refresh(x, y, w, h, _partial_waveform);
 }
 
 void GxEPD2_it60_1448x1072::drawNative(const uint8_t* data1, const uint8_t* data2, int16_t x, int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y, bool pgm)
 {
   writeNative(data1, data2, x, y, w, h, invert, mirror_y, pgm);
-  _refresh(x, y, w, h, false);
+  _refresh(x, y, w, h, WAVEFORM_GC16);
 }
 
 void GxEPD2_it60_1448x1072::refresh(bool partial_update_mode)
 {
-  _refresh(0, 0, WIDTH, HEIGHT, partial_update_mode);
+  _refresh(0, 0, WIDTH, HEIGHT, partial_update_mode ? _partial_waveform : WAVEFORM_GC16);
 }
 
 void GxEPD2_it60_1448x1072::refresh(int16_t x, int16_t y, int16_t w, int16_t h)
 {
-  _refresh(x, y, w, h, true);
+  _refresh(x, y, w, h, _partial_waveform);
+}
+
+void GxEPD2_it60_1448x1072::refresh(int16_t x, int16_t y, int16_t w, int16_t h, Waveform waveform)
+{
+  _refresh(x, y, w, h, waveform);
+}
+
+void GxEPD2_it60_1448x1072::refreshGrey(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+  _refresh(x, y, w, h, WAVEFORM_GC16);
+}
+
+void GxEPD2_it60_1448x1072::setPartialWaveform(Waveform waveform, uint16_t a2_cleanup)
+{
+  _partial_waveform = waveform;
+  _a2_cleanup = a2_cleanup;
 }
 
-void GxEPD2_it60_1448x1072::_refresh(int16_t x, int16_t y, int16_t w, int16_t h, bool partial_update_mode)
+void GxEPD2_it60_1448x1072::refreshFrameSlot(uint8_t slot, bool partial_update_mode)
 {
+  refreshFrameSlot(slot, 0, 0, WIDTH, HEIGHT, partial_update_mode);
+}
+
+void GxEPD2_it60_1448x1072::refreshFrameSlot(uint8_t slot, int16_t x, int16_t y, int16_t w, int16_t h, bool partial_update_mode)
+{
+  if (slot >= frame_slots) return;
+  _refresh(x, y, w, h, partial_update_mode ? _partial_waveform : WAVEFORM_GC16, slot);
+}
+
+void GxEPD2_it60_1448x1072::_refresh(int16_t x, int16_t y, int16_t w, int16_t h, Waveform waveform, uint8_t slot)
+{
+  bool grey = _grey_loaded & (1 << slot);
+  if (WAVEFORM_AUTO == waveform)
+  {
+    // A2 can't drive grey pixels, neither those loaded nor those still shown from a previous grey refresh
+    if (grey || _grey_displayed) waveform = WAVEFORM_GC16;
+    else if (_a2_cleanup && (_a2_count >= _a2_cleanup))
+    {
+      // clean up the ghosting of the A2 refreshes
+      waveform = WAVEFORM_GC16;
+      x = 0;
+      y = 0;
+      w = WIDTH;
+      h = HEIGHT;
+    }
+    else waveform = WAVEFORM_A2;
+  }
+  bool full_screen = (x <= 0) && (y <= 0) && (x + w >= int16_t(WIDTH)) && (y + h >= int16_t(HEIGHT));
+  if (WAVEFORM_A2 == waveform) _a2_count++;
+  else if ((WAVEFORM_GC16 == waveform) && full_screen) _a2_count = 0;
+  // grey stays on screen until a full screen GC16 (or INIT) refresh of content without grey
+  if (grey) _grey_displayed = true;
+  else if (((WAVEFORM_GC16 == waveform) || (WAVEFORM_INIT == waveform)) && full_screen) _grey_displayed = false;
+  if (0 == slot) _grey_loaded &= ~1; // the image buffer is reloaded for the next refresh
   //x -= x % 8; // byte boundary
   //w -= x % 8; // byte boundary
   int16_t x1 = x < 0 ? 0 : x; // limit
@@ -397,7 +523,7 @@ void GxEPD2_it60_1448x1072::_refresh(int16_t x, int16_t y, int16_t w, int16_t h,
   w1 -= x1 - x;
   h1 -= y1 - y;
   //Send I80 Display Command (User defined command of IT8951)
-  _writeCommand16(USDEF_I80_CMD_DPY_AREA); //0x0034
+  _writeCommand16(slot ? USDEF_I80_CMD_DPY_BUF_AREA : USDEF_I80_CMD_DPY_AREA); //0x0037 : 0x0034
   _waitWhileBusy2("refresh cmd", refresh_cmd_time);
   //Write arguments
   _writeData16(x1);
@@ -408,8 +534,18 @@ void GxEPD2_it60_1448x1072::_refresh(int16_t x, int16_t y, int16_t w, int16_t h,
   _waitWhileBusy2("refresh w", refresh_par_time);
   _writeData16(h1);
   _waitWhileBusy2("refresh h", refresh_par_time);
-  _writeData16(partial_update_mode ? 1 : 2); // mode
-  _waitWhileBusy("refresh", full_refresh_time);
+  _writeData16(WAVEFORM_A2 == waveform ? _a2_mode : uint8_t(waveform)); // mode
+  if (slot)
+  {
+    _waitWhileBusy2("refresh mode", refresh_par_time);
+    uint32_t address = _frameSlotAddress(slot);
+    _writeData16(address & 0xFFFF);
+    _waitWhileBusy2("refresh address low", refresh_par_time);
+    _writeData16(address >> 16);
+  }
+  // named by the kind of refresh, for the timing profile
+  if ((WAVEFORM_DU == waveform) || (WAVEFORM_A2 == waveform)) _waitWhileBusy("_Update_Part", partial_refresh_time);
+  else _waitWhileBusy(full_screen ? "_Update_Full" : "_Update_Full_Window", full_refresh_time);
 }
 
 void GxEPD2_it60_1448x1072::powerOff(void)
@@ -430,6 +566,23 @@ void GxEPD2_it60_1448x1072::hibernate()
   }
 }
 
+void GxEPD2_it60_1448x1072::setBitmapLoadDepth(uint8_t bpp)
+{
+  _bitmap_load_bpp = (bpp == 2) || (bpp == 8) ? bpp : 4;
+}
+
+void GxEPD2_it60_1448x1072::selectFrameSlot(uint8_t slot)
+{
+  if (slot < frame_slots) _frame_slot = slot;
+}
+
+uint32_t GxEPD2_it60_1448x1072::_frameSlotAddress(uint8_t slot)
+{
+  // the image buffer holds 8 bits per pixel, independent of the load format
+  uint32_t address = uint32_t(IT8951DevInfo.usImgBufAddrL) | (uint32_t(IT8951DevInfo.usImgBufAddrH) << 16);
+  return address + uint32_t(slot) * uint32_t(WIDTH) * uint32_t(HEIGHT);
+}
+
 void GxEPD2_it60_1448x1072::_send8pixel(uint8_t data)
 {
   for (uint8_t j = 0; j < 8; j++)
@@ -439,13 +592,44 @@ void GxEPD2_it60_1448x1072::_send8pixel(uint8_t data)
   }
 }
 
-void GxEPD2_it60_1448x1072::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+// 8 pixels of a bitmap, 1 is white, in the load format of _bitmap_load_bpp; first pixel in the most significant bits (big endian)
+void GxEPD2_it60_1448x1072::_sendBitmapByte(uint8_t data)
+{
+  if (4 == _bitmap_load_bpp)
+  {
+    // spread each nibble to bits 12, 8, 4, 0, then widen each bit to a nibble
+    uint16_t hi = ((data & 0x80) << 5) | ((data & 0x40) << 2) | ((data & 0x20) >> 1) | ((data & 0x10) >> 4);
+    uint16_t lo = ((data & 0x08) << 9) | ((data & 0x04) << 6) | ((data & 0x02) << 3) | (data & 0x01);
+    _transfer16(hi * 0x0F);
+    _transfer16(lo * 0x0F);
+  }
+  else if (2 == _bitmap_load_bpp)
+  {
+    // spread the bits to every second bit, then widen each bit to a pair
+    uint16_t d = data;
+    d = (d | (d << 4)) & 0x0F0F;
+    d = (d | (d << 2)) & 0x3333;
+    d = (d | (d << 1)) & 0x5555;
+    _transfer16(d * 0x03);
+  }
+  else _send8pixel(~data);
+}
+
+void GxEPD2_it60_1448x1072::_setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t pixel_format, bool grey)
 {
-  //_IT8951WriteReg(LISAR + 2 , IT8951DevInfo.usImgBufAddrH);
-  //_IT8951WriteReg(LISAR , IT8951DevInfo.usImgBufAddrL);
+  if ((0 == x) && (0 == y) && (WIDTH == w) && (HEIGHT == h)) _grey_loaded &= ~(1 << _frame_slot); // whole frame replaced
+  if (grey) _grey_loaded |= 1 << _frame_slot;
+  if (_frame_slot != _load_slot)
+  {
+    // load image start address, kept by the controller between loads
+    uint32_t address = _frameSlotAddress(_frame_slot);
+    _IT8951WriteReg(LISAR + 2, address >> 16);
+    _IT8951WriteReg(LISAR, address & 0xFFFF);
+    _load_slot = _frame_slot;
+  }
   uint16_t usArg[5];
   //usArg[0] = (IT8951_LDIMG_L_ENDIAN << 8 ) | (IT8951_8BPP << 4) | (IT8951_ROTATE_0);
-  usArg[0] = (IT8951_LDIMG_B_ENDIAN << 8 ) | (IT8951_8BPP << 4) | (IT8951_ROTATE_0);
+  usArg[0] = (IT8951_LDIMG_B_ENDIAN << 8 ) | (pixel_format << 4) | (IT8951_ROTATE_0);
   usArg[1] = x;
   usArg[2] = y;
   usArg[3] = w;
@@ -69,6 +69,38 @@ class GxEPD2_it60_1448x1072 : public GxEPD2_EPD
     void refresh(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory, partial screen
     void powerOff(); // turns off generation of panel driving voltages, avoids screen fading over time
     void hibernate(); // turns powerOff() and sets controller to deep sleep for minimum power use, ONLY if wakeable by RST (rst >= 0)
+    // 16 grey levels: bitmap 4 bits per pixel, first pixel in the high nibble, 0 black .. 15 white, see GxEPD2_16G
+    // write to controller memory, without screen refresh; x and w should be multiple of 4
+    void writeImage16G(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    void writeImagePart16G(const uint8_t bitmap[], int16_t x_part, int16_t y_part, int16_t w_bitmap, int16_t h_bitmap,
+                           int16_t x, int16_t y, int16_t w, int16_t h, bool invert = false, bool mirror_y = false, bool pgm = false);
+    void refreshGrey(int16_t x, int16_t y, int16_t w, int16_t h); // screen refresh from controller memory with the 16 grey levels waveform (GC16)
+    // waveform modes of the display command; A2 and DU are fast, for black and white only, A2 with more ghosting
+    // A2 needs pure black or white data, the mode number of A2 is taken from the LUT version
+    enum Waveform {WAVEFORM_INIT = 0, WAVEFORM_DU = 1, WAVEFORM_GC16 = 2, WAVEFORM_GL16 = 3, WAVEFORM_A2 = 0x80, WAVEFORM_AUTO = 0x81};
+    // screen refresh from controller memory with the waveform, partial screen
+    void refresh(int16_t x, int16_t y, int16_t w, int16_t h, Waveform waveform);
+    // waveform of partial refresh, refresh(true), refresh(x, y, w, h), drawImage; default WAVEFORM_DU
+    // WAVEFORM_AUTO: A2, or GC16 if grey was loaded since the last refresh (for frame slots: since the last full frame load),
+    // or if grey is still shown, until a full screen GC16 refresh of content without grey,
+    // and a full screen GC16 cleanup refresh instead of the next A2 refresh after a2_cleanup A2 refreshes, 0: no cleanup
+    void setPartialWaveform(Waveform waveform, uint16_t a2_cleanup = 16);
+    // bits per pixel of bitmap loads (writeImage, writeImagePart): 4 (default), 2 or 8
+    // 4: 2x less SPI traffic than 8, white is grey level 15 for all waveforms
+    // 2: 4x less, but white loads as grey level 12 (0xC0), only for fast partial refresh (DU) use
+    void setBitmapLoadDepth(uint8_t bpp);
+    // frame slots in the controller SDRAM: slot 0 is the image buffer, used by refresh(), slots 1 .. frame_slots - 1 are off-screen
+    // frames can be loaded ahead, and shown later without any data transfer, e.g. for pages of a document or an animation
+    static const uint8_t frame_slots = 4; // off-screen frames, 1448 x 1072 bytes each, behind the image buffer in the controller SDRAM
+    // selects the target of following loads (writeScreenBuffer, writeImage.., writeNative), 0 (default): image buffer
+    void selectFrameSlot(uint8_t slot);
+    uint8_t frameSlot()
+    {
+      return _frame_slot;
+    };
+    // screen refresh from a frame slot, full screen or partial screen; the frame slot content is not copied to the image buffer
+    void refreshFrameSlot(uint8_t slot, bool partial_update_mode = false);
+    void refreshFrameSlot(uint8_t slot, int16_t x, int16_t y, int16_t w, int16_t h, bool partial_update_mode = true);
   private:
     struct IT8951DevInfoStruct
     {
@@ -82,11 +114,20 @@ class GxEPD2_it60_1448x1072 : public GxEPD2_EPD
     IT8951DevInfoStruct IT8951DevInfo;
     SPISettings _spi_settings;
     SPISettings _spi_settings_for_read;
+    uint8_t _bitmap_load_bpp;
+    uint8_t _frame_slot, _load_slot; // _load_slot: target of LISAR, 0xFF after reset (unknown)
+    Waveform _partial_waveform;
+    uint8_t _a2_mode;
+    uint8_t _grey_loaded; // bit per frame slot, set by loads with grey
+    bool _grey_displayed; // grey is shown on screen, A2 would leave it behind
+    uint16_t _a2_cleanup, _a2_count;
   private:
     void _writeScreenBuffer(uint8_t value);
-    void _refresh(int16_t x, int16_t y, int16_t w, int16_t h, bool partial_update_mode);
+    void _refresh(int16_t x, int16_t y, int16_t w, int16_t h, Waveform waveform, uint8_t slot = 0);
+    uint32_t _frameSlotAddress(uint8_t slot);
     void _send8pixel(uint8_t data);
-    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void _sendBitmapByte(uint8_t data);
+    void _setPartialRamArea(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t pixel_format, bool grey);
     void _PowerOn();
     void _PowerOff();
     void _InitDisplay();